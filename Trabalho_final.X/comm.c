@@ -5,6 +5,10 @@
 
 #include "comm.h"
 #include "globals.h"    
+#include "motor.h"
+#include "perfil.h"
+#include "gravacao.h"
+#include "sono.h"
 #include "mcc_generated_files/mcc.h"
 
 /**
@@ -13,6 +17,86 @@
  */
 #define CR      13 
 
+/**
+ * @brief Cdigos de rejeio enviados no NAK "#N,SS,c".
+ * - F: Formato desconhecido (comando inexistente ou lote de tamanho mpar).
+ * - A: Andar fora da faixa 0-3 em algum par do lote.
+ * - O: Ocupado (calibrao pedida fora do repouso).
+ */
+#define NAK_FORMATO   'F'
+#define NAK_ANDAR     'A'
+#define NAK_OCUPADO   'O'
+
+/**
+ * @brief Janela de supresso de duplicatas (ciclos de 10 ms).
+ * @note 2 s, maior que o tempo total de retransmisso do host.
+ */
+#define JANELA_SEQUENCIA 200
+
+/**
+ * @brief Perodos da telemetria adaptativa (ciclos de 10 ms).
+ * - MOVIMENTO: Motor ligado, posio mudando (100 ms).
+ * - REPOUSO:   Motor desligado, apenas sinal de vida (1 s).
+ */
+#define TELEMETRIA_MOVIMENTO 10
+#define TELEMETRIA_REPOUSO   100
+
+/**
+ * @brief Banda da UART por ciclo: 19200 bps / 10 bits = 1920 bytes/s = 19 bytes a cada 10 ms.
+ * @note O crdito acumulado  limitado a #CREDITO_MAX para no gerar rajadas.
+ */
+#define BYTES_POR_CICLO      19
+#define CREDITO_MAX          40
+/**
+ * @brief Piso do crdito: o quadro completo ignora a banda e, com eventos em
+ * todo ciclo, o dbito acumulado estouraria o int8_t.
+ */
+#define CREDITO_MIN          (-CREDITO_MAX)
+
+
+// VARIVEIS INTERNAS
+
+/**
+ * @brief Resumo do estado (andar, destino, motor e mquina) no ltimo quadro enviado.
+ * Iniciado com valor impossvel para forar o primeiro envio.
+ */
+static uint16_t assinatura_telemetria = 0xFFFF;
+
+/**
+ * @brief Perodo de cada canal em ciclos de 10 ms (0 = desligado).
+ * @note No canal geral qualquer valor diferente de 0 liga o envio adaptativo.
+ * Por padro apenas o quadro completo  enviado, como no protocolo original.
+ */
+static uint8_t periodo_canal[NUM_CANAIS] = {1, 0, 0, 0, 0};
+
+/**
+ * @brief Ciclos desde o ltimo envio de cada canal (saturado em 255).
+ */
+static uint8_t atraso_canal[NUM_CANAIS] = {0, 0, 0, 0, 0};
+
+#if SONO_HABILITADO
+/**
+ * @brief Ciclos desde o ltimo byte recebido (saturado em 255).
+ * @note O PIC s dorme aps #VIGILIA_RX ciclos sem bytes (ver UART_Ociosa()).
+ */
+static uint8_t ciclos_sem_rx = 0;
+#endif
+
+/**
+ * @brief Bytes que ainda cabem na banda da UART (negativo = linha em dbito).
+ */
+static int8_t credito_tx = CREDITO_MAX;
+
+/**
+ * @brief Contador de quadros de telemetria enviados (todos os canais).
+ */
+static uint8_t sequencia_telemetria = 0;
+
+/**
+ * @brief Prxima entrada de #sequencias_aceitas a ser sobrescrita.
+ */
+static uint8_t proxima_aceita = 0;
+
 
 // TABELAS DE DADOS (LUTs)
 
@@ -53,14 +137,18 @@ const uint8_t LUT_Andar[]= {
 
 /**
  * @brief Tabela de padres de bits para indicar o status do elevador.
- * @note Cada estado consome 4 bytes da memria.
+ * @note Cada estado consome 4 bytes da memria, na ordem de #EstadoElevador.
+ * MatrizLed() indexa a tabela por #estado_atual: um estado novo precisa de
+ * uma linha aqui e de ajuste no tamanho do vetor.
  * Estados representados na matriz:
  * - Parado:       Nenhum LED aceso
  * - Subindo:      Seta apontando para cima
  * - Descendo:     Seta apontando para baixo
  * - Esperar/Rev:  Seta horizontal
+ * - Busca:        Quatro pontos nos cantos
+ * - Calibrao:   Duas barras horizontais
  */
-const uint8_t LUT_dir[] = {
+const uint8_t LUT_dir[(ESTADO_CALIBRACAO + 1) * 4] = {
     // 0: Parado
     0b00000000, 
     0b00000000, 
@@ -89,7 +177,19 @@ const uint8_t LUT_dir[] = {
     0b00000000, 
     0b00000010,
     0b00000010,
-    0b00000010
+    0b00000010,
+    
+    // 5: Busca de referncia
+    0b00000000, 
+    0b00000101,
+    0b00000000,
+    0b00000101,
+    
+    // 6: Calibrao
+    0b00000000, 
+    0b00000111,
+    0b00000000,
+    0b00000111
 };
 
 /**
@@ -103,6 +203,27 @@ const uint8_t LUT_percurso[] = {
     0b10000000  // Andar 4
 };
 
+/**
+ * @brief Letra de cada canal de telemetria no comando "$Scnnn" e nos quadros.
+ * @note ndices: #CANAL_GERAL, #CANAL_POSICAO, #CANAL_VELOCIDADE, #CANAL_TEMPERATURA, #CANAL_FILA.
+ */
+const char LUT_canal[] = {'G', 'P', 'V', 'T', 'F'};
+
+/**
+ * @brief Tamanho em bytes do quadro de cada canal, usado no controle de banda.
+ * - G: "$A,D,M,PPP,VV.V,TT.T,NN,MMMM\r" (29)
+ * - P: "$P,PPP,NN,MMMM\r" (15)
+ * - V: "$V,VV.V,NN,MMMM\r" (16)
+ * - T: "$T,TT.T,NN,MMMM\r" (16)
+ * - F: "$F,SSSS,DDDD,NN,MMMM\r" (21)
+ */
+const uint8_t LUT_tamanho_canal[] = {29, 15, 16, 16, 21};
+
+/**
+ * @brief Potncias de 10 para a converso de nmeros em ASCII sem diviso.
+ */
+const uint16_t LUT_potencia[] = {1, 10, 100, 1000, 10000};
+
 /**
  * @brief Tabela de inicializao e configurao do driver MAX7219.
  * * @note Estrutura do vetor: Pares de bytes ordenados [Endereo do Registrador, Dado].
@@ -130,38 +251,518 @@ const uint8_t matrix_conf[] = {
 
 
 /**
- * @brief Tenta receber e decodificar um pacote de pedido via UART.
- * @note Protocolo esperado: "$OD\r" 
- * - Onde: '$' = Incio, O = Origem, D = Destino, \r = CR/13
- * * @param origem_pedido  Ponteiro para armazenar o andar de origem do elevador.
- * @param destino_pedido Ponteiro para armazenar o andar de destino.
- * * @return 0 - Pacote recebido e validado com o terminador correto.
- * @return 1 - Cabealho no encontrado ou pacote incompleto/corrompido.
+ * @brief Envia um nmero decimal com quantidade fixa de dgitos.
+ * @note Usa subtraes sucessivas de #LUT_potencia no lugar da diviso.
+ * @param valor Nmero a ser enviado.
+ * @param digitos Quantidade de dgitos (1 a 5), com zeros  esquerda.
+ */
+static void UART_EnviaNumero(uint16_t valor, uint8_t digitos){
+    while(digitos--){
+        uint16_t potencia = LUT_potencia[digitos];
+        char digito = '0';
+        while(valor >= potencia){
+            valor -= potencia;
+            digito++;
+        }
+        EUSART_Write(digito);
+    }
+}
+
+/**
+ * @brief Envia um valor em dcimos no formato "XX.X".
+ * @param valor Valor multiplicado por 10 (ex: 125 para 12.5).
+ */
+static void UART_EnviaDecimal(uint16_t valor){
+    UART_EnviaNumero(valor / 10, 2);
+    EUSART_Write('.');
+    EUSART_Write('0' + (valor % 10));
+}
+
+/**
+ * @brief Envia o sinal ('+' ou '-') de um valor e devolve o mdulo.
  */
-int UART_RecebePedido(char* origem_pedido, char* destino_pedido){
+static uint16_t UART_EnviaSinal(int16_t valor){
+    EUSART_Write(valor < 0 ? '-' : '+');
+    return (valor < 0) ? (uint16_t)-valor : (uint16_t)valor;
+}
+
+/**
+ * @brief Envia as estatsticas do estimador no formato "NNNNN,sRR.R,MM.M,sTTT".
+ * @details Resduos convertidos de 1/16 de pulso para dcimos de pulso
+ * (saturados em 99.9) e taxa de deriva de 1/4096 para pulsos por mil.
+ */
+static void UART_EnviaDeriva(void){
+    EstatisticaDeriva d;
+    int16_t taxa;
+    SENSORES_Deriva(&d, &taxa);
+    
+    UART_EnviaNumero(d.ancoragens, 5);
+    EUSART_Write(',');
+    uint16_t ultimo = UART_EnviaSinal(d.ultimo);
+    UART_EnviaDecimal(ultimo > 159 ? 999 : (ultimo * 10 + 8) / 16);
+    EUSART_Write(',');
+    UART_EnviaDecimal(d.maior > 159 ? 999 : (d.maior * 10 + 8) / 16);
+    EUSART_Write(',');
+    uint16_t modulo = UART_EnviaSinal(taxa);
+    UART_EnviaNumero((uint16_t)(((uint32_t)modulo * 1000 + 2048) / 4096), 3);
+}
+
+/**
+ * @brief Envia as filas de chamadas no formato "SSSS,DDDD" (andar 0 ao 3, 1 = pendente).
+ */
+static void UART_EnviaFila(void){
+    for(uint8_t i=0; i<4; i++) EUSART_Write(chamadas_subida[i] ? '1' : '0');
+    EUSART_Write(',');
+    for(uint8_t i=0; i<4; i++) EUSART_Write(chamadas_descida[i] ? '1' : '0');
+}
+
+/**
+ * @brief Envia um byte como dois dgitos hexadecimais maisculos.
+ * @param valor Byte a ser enviado.
+ */
+static void UART_EnviaHex(uint8_t valor){
+    uint8_t nibble = valor >> 4;
+    EUSART_Write(nibble < 10 ? '0' + nibble : 'A' - 10 + nibble);
+    nibble = valor & 0x0F;
+    EUSART_Write(nibble < 10 ? '0' + nibble : 'A' - 10 + nibble);
+}
+
+#if PERFIL_HABILITADO
+/**
+ * @brief Responde "$?P" com uma linha por fase do perfilador.
+ * @details Formato: "#P,f,mmmmm,MMMMM,AAAAA,NNNNN" (letra da fase, mnimo,
+ * mximo e mdia em ciclos de instruo, nmero de amostras). Cada consulta
+ * zera os acumuladores, ento a resposta cobre o intervalo desde a anterior.
+ */
+static void UART_EnviaPerfil(void){
+    PerfilRegistro r;
+    
+    for(uint8_t i=0; i<NUM_PERFIS; i++){
+        bool medido = PERFIL_Consulta(i, &r);
+        
+        EUSART_Write('#');
+        EUSART_Write('P');
+        EUSART_Write(',');
+        EUSART_Write(LUT_perfil[i]);
+        EUSART_Write(',');
+        UART_EnviaNumero(medido ? r.minimo : 0, 5);
+        EUSART_Write(',');
+        UART_EnviaNumero(r.maximo, 5);
+        EUSART_Write(',');
+        UART_EnviaNumero(medido ? (uint16_t)(r.soma / r.amostras) : 0, 5);
+        EUSART_Write(',');
+        UART_EnviaNumero(r.amostras, 5);
+        EUSART_Write(CR);
+    }
+    
+    // A resposta  longa (~200 ms de UART): reinicia a fase de recepo para
+    // que o prprio despejo no aparea como mximo na prxima consulta
+    PERFIL_INICIO(PERFIL_RECEPCAO);
+}
+#endif
+
+#if PERFIL_INTERRUPCOES
+/**
+ * @brief Responde "$?I" com uma linha por fonte de interrupo e os estouros da RX.
+ * @details Formato: "#I,n,NNNNN,SSSSSSSSSSSSSSSS,LLLLLLLLLLLLLLLL" (fonte 0-5 na
+ * ordem do despachante, atendimentos e os histogramas de servio e latncia,
+ * 8 faixas de 2 dgitos hexadecimais cada), seguido de "#O,NNNNN" (estouros OERR).
+ * Cada consulta zera os contadores.
+ */
+static void UART_EnviaInterrupcoes(void){
+    PerfilIrq r;
     
-    // 1. Verifica o Cabealho 
-    if(EUSART_Read() == '$'){
+    for(uint8_t i=0; i<NUM_IRQ; i++){
+        PERFIL_ConsultaIrq(i, &r);
         
-        // 2. Extrao de Dados
-        // Como so passados variveis por referncia,  utilizado o operador '*'
-        // para escrever o valor lido diretamente na varivel original da main
-        *origem_pedido = EUSART_Read();
-        *destino_pedido = EUSART_Read();
+        EUSART_Write('#');
+        EUSART_Write('I');
+        EUSART_Write(',');
+        EUSART_Write('0' + i);
+        EUSART_Write(',');
+        UART_EnviaNumero(r.contagem, 5);
+        EUSART_Write(',');
+        for(uint8_t k=0; k<IRQ_FAIXAS; k++) UART_EnviaHex(r.servico[k]);
+        EUSART_Write(',');
+        for(uint8_t k=0; k<IRQ_FAIXAS; k++) UART_EnviaHex(r.latencia[k]);
+        EUSART_Write(CR);
+    }
+    
+    EUSART_Write('#');
+    EUSART_Write('O');
+    EUSART_Write(',');
+    UART_EnviaNumero(PERFIL_EstourosRx(), 5);
+    EUSART_Write(CR);
+}
+#endif
+
+#if SONO_HABILITADO
+/**
+ * @brief Responde "$?Z" com os contadores de sono desde o reset.
+ * @details Formato: "#Z,LLLLL,PPPPP,RRRRR" (sonos leves, profundos e
+ * despertares pela RX). Cada sono leve dura ~8 ms: comparando as contagens
+ * entre duas consultas com o tempo decorrido, o host obtm a frao do tempo
+ * dormindo.
+ */
+static void UART_EnviaSono(void){
+    const SonoEstatisticas* e = SONO_Estatisticas();
+    
+    EUSART_Write('#');
+    EUSART_Write('Z');
+    EUSART_Write(',');
+    UART_EnviaNumero(e->leves, 5);
+    EUSART_Write(',');
+    UART_EnviaNumero(e->profundos, 5);
+    EUSART_Write(',');
+    UART_EnviaNumero(e->despertares, 5);
+    EUSART_Write(CR);
+}
+#endif
+
+/**
+ * @brief Responde a uma consulta "$?X".
+ * @note Respostas, iniciadas por '#' para no serem confundidas com a telemetria:
+ * - 'S': "#S,E,A,D,M,PPP,O" - Estado da mquina, andar, destino, motor, posio e origem da posio.
+ * - 'F': "#F,SSSS,DDDD"   - Chamadas de subida e descida do andar 0 ao 3 (1 = pendente).
+ * - 'E': "#E,VVVVV,IIIII,PPPPP,DDDDD" - Quadros vlidos, invlidos, pedidos recebidos e duplicatas.
+ * - 'C': "#C,S,PPP,PPP,PPP,PPP,UUUU,HHH" - Mapa do poo (ver UART_EnviaCalibracao()).
+ * - 'D': "#D,NNNNN,sRR.R,MM.M,sTTT" - Ancoragens, ltimo e maior resduo (pulsos) e deriva (por mil).
+ * - 'P': "#P,f,mmmmm,MMMMM,AAAAA,NNNNN" por fase, s com PERFIL_HABILITADO.
+ * - 'I': "#I,n,NNNNN,S...,L..." por fonte e "#O,NNNNN", s com PERFIL_INTERRUPCOES.
+ * - 'Z': "#Z,LLLLL,PPPPP,RRRRR" - Sonos leves, profundos e despertares pela RX, s com SONO_HABILITADO.
+ * @param tipo Letra da consulta.
+ * @return true - Consulta respondida.
+ * @return false - Consulta desconhecida.
+ */
+static bool UART_RespondeConsulta(char tipo){
+    
+    if(tipo == 'C'){
+        UART_EnviaCalibracao();
+        return true;
+    }
+#if PERFIL_HABILITADO
+    if(tipo == 'P'){
+        UART_EnviaPerfil();
+        return true;
+    }
+#endif
+#if PERFIL_INTERRUPCOES
+    if(tipo == 'I'){
+        UART_EnviaInterrupcoes();
+        return true;
+    }
+#endif
+#if SONO_HABILITADO
+    if(tipo == 'Z'){
+        UART_EnviaSono();
+        return true;
+    }
+#endif
+    if(tipo != 'S' && tipo != 'F' && tipo != 'E' && tipo != 'D') return false;
+    
+    // Cabealho da resposta
+    EUSART_Write('#');
+    EUSART_Write(tipo);
+    EUSART_Write(',');
+    
+    if(tipo == 'S'){
+        UART_EnviaNumero(estado_atual, 1);
+        EUSART_Write(',');
+        UART_EnviaNumero(andar_atual, 1);
+        EUSART_Write(',');
+        UART_EnviaNumero(andar_destino, 1);
+        EUSART_Write(',');
+        UART_EnviaNumero(estado_motor, 1);
+        EUSART_Write(',');
+        UART_EnviaNumero(posicao_mm, 3);
+        EUSART_Write(',');
+        UART_EnviaNumero(origem_posicao, 1);
+    }
+    else if(tipo == 'F'){
+        UART_EnviaFila();
+    }
+    else if(tipo == 'D'){
+        UART_EnviaDeriva();
+    }
+    else {
+        UART_EnviaNumero(quadros_validos, 5);
+        EUSART_Write(',');
+        UART_EnviaNumero(quadros_invalidos, 5);
+        EUSART_Write(',');
+        UART_EnviaNumero(pedidos_recebidos, 5);
+        EUSART_Write(',');
+        UART_EnviaNumero(quadros_duplicados, 5);
+    }
+    
+    EUSART_Write(CR);
+    return true;
+}
+
+/**
+ * @brief Converte um dgito hexadecimal ASCII ('0'-'9', 'A'-'F').
+ * @return Valor de 0 a 15, ou 0xFF se o caractere no for hexadecimal.
+ */
+static uint8_t UART_ValorHex(char c){
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return 0xFF;
+}
+
+/**
+ * @brief Confirma ou rejeita um quadro sequenciado.
+ * @note ACK: "#K,SS". NAK: "#N,SS,c", com c = #NAK_FORMATO ou #NAK_ANDAR.
+ * @param sequencia Nmero de sequncia recebido no quadro.
+ * @param erro 0 para ACK, ou o cdigo de rejeio.
+ */
+static void UART_EnviaConfirmacao(uint8_t sequencia, char erro){
+    EUSART_Write('#');
+    EUSART_Write(erro ? 'N' : 'K');
+    EUSART_Write(',');
+    UART_EnviaHex(sequencia);
+    if(erro){
+        EUSART_Write(',');
+        EUSART_Write(erro);
+    }
+    EUSART_Write(CR);
+}
+
+/**
+ * @brief Verifica se o quadro  um lote de pares origem/destino vlidos.
+ * @param tamanho Quantidade de caracteres no quadro.
+ * @return 0 - Tamanho par e todos os andares entre '0' e '3'.
+ * @return #NAK_FORMATO - Tamanho mpar ou caractere que no  dgito.
+ * @return #NAK_ANDAR - Dgito fora da faixa de andares.
+ */
+static char UART_ValidaLote(uint8_t tamanho){
+    if(tamanho == 0 || (tamanho & 1)) return NAK_FORMATO;
+    for(uint8_t i=0; i<tamanho; i++){
+        if(buffer_quadro[i] < '0' || buffer_quadro[i] > '9') return NAK_FORMATO;
+        if(buffer_quadro[i] > '3') return NAK_ANDAR;
+    }
+    return 0;
+}
+
+/**
+ * @brief Assina um canal de telemetria: "$Scnnn".
+ * @details c = letra do canal (#LUT_canal), nnn = perodo em ciclos de 10 ms
+ * (000 = desliga, mximo 255). Ex: "$SP005" envia a posio a cada 50 ms.
+ * @param tamanho Quantidade de caracteres no quadro.
+ * @return 0 - Assinatura registrada.
+ * @return #NAK_FORMATO - Canal desconhecido ou perodo invlido.
+ */
+static char UART_AssinaCanal(uint8_t tamanho){
+    if(tamanho != 5) return NAK_FORMATO;
+    
+    // 1. Canal
+    uint8_t canal = 0;
+    while(canal < NUM_CANAIS && LUT_canal[canal] != buffer_quadro[1]) canal++;
+    if(canal >= NUM_CANAIS) return NAK_FORMATO;
+    
+    // 2. Perodo em decimal, 3 dgitos
+    uint16_t periodo = 0;
+    for(uint8_t i=2; i<5; i++){
+        if(buffer_quadro[i] < '0' || buffer_quadro[i] > '9') return NAK_FORMATO;
+        periodo = periodo * 10 + (buffer_quadro[i] - '0');
+    }
+    if(periodo > 255) return NAK_FORMATO;
+    
+    periodo_canal[canal] = (uint8_t)periodo;
+    atraso_canal[canal] = 0;
+    return 0;
+}
+
+/**
+ * @brief Interpreta e executa um quadro completo de #buffer_quadro.
+ * @details O lote s  registrado se todos os pares forem vlidos,
+ * mantendo o comportamento do quadro "$OD" simples.
+ * @param tamanho Quantidade de caracteres entre '$' e CR, sem a sequncia.
+ * @return 0 - Quadro executado.
+ * @return Cdigo de rejeio (#NAK_FORMATO ou #NAK_ANDAR).
+ */
+static char UART_ExecutaQuadro(uint8_t tamanho){
+    char erro = 0;
+    
+    // 1. Comando de porta "$PF"
+    if(tamanho == 2 && buffer_quadro[0] == 'P' && buffer_quadro[1] == 'F'){
+        Fechar_Porta();
+    }
+    // 1b. Calibrao do poo "$CA"
+    else if(tamanho == 2 && buffer_quadro[0] == 'C' && buffer_quadro[1] == 'A'){
+        if(!Controle_IniciarCalibracao()) erro = NAK_OCUPADO;
+    }
+    // 2. Consultas "$?X"
+    else if(tamanho == 2 && buffer_quadro[0] == '?'){
+        if(!UART_RespondeConsulta(buffer_quadro[1])) erro = NAK_FORMATO;
+    }
+    // 3. Assinatura de canal "$Scnnn"
+    else if(buffer_quadro[0] == 'S'){
+        erro = UART_AssinaCanal(tamanho);
+    }
+    // 4. Pedidos "$OD" ou lote "$O1D1O2D2..."
+    else {
+        erro = UART_ValidaLote(tamanho);
+        if(!erro){
+            for(uint8_t i=0; i<tamanho; i+=2){
+                // Converte caracteres ASCII para inteiros
+                Registrar_Pedido(buffer_quadro[i] - '0', buffer_quadro[i+1] - '0');
+            }
+            PERFIL_MARCA_PEDIDO();
+        }
+    }
+    
+    if(erro) quadros_invalidos++;
+    else quadros_validos++;
+    return erro;
+}
+
+/**
+ * @brief Trata um quadro recebido at o CR, com ou sem nmero de sequncia.
+ * @details Quadros terminados em "@SS" (SS = 00-FF em hexadecimal) so
+ * confirmados com ACK/NAK. Um quadro com a sequncia de um dos ltimos
+ * #SEQUENCIAS_ACEITAS aceitos, dentro de #JANELA_SEQUENCIA,  uma
+ * retransmisso: recebe novo ACK sem ser executado de novo, mesmo que outros
+ * quadros tenham sido aceitos depois dele. S os quadros que mudam o estado
+ * (pedidos, lotes, "$PF", "$CA" e "$Scnnn") entram em #sequencias_aceitas:
+ * as consultas "$?X" no mudam nada e so sempre executadas, para que a
+ * retransmisso de uma consulta cuja resposta se perdeu traga os dados de
+ * novo. Quadros sem sequncia so executados sem resposta.
+ * @param tamanho Quantidade de caracteres entre '$' e CR.
+ */
+static void UART_FinalizaQuadro(uint8_t tamanho){
+    
+    // 1. Quadro sem sequncia: comportamento original
+    if(tamanho < 3 || buffer_quadro[tamanho - 3] != '@'){
+        UART_ExecutaQuadro(tamanho);
+        return;
+    }
+    
+    // 2. Extrai a sequncia; se estiver corrompida no h a quem responder
+    uint8_t alta = UART_ValorHex(buffer_quadro[tamanho - 2]);
+    uint8_t baixa = UART_ValorHex(buffer_quadro[tamanho - 1]);
+    if(alta > 15 || baixa > 15){
+        quadros_invalidos++;
+        return;
+    }
+    uint8_t sequencia = (uint8_t)((alta << 4) | baixa);
+    
+    // 3. Retransmisso de um quadro j aceito (ACK anterior perdido);
+    // consultas so repetidas, no reconhecidas
+    bool consulta = (buffer_quadro[0] == '?');
+    for(uint8_t i=0; i<SEQUENCIAS_ACEITAS && !consulta; i++){
+        if(janela_sequencia[i] && sequencias_aceitas[i] == sequencia){
+            quadros_duplicados++;
+            UART_EnviaConfirmacao(sequencia, 0);
+            return;
+        }
+    }
+    
+    // 4. Executa e confirma
+    char erro = UART_ExecutaQuadro(tamanho - 3);
+    if(!erro && !consulta){
+        sequencias_aceitas[proxima_aceita] = sequencia;
+        janela_sequencia[proxima_aceita] = JANELA_SEQUENCIA;
+        proxima_aceita = (proxima_aceita + 1) & (SEQUENCIAS_ACEITAS - 1);
+    }
+    UART_EnviaConfirmacao(sequencia, erro);
+}
+
+/**
+ * @brief Consome os bytes disponveis na UART e executa os quadros completos.
+ * @details No bloqueia: l apenas enquanto houver bytes no buffer RX e mantm
+ * o quadro parcial em #buffer_quadro entre as chamadas.
+ * - '$' sempre inicia um novo quadro (ressincronismo aps rudo na linha).
+ * - CR encerra o quadro e o executa (ver UART_FinalizaQuadro()).
+ * - Bytes fora de quadro so ignorados; quadros maiores que #QUADRO_MAX so descartados.
+ */
+void UART_ProcessaRecepcao(void){
+    
+    // Envelhece a janela de supresso de duplicatas (uma chamada por ciclo)
+    for(uint8_t i=0; i<SEQUENCIAS_ACEITAS; i++){
+        if(janela_sequencia[i]) janela_sequencia[i]--;
+    }
+#if SONO_HABILITADO
+    if(ciclos_sem_rx < 255) ciclos_sem_rx++;
+#endif
+    
+    while(EUSART_is_rx_ready()){
+        char byte = EUSART_Read();
+        GRAVA(GRAVA_RX, (uint8_t)byte);
+#if SONO_HABILITADO
+        ciclos_sem_rx = 0;
+#endif
         
-        // 3. Validao do Terminador
-        // O protocolo exige que a mensagem termine com CR
-        if(EUSART_Read() == CR)
-            return 0; // Retorna 0 indicando sucesso na validao total
+        // 1. Cabealho: (re)inicia o quadro
+        if(byte == '$'){
+            indice_quadro = 0;
+        }
+        // 2. Fora de quadro: aguarda o prximo cabealho
+        else if(indice_quadro == QUADRO_OCIOSO){
+            // Byte descartado
+        }
+        // 3. Terminador: executa o quadro recebido
+        else if(byte == CR){
+            UART_FinalizaQuadro(indice_quadro);
+            indice_quadro = QUADRO_OCIOSO;
+        }
+        // 4. Contedo do quadro
+        else if(indice_quadro < QUADRO_MAX){
+            buffer_quadro[indice_quadro++] = byte;
+        }
+        // 5. Quadro longo demais: descarta
+        else {
+            quadros_invalidos++;
+            indice_quadro = QUADRO_OCIOSO;
+        }
     }
+}
+
+/**
+ * @brief Agrupa os campos de estado discretos em um nico valor comparvel.
+ * @return Bits 0-1: andar atual, 2-3: destino, 4-5: motor, 6-8: estado da mquina.
+ */
+static uint16_t UART_AssinaturaEstado(void){
+    return (uint16_t)((estado_atual << 6) | (estado_motor << 4) | (andar_destino << 2) | andar_atual);
+}
+
+/**
+ * @brief Decide se o quadro completo (canal geral) deve ser enviado neste ciclo.
+ * @details Envia imediatamente quando andar, destino, motor ou estado mudam
+ * desde o ltimo quadro; caso contrrio respeita o perodo adaptativo:
+ * #TELEMETRIA_MOVIMENTO com o motor ligado e #TELEMETRIA_REPOUSO parado.
+ * @return true - Enviar agora.
+ * @return false - Aguardar ou canal desligado.
+ */
+static bool UART_TelemetriaDevida(void){
+    
+    if(!periodo_canal[CANAL_GERAL]) return false;
     
-    // Se chegar aqui, indica falha e retorna 1
-    return 1;    
+    // 1. Evento: mudana de estado discreto
+    if(UART_AssinaturaEstado() != assinatura_telemetria) return true;
+    
+    // 2. Peridico conforme a atividade
+    if(estado_motor == MOTOR_PARADO) return (contador_telemetria >= TELEMETRIA_REPOUSO);
+    return (contador_telemetria >= TELEMETRIA_MOVIMENTO);
+}
+
+/**
+ * @brief Envia o sufixo comum a todos os quadros de telemetria: ",NN,MMMM".
+ * @details NN = sequncia do quadro e MMMM = relgio em ms no momento do envio,
+ * ambos em hexadecimal. Permitem ao host reconstruir o instante de cada
+ * amostra, detectar quadros perdidos e medir o jitter do enlace.
+ */
+static void UART_EnviaCarimbo(void){
+    uint16_t agora = RELOGIO_Ms();
+    
+    EUSART_Write(',');
+    UART_EnviaHex(sequencia_telemetria++);
+    EUSART_Write(',');
+    UART_EnviaHex((uint8_t)(agora >> 8));
+    UART_EnviaHex((uint8_t)agora);
 }
 
 /**
  * @brief Transmite o pacote de telemetria do sistema via UART.
- * @note Protocolo do Pacote: "$A,D,M,PPP,VV.V,TT.T\r"
+ * @note Protocolo do Pacote: "$A,D,M,PPP,VV.V,TT.T,NN,MMMM\r"
  * Onde:
  * - $: Cabealho de incio de frame.
  * - A: Andar Atual (0-9)
@@ -170,6 +771,8 @@ int UART_RecebePedido(char* origem_pedido, char* destino_pedido){
  * - PPP: Posio em mm (000-999)
  * - VV.V: Velocidade (00.0-99.9)
  * - TT.T: Temperatura (00.0-99.9)
+ * - NN: Sequncia do quadro (00-FF, hexadecimal)
+ * - MMMM: Relgio em ms (0000-FFFF, hexadecimal)
  * - \r: Terminador (Carriage Return)
  */
 void UART_EnviaDados(void){
@@ -210,10 +813,192 @@ void UART_EnviaDados(void){
     EUSART_Write('.'); 
     EUSART_Write('0' + (temperatura_ponte % 10));
 
-    // 8. Finalizador de Linha 
+    // 8. Sequncia e carimbo de tempo
+    UART_EnviaCarimbo();
+
+    // 9. Finalizador de Linha 
     // Envia o CR para indicar o fim do pacote
     EUSART_Write(13); 
+    
+    // Registra o estado enviado para a deteco de eventos
+    assinatura_telemetria = UART_AssinaturaEstado();
+}
+
+/**
+ * @brief Envia o mapa do poo em uso.
+ * @note Formato: "#C,S,PPP,PPP,PPP,PPP,UUUU,HHH"
+ * - S: Situao (#MAPA_NOMINAL, #MAPA_CALIBRADO ou #MAPA_FALHA).
+ * - PPP: Pulsos do encoder em cada andar, do trreo ao 3.
+ * - UUUU: Escala em m por pulso.
+ * - HHH: Histerese das bordas dos ms em pulsos.
+ * Tambm enviado ao fim de cada calibrao.
+ */
+void UART_EnviaCalibracao(void){
+    EUSART_Write('#');
+    EUSART_Write('C');
+    EUSART_Write(',');
+    UART_EnviaNumero(mapa_poco.situacao, 1);
+    for(uint8_t a = 0; a < 4; a++){
+        EUSART_Write(',');
+        UART_EnviaNumero(mapa_poco.andar[a], 3);
+    }
+    EUSART_Write(',');
+    UART_EnviaNumero(mapa_poco.microns, 4);
+    EUSART_Write(',');
+    UART_EnviaNumero(mapa_poco.histerese, 3);
+    EUSART_Write(CR);
+}
+
+/**
+ * @brief Anuncia que o elevador est pronto para atender aps o reset.
+ * @note Formato: "#R,O,TTTTT"
+ * - O: Origem da posio (#POSICAO_DESCONHECIDA, #POSICAO_SENSOR ou #POSICAO_MEMORIA).
+ * - TTTTT: Tempo desde o reset em ms (tempo at o primeiro atendimento).
+ */
+void UART_EnviaPronto(void){
+    EUSART_Write('#');
+    EUSART_Write('R');
+    EUSART_Write(',');
+    UART_EnviaNumero(origem_posicao, 1);
+    EUSART_Write(',');
+    UART_EnviaNumero(RELOGIO_Ms(), 5);
+    EUSART_Write(CR);
+}
+
+#if GRAVACAO_HABILITADA
+/**
+ * @brief Envia um registro de entrada no formato "&K,TTTTT,VVV".
+ * @param tipo Letra do registro (GRAVA_*).
+ * @param tempo Instante em ms (ou endereo, nos registros da EEPROM).
+ * @param valor Valor de at 12 bits, em hexadecimal.
+ */
+static void UART_EnviaRegistro(char tipo, uint16_t tempo, uint16_t valor){
+    EUSART_Write('&');
+    EUSART_Write(tipo);
+    EUSART_Write(',');
+    UART_EnviaNumero(tempo, 5);
+    EUSART_Write(',');
+    uint8_t nibble = (valor >> 8) & 0x0F;
+    EUSART_Write(nibble < 10 ? '0' + nibble : 'A' - 10 + nibble);
+    UART_EnviaHex((uint8_t)valor);
+    EUSART_Write(CR);
+}
+
+void UART_IniciaGravacao(void){
+    UART_EnviaRegistro(GRAVA_UNIDADE, 0, 1000);
+    
+    // EEPROM apagada (0xFF)  o padro da reproduo: s os bytes gravados
+    for(uint16_t endereco = 0; endereco < 256; endereco++){
+        uint8_t valor = DATAEE_ReadByte((uint8_t)endereco);
+        if(valor != 0xFF) UART_EnviaRegistro(GRAVA_EEPROM, endereco, valor);
+    }
+}
+
+void UART_EnviaGravacao(void){
+    RegistroEntrada r;
+    while(GRAVACAO_Retira(&r)){
+        UART_EnviaRegistro(r.tipo, r.tempo, r.valor);
+    }
+}
+#endif
+
+/**
+ * @brief Transmite o quadro de um canal especfico.
+ * @note Quadros "$c,valor,NN,MMMM" com a letra do canal; o canal geral usa UART_EnviaDados().
+ * @param canal ndice do canal (#CANAL_POSICAO a #CANAL_FILA).
+ */
+static void UART_EnviaCanal(uint8_t canal){
+    EUSART_Write('$');
+    EUSART_Write(LUT_canal[canal]);
+    EUSART_Write(',');
+    
+    if(canal == CANAL_POSICAO) UART_EnviaNumero(posicao_mm, 3);
+    else if(canal == CANAL_VELOCIDADE) UART_EnviaDecimal(velocidade_atual);
+    else if(canal == CANAL_TEMPERATURA) UART_EnviaDecimal(temperatura_ponte);
+    else UART_EnviaFila();
+    
+    UART_EnviaCarimbo();
+    EUSART_Write(CR);
+}
+
+/**
+ * @brief Escalonador de transmisso da telemetria, chamado uma vez por ciclo.
+ * @details Envia no mximo um quadro por ciclo, dentro da banda da UART:
+ * 1. O quadro completo tem prioridade (eventos e perodo adaptativo) e 
+ *    enviado mesmo com a linha em dbito, para no atrasar eventos.
+ * 2. Seno, entre os canais assinados vencidos, envia o mais atrasado em
+ *    relao ao prprio perodo, se houver crdito de banda para ele.
+ * @return ndice do canal enviado, ou #CANAL_NENHUM.
+ */
+uint8_t UART_EscalonaTelemetria(void){
+    
+    // 1. Atualiza a banda disponvel e os relgios dos canais
+    credito_tx += BYTES_POR_CICLO;
+    if(credito_tx > CREDITO_MAX) credito_tx = CREDITO_MAX;
+    contador_telemetria++;
+    for(uint8_t i=0; i<NUM_CANAIS; i++){
+        if(atraso_canal[i] < 255) atraso_canal[i]++;
+    }
+    
+    // 2. Quadro completo
+    if(UART_TelemetriaDevida()){
+        UART_EnviaDados();
+        credito_tx -= LUT_tamanho_canal[CANAL_GERAL];
+        if(credito_tx < CREDITO_MIN) credito_tx = CREDITO_MIN;
+        contador_telemetria = 0;
+        atraso_canal[CANAL_GERAL] = 0;
+        return CANAL_GERAL;
+    }
+    
+    // 3. Canal vencido mais atrasado
+    uint8_t escolhido = CANAL_NENHUM;
+    uint8_t maior_folga = 0;
+    for(uint8_t i=CANAL_POSICAO; i<NUM_CANAIS; i++){
+        if(periodo_canal[i] && atraso_canal[i] >= periodo_canal[i]){
+            uint8_t folga = atraso_canal[i] - periodo_canal[i];
+            if(escolhido == CANAL_NENHUM || folga > maior_folga){
+                escolhido = i;
+                maior_folga = folga;
+            }
+        }
+    }
+    
+    // 4. Envia somente se couber na banda
+    if(escolhido == CANAL_NENHUM || credito_tx < (int8_t)LUT_tamanho_canal[escolhido]){
+        return CANAL_NENHUM;
+    }
+    UART_EnviaCanal(escolhido);
+    credito_tx -= LUT_tamanho_canal[escolhido];
+    atraso_canal[escolhido] = 0;
+    return escolhido;
+}
+
+#if SONO_HABILITADO
+/**
+ * @brief Verifica se a UART permite o SLEEP.
+ * @details A transmisso precisa ter terminado (o SLEEP interromperia o byte
+ * no registrador de deslocamento) e nenhum byte pode ter chegado nos ltimos
+ * #VIGILIA_RX ciclos: o restante do quadro seria perdido no despertar.
+ * Um quadro parcial parado h mais tempo que isso  tratado como abandonado.
+ * @return true - Nada a enviar nem a receber.
+ */
+bool UART_Ociosa(void){
+    if(ciclos_sem_rx < VIGILIA_RX || EUSART_is_rx_ready()) return false;
+    return EUSART_is_tx_done();
+}
+
+/**
+ * @brief Verifica se algum canal de telemetria est assinado.
+ * @return false - Todos os canais em 000 (inclusive o geral): o PIC pode
+ * dormir at o prximo quadro recebido.
+ */
+bool UART_TelemetriaAssinada(void){
+    for(uint8_t i=0; i<NUM_CANAIS; i++){
+        if(periodo_canal[i]) return true;
+    }
+    return false;
 }
+#endif
 
 
 // FUNES DA MATRIZ 
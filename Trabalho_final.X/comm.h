@@ -7,16 +7,41 @@
 #define	COMM_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "gravacao.h"
+#include "sono.h"
 
 /*
  * CONSTANTES E TABELAS
  */
 
+/**
+ * @brief Canais de telemetria assinveis com "$Scnnn".
+ * - GERAL:       'G' - Quadro completo "$A,D,M,PPP,VV.V,TT.T" (por evento e adaptativo).
+ * - POSICAO:     'P' - "$P,PPP".
+ * - VELOCIDADE:  'V' - "$V,VV.V".
+ * - TEMPERATURA: 'T' - "$T,TT.T".
+ * - FILA:        'F' - "$F,SSSS,DDDD".
+ * Todos terminam com ",NN,MMMM": sequncia do quadro e relgio em ms (hexadecimal).
+ */
+#define CANAL_GERAL        0
+#define CANAL_POSICAO      1
+#define CANAL_VELOCIDADE   2
+#define CANAL_TEMPERATURA  3
+#define CANAL_FILA         4
+#define NUM_CANAIS         5
+#define CANAL_NENHUM       0xFF
+
 /**
  * @brief LUT para os desenhos dos numeros 
  */
 extern const uint8_t LUT_Andar[];
 
+/**
+ * @brief LUT com a letra de cada canal de telemetria
+ */
+extern const char LUT_canal[];
+
 /**
  * @brief LUT para os desenhos dos status do elevador
  */
@@ -33,22 +58,74 @@ extern const uint8_t matrix_conf[];
  */
 
 /**
- * @brief Verifica o buffer da UART em busca de um pedido vlido.
- * @note Protocolo esperado: '$' + Origem + Destino + CR.
- * * @param OrigemPedido -  Ponteiro onde ser salvo o caractere da origem.
- * @param DestinoPedido - Ponteiro onde ser salvo o caractere do destino.
- * * @return 0 - Sucesso, mensagem vlida.
- * @return 1 - Erro, mensagem incompleta.
+ * @brief Consome os bytes recebidos pela UART sem bloquear.
+ * @details Monta o quadro entre '$' e CR e o executa ao receber o terminador.
+ * @note Quadros aceitos:
+ * - "$OD"           : Pedido de Origem para Destino (0-3).
+ * - "$O1D1O2D2..."  : Lote de at 5 pedidos em um nico quadro.
+ * - "$PF"           : Fecha a porta.
+ * - "$?S" "$?F" "$?E": Consultas de estado, fila e estatsticas (resposta com '#').
+ * - "$Scnnn"        : Assina o canal c com perodo nnn (ciclos de 10 ms, 000 = desliga).
+ * Qualquer quadro pode terminar com "@SS" (sequncia hexadecimal) para ser
+ * confirmado com "#K,SS" ou rejeitado com "#N,SS,c".
  */
-int UART_RecebePedido(char* OrigemPedido, char* DestinoPedido);
+void UART_ProcessaRecepcao(void);
 
 /**
  * @brief Coleta os estados globais do sistema e envia via telemetria.
- * @note Envia: Andar atual, destino, motor, posio, velocidade e temperatura.
+ * @note Envia: Andar atual, destino, motor, posio, velocidade, temperatura,
+ * sequncia do quadro e relgio em ms.
  * Formato CSV iniciado por '$' e finalizado por CR.
  */
 void UART_EnviaDados(void);
 
+/**
+ * @brief Envia "#R,O,TTTTT": origem da posio e tempo desde o reset at ficar pronto.
+ * @note Enviado uma nica vez, quando a mquina de estados sai da busca de referncia
+ * (ou logo no primeiro ciclo, se a posio j era conhecida).
+ */
+void UART_EnviaPronto(void);
+
+/**
+ * @brief Envia "#C,S,PPP,PPP,PPP,PPP,UUUU,HHH": situao, andares em pulsos, escala e histerese.
+ * @note Resposta de "$?C" e relatrio do fim da calibrao "$CA".
+ */
+void UART_EnviaCalibracao(void);
+
+/**
+ * @brief Envia no mximo um quadro de telemetria por ciclo, dentro da banda da UART.
+ * @note O quadro completo sai imediatamente em mudanas de estado, a cada 100 ms
+ * em movimento e a cada 1 s em repouso; os canais assinados ocupam a banda restante.
+ * @return Canal enviado (#CANAL_GERAL, ...) ou #CANAL_NENHUM.
+ */
+uint8_t UART_EscalonaTelemetria(void);
+
+#if SONO_HABILITADO
+/**
+ * @brief Verifica se a UART permite o SLEEP (TX vazia e RX calada h #VIGILIA_RX ciclos).
+ */
+bool UART_Ociosa(void);
+
+/**
+ * @brief Verifica se algum canal de telemetria est assinado (perodo diferente de 000).
+ */
+bool UART_TelemetriaAssinada(void);
+#endif
+
+#if GRAVACAO_HABILITADA
+/**
+ * @brief Abre a gravao: "&G,00000,3E8" (instantes em ms) e a EEPROM gravada.
+ * @note Chamar uma vez aps a inicializao da UART, antes de ler a EEPROM.
+ */
+void UART_IniciaGravacao(void);
+
+/**
+ * @brief Envia os registros de entrada pendentes, um "&K,TTTTT,VVV" por linha.
+ * @note Bloqueia enquanto a UART escoa os registros; chamar apenas no loop principal.
+ */
+void UART_EnviaGravacao(void);
+#endif
+
 /**
  * @brief Atualiza a Matriz de LEDs com base no estado atual.
  * @details Renderiza o nmero do andar, a seta de direo
@@ -27,11 +27,36 @@ volatile uint8_t estado_motor = MOTOR_PARADO;
  */
 volatile uint8_t posicao_mm = 0;        
 
+/**
+ * @brief Posio desconhecida at a restaurao da EEPROM na inicializao.
+ */
+uint8_t origem_posicao = POSICAO_DESCONHECIDA;
+
+/**
+ * @brief Mapa nominal (andares a cada #PULSOS_POR_ANDAR, janelas de 2 * #MEIA_JANELA)
+ * at a leitura da calibrao na EEPROM.
+ */
+MapaPoco mapa_poco = {
+    {0, PULSOS_POR_ANDAR, 2 * PULSOS_POR_ANDAR, 3 * PULSOS_POR_ANDAR},
+    {
+        {BORDA_NULA, MEIA_JANELA},
+        {PULSOS_POR_ANDAR - MEIA_JANELA, PULSOS_POR_ANDAR + MEIA_JANELA},
+        {2 * PULSOS_POR_ANDAR - MEIA_JANELA, 2 * PULSOS_POR_ANDAR + MEIA_JANELA},
+        {3 * PULSOS_POR_ANDAR - MEIA_JANELA, BORDA_NULA}
+    },
+    MICRONS_POR_PULSO, 0, MAPA_NOMINAL
+};
+
 /** 
  * @brief Velocidade inicial 0 mm/s. 
  */
 volatile uint8_t velocidade_atual = 0;  
 
+/** 
+ * @brief Relgio iniciado em 0 ms no reset. 
+ */
+volatile uint16_t tempo_ms = 0;
+
 /** 
  * @brief Temperatura inicial zerada. 
  */
@@ -57,6 +82,29 @@ bool chamadas_subida[4]  = {false, false, false, false};
 bool chamadas_descida[4] = {false, false, false, false};
 
 
+/**
+ * @brief Nenhum sentido comandado desde a inicializao.
+ */
+uint8_t ultima_direcao = MOTOR_PARADO;
+
+/**
+ * @brief Contador de confirmao de parada do motor zerado.
+ */
+uint8_t ciclos_parado = 0;
+
+/**
+ * @brief Dados de movimento por andar para o tempo de porta adaptativo.
+ * Inicializados sem embarques pendentes e sem histrico de demanda.
+ */
+bool embarque_pendente[4] = {false, false, false, false};
+uint8_t destinos_pendentes[4] = {0, 0, 0, 0};
+uint8_t demanda_andar[4]  = {0, 0, 0, 0};
+
+/** 
+ * @brief Tempo de porta inicial de 2 segundos (200 ciclos). 
+ */
+uint16_t tempo_porta = 200;
+
 /** 
  * @brief Inicializa o contador de tempo de telemetria zerado. 
  */
@@ -68,8 +116,22 @@ uint16_t contador_telemetria = 0;
 uint16_t contador_espera = 0;
 
 /**
- * @brief Buffers de recepo da UART.
- * Inicializados com 0 por segurana.
+ * @brief Buffer de recepo da UART.
+ * Inicia fora de quadro, aguardando o cabealho '$'.
+ */
+char buffer_quadro[QUADRO_MAX];
+uint8_t indice_quadro = QUADRO_OCIOSO;
+
+/**
+ * @brief Estatsticas da comunicao zeradas.
+ */
+uint16_t quadros_validos = 0;
+uint16_t quadros_invalidos = 0;
+uint16_t pedidos_recebidos = 0;
+uint16_t quadros_duplicados = 0;
+
+/**
+ * @brief Nenhuma sequncia confirmada desde a inicializao.
  */
-char buffer_origem = 0;
-char buffer_destino = 0;
\ No newline at end of file
+uint8_t sequencias_aceitas[SEQUENCIAS_ACEITAS] = {0, 0, 0, 0};
+uint8_t janela_sequencia[SEQUENCIAS_ACEITAS]   = {0, 0, 0, 0};
\ No newline at end of file
@@ -20,6 +20,37 @@
 #define MOTOR_SUBINDO   1   // Movimento ascendente 
 #define MOTOR_DESCENDO  2   // Movimento descendente 
 
+/**
+ * @brief Origem da posio conhecida pelo firmware (#origem_posicao).
+ */
+#define POSICAO_DESCONHECIDA  0   // Reset entre andares sem parada limpa gravada
+#define POSICAO_SENSOR        1   // Andar lido em um sensor, pulsos do mapa do poo
+#define POSICAO_MEMORIA       2   // ltima parada restaurada da EEPROM
+
+/**
+ * @brief Janela de confirmao de parada para a reverso.
+ * @note 12 ciclos * 10ms = 120ms, cobre ao menos uma amostra do encoder (TMR4 a cada 100ms).
+ */
+#define REVERSAO_CONFIRMA 12
+
+/**
+ * @brief Tamanho mximo do contedo de um quadro recebido (entre '$' e CR).
+ * @note 13 caracteres = lote de at 5 pares origem/destino + sequncia "@SS".
+ */
+#define QUADRO_MAX        13
+
+/**
+ * @brief Valor de #indice_quadro fora de um quadro (aguardando '$').
+ */
+#define QUADRO_OCIOSO     0xFF
+
+/**
+ * @brief Sequncias aceitas lembradas para reconhecer retransmisses.
+ * @note Potncia de 2. Cobre quadros aceitos entre um ACK perdido e a sua
+ * retransmisso (ex.: outros clientes do distribuidor "elevdist").
+ */
+#define SEQUENCIAS_ACEITAS 4
+
 
 /**
  * @brief Controle do Chip Select do Driver MAX7219.
@@ -61,6 +92,35 @@
  */
 #define MOTOR_OFF       0    // Motor desligado
 #define MOTOR_ON        614  // Motor ligado (~60%)
+#define MOTOR_BUSCA     410  // Busca de referncia no reset (~40%)
+
+/**
+ * @brief Pulsos nominais do encoder entre andares: 60 mm / 0,837 mm por pulso.
+ */
+#define PULSOS_POR_ANDAR  72
+
+/**
+ * @brief Escala nominal do encoder: 0.837 mm/pulso * 1000 = 837.
+ */
+#define MICRONS_POR_PULSO 837
+
+/**
+ * @brief Meia largura nominal da regio de deteco dos ms (~4 mm) em pulsos.
+ */
+#define MEIA_JANELA       5
+
+/**
+ * @brief Borda de m desconhecida no mapa do poo (ou fora da faixa de 8 bits).
+ * @note A borda inferior de S1 e a superior de S4 ficam alm dos fins de curso.
+ */
+#define BORDA_NULA        0xFF
+
+/**
+ * @brief Situao do mapa do poo (#mapa_poco).
+ */
+#define MAPA_NOMINAL      0   // Constantes de projeto, sem calibrao gravada
+#define MAPA_CALIBRADO    1   // Medido pela calibrao "$CA" (gravado na EEPROM)
+#define MAPA_FALHA        2   // ltima calibrao falhou; o mapa anterior foi mantido
 
 
 // VARIVEIS GLOBAIS 
@@ -89,12 +149,47 @@ extern volatile uint8_t estado_motor;
  */
 extern volatile uint8_t posicao_mm;
 
+/**
+ * @brief Mapa do poo em pulsos do encoder.
+ * - andar:     Posio de cada andar (0 = repouso em S1 aps a descida).
+ * - borda:     Bordas [andar][0 = inferior, 1 = superior] de cada m, na mdia
+ *              dos dois sentidos, ou #BORDA_NULA.
+ * - microns:   Escala do encoder em m por pulso.
+ * - histerese: Diferena entre a mesma borda de m vista subindo e descendo (pulsos).
+ * - situacao:  #MAPA_NOMINAL, #MAPA_CALIBRADO ou #MAPA_FALHA.
+ */
+typedef struct {
+    uint8_t andar[4];
+    uint8_t borda[4][2];
+    uint16_t microns;
+    uint8_t histerese;
+    uint8_t situacao;
+} MapaPoco;
+
+/**
+ * @brief Mapa do poo em uso.
+ * @note A escala  lida na interrupo do TMR4; trocar o mapa com SENSORES_DefineMapa().
+ */
+extern MapaPoco mapa_poco;
+
+/**
+ * @brief De onde veio a posio atual desde o reset.
+ * @note Valores: #POSICAO_DESCONHECIDA, #POSICAO_SENSOR ou #POSICAO_MEMORIA.
+ */
+extern uint8_t origem_posicao;
+
 /**
  * @brief Velocidade instantnea.
  * @note Unidade: mm/s.
  */
 extern volatile uint8_t velocidade_atual;
 
+/**
+ * @brief Relgio livre em milissegundos desde o reset.
+ * @note Atualizado na interrupo do TMR2; ler com RELOGIO_Ms().
+ */
+extern volatile uint16_t tempo_ms;
+
 /**
  * @brief Temperatura monitorada na Ponte H.
  * @note Unidade:C.
@@ -118,7 +213,9 @@ typedef enum {
     ESTADO_SUBINDO,
     ESTADO_DESCENDO,
     ESTADO_ESPERA_PORTA,
-    ESTADO_REVERSAO
+    ESTADO_REVERSAO,
+    ESTADO_BUSCA,
+    ESTADO_CALIBRACAO
 } EstadoElevador;
 
 /**
@@ -136,8 +233,46 @@ extern bool chamadas_subida[4];
  */
 extern bool chamadas_descida[4]; 
 
+/**
+ * @brief ltimo sentido de movimento comandado ao motor.
+ * @note Valores: 0 (Nenhum), 1 (Subindo), 2 (Descendo).
+ */
+extern uint8_t ultima_direcao;
+
+/**
+ * @brief Ciclos consecutivos com motor desligado e encoder sem pulsos.
+ * @note Saturado em 255. Unidade: ciclos do loop principal (10 ms).
+ */
+extern uint8_t ciclos_parado;
+
+/**
+ * @brief Indica andares com passageiro aguardando embarque (origem de um pedido).
+ * @note true = a parada nesse andar atende um embarque, no apenas desembarque.
+ */
+extern bool embarque_pendente[4];
+
+/**
+ * @brief Destinos dos passageiros que aguardam em cada andar (bit n = andar n).
+ * @note Viram chamadas s no embarque (Abrir_Porta() na origem); marcados j no
+ * pedido, seriam atendidos e apagados por uma parada anterior ao embarque.
+ */
+extern uint8_t destinos_pendentes[4];
+
+/**
+ * @brief ndice de movimento de cada andar.
+ * @note Incrementado a cada pedido com origem no andar e decado a cada parada.
+ */
+extern uint8_t demanda_andar[4];
+
+/**
+ * @brief Tempo de porta aberta da parada atual.
+ * @note Unidade: ciclos do loop principal (10 ms).
+ */
+extern uint16_t tempo_porta;
+
 /**
  * @brief Contador para diviso de frequncia da Telemetria.
+ * @note Ciclos desde o ltimo quadro enviado.
  */
 extern uint16_t contador_telemetria;
 
@@ -147,13 +282,37 @@ extern uint16_t contador_telemetria;
 extern uint16_t contador_espera;
 
 /**
- * @brief Buffer temporrio para o andar de origem.
+ * @brief Contedo do quadro em recepo, sem o '$' e o CR.
+ */
+extern char buffer_quadro[QUADRO_MAX];
+
+/**
+ * @brief Quantidade de caracteres j recebidos no quadro atual.
+ * @note #QUADRO_OCIOSO enquanto aguarda o cabealho '$'.
+ */
+extern uint8_t indice_quadro;
+
+/**
+ * @brief Estatsticas da comunicao, enviadas na consulta "$?E".
+ * - quadros_validos:   Quadros executados.
+ * - quadros_invalidos: Quadros descartados (formato, andar fora da faixa ou tamanho).
+ * - pedidos_recebidos: Pares origem/destino registrados.
+ * - quadros_duplicados: Retransmisses reconhecidas e no executadas.
+ */
+extern uint16_t quadros_validos;
+extern uint16_t quadros_invalidos;
+extern uint16_t pedidos_recebidos;
+extern uint16_t quadros_duplicados;
+
+/**
+ * @brief Sequncias dos ltimos quadros confirmados com ACK (anel).
  */
-extern char buffer_origem;   
+extern uint8_t sequencias_aceitas[SEQUENCIAS_ACEITAS];
 
 /**
- * @brief Buffer temporrio para o andar de destino.
+ * @brief Ciclos restantes em que cada entrada de #sequencias_aceitas  tratada como duplicata.
+ * @note 0 = entrada livre ou expirada.
  */
-extern char buffer_destino;  
+extern uint8_t janela_sequencia[SEQUENCIAS_ACEITAS];
 
 #endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+/**
+ * @file gravacao.c
+ * @brief Fila dos registros de entrada enviados pela UART no modo de depurao.
+ * @details Compilado apenas com GRAVACAO_HABILITADA = 1. As entradas lidas nas
+ * interrupes (TMR0 e ADC na tarefa do TMR4) no podem esperar a UART, ento
+ * todo registro passa por esta fila e sai no loop principal
+ * (UART_EnviaGravacao()).
+ */
+
+#include "gravacao.h"
+
+#if GRAVACAO_HABILITADA
+
+#include "globals.h"
+#include "mcc_generated_files/mcc.h"
+
+
+// CONSTANTES E VARIVEIS
+
+/**
+ * @brief Capacidade da fila, em registros.
+ * @note Cobre as entradas de um ciclo de 10 ms com folga; em repouso s o
+ * TMR4 gera registros (2 a cada 100 ms).
+ */
+#define GRAVACAO_FILA  8
+
+static RegistroEntrada fila[GRAVACAO_FILA];
+static uint8_t fila_inicio = 0;
+static uint8_t fila_tamanho = 0;
+
+/**
+ * @brief Registros descartados com a fila cheia, ainda no informados.
+ */
+static uint8_t perdidos = 0;
+
+
+// FUNES DA GRAVAO
+
+void GRAVACAO_Registra(char tipo, uint16_t valor){
+    // Preserva o GIE: dentro da interrupo ele j est desligado e no pode ser religado
+    uint8_t gie = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+
+    if(fila_tamanho < GRAVACAO_FILA){
+        uint8_t i = fila_inicio + fila_tamanho;
+        if(i >= GRAVACAO_FILA) i -= GRAVACAO_FILA;
+        fila[i].tipo = tipo;
+        fila[i].tempo = tempo_ms;
+        fila[i].valor = valor;
+        fila_tamanho++;
+    }
+    else if(perdidos != 0xFF){
+        perdidos++;
+    }
+
+    INTCONbits.GIE = gie;
+}
+
+bool GRAVACAO_Retira(RegistroEntrada* registro){
+    bool retirou = false;
+
+    INTCONbits.GIE = 0;
+    if(fila_tamanho){
+        *registro = fila[fila_inicio];
+        if(++fila_inicio >= GRAVACAO_FILA) fila_inicio = 0;
+        fila_tamanho--;
+        retirou = true;
+    }
+    else if(perdidos){
+        registro->tipo = GRAVA_PERDIDOS;
+        registro->tempo = tempo_ms;
+        registro->valor = perdidos;
+        perdidos = 0;
+        retirou = true;
+    }
+    INTCONbits.GIE = 1;
+
+    return retirou;
+}
+
+#endif
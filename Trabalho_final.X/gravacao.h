@@ -0,0 +1,84 @@
+/**
+ * @file gravacao.h
+ * @brief Gravao das entradas externas do firmware para reproduo no simulador.
+ * @details Cada entrada observada pelo firmware vira um registro com o instante
+ * em que foi lida: bytes recebidos pela UART, mudanas dos sensores de andar,
+ * leituras do TMR0 (encoder) e amostras do ADC. Os registros so enfileirados
+ * (inclusive dentro das interrupes) e enviados pelo loop principal como
+ * linhas "&K,TTTTT,VVV<CR>"; capturadas da serial, formam o arquivo que o
+ * simulador reproduz com "elevsim --reproduz" (ver simulador/README.md).
+ * @note Habilitado apenas com GRAVACAO_HABILITADA = 1 (ex.: -DGRAVACAO_HABILITADA=1
+ * nas macros do projeto). Desligado, as macros no geram cdigo. O envio dos
+ * registros ocupa a UART alm da banda da telemetria e estica os ciclos em
+ * que h muitas entradas: usar apenas em compilaes de depurao.
+ */
+
+#ifndef GRAVACAO_H
+#define GRAVACAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef GRAVACAO_HABILITADA
+#define GRAVACAO_HABILITADA 0
+#endif
+
+
+/**
+ * @brief Tipos de registro (letra da linha "&K,...").
+ * - UNIDADE:  'G' - Cabealho: unidade do instante em s (1000 no alvo).
+ * - EEPROM:   'E' - Contedo da EEPROM no reset ("&E,AAA,VVV": endereo e byte).
+ * - RX:       'R' - Byte consumido da UART.
+ * - SENSORES: 'S' - Mscara dos sensores de andar ativos (bit n = andar n).
+ * - TIMER0:   'C' - Leitura do TMR0 (contagem do encoder).
+ * - ADC:      'A' - Amostra do ADC (canal do LM35).
+ * - PERDIDOS: 'X' - Registros descartados com a fila cheia.
+ */
+#define GRAVA_UNIDADE   'G'
+#define GRAVA_EEPROM    'E'
+#define GRAVA_RX        'R'
+#define GRAVA_SENSORES  'S'
+#define GRAVA_TIMER0    'C'
+#define GRAVA_ADC       'A'
+#define GRAVA_PERDIDOS  'X'
+
+/**
+ * @brief Registro de uma entrada.
+ * - tipo:  Letra do tipo (GRAVA_*).
+ * - tempo: Relgio de ms na leitura (#tempo_ms, volta a 0 a cada 65,5 s).
+ * - valor: Valor lido (at 10 bits).
+ */
+typedef struct {
+    char tipo;
+    uint16_t tempo;
+    uint16_t valor;
+} RegistroEntrada;
+
+
+#if GRAVACAO_HABILITADA
+
+/**
+ * @brief Enfileira um registro com o instante atual.
+ * @details Pode ser chamada no loop principal e nas interrupes. Com a fila
+ * cheia o registro  descartado e contado para um registro #GRAVA_PERDIDOS.
+ * @note Custo em RAM: ~45 bytes (fila de #GRAVACAO_FILA registros).
+ */
+void GRAVACAO_Registra(char tipo, uint16_t valor);
+
+/**
+ * @brief Retira o registro mais antigo da fila.
+ * @details Com a fila vazia, os registros descartados desde a ltima retirada
+ * saem como um registro #GRAVA_PERDIDOS com a quantidade.
+ * @return false se a fila estiver vazia.
+ */
+bool GRAVACAO_Retira(RegistroEntrada* registro);
+
+#define GRAVA(tipo, valor)   GRAVACAO_Registra(tipo, valor)
+
+#else
+
+#define GRAVA(tipo, valor)   ((void)0)
+
+#endif
+
+#endif	/* GRAVACAO_H */
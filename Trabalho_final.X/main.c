@@ -19,6 +19,9 @@
 #include "globals.h"
 #include "comm.h"
 #include "motor.h"
+#include "perfil.h"
+#include "memoria.h"
+#include "sono.h"
 
 /**
  * @brief Cdigo principal do sistema
@@ -43,6 +46,12 @@ void main(void) {
     
     // Registra o callback 'SENSORES_CalcularVelocidade' no Timer 4
     TMR4_SetInterruptHandler(SENSORES_CalcularVelocidade);
+    
+    // Registra o relgio de milissegundos no Timer 2 (mesmo timer do PWM, 512 s)
+    TMR2_SetInterruptHandler(RELOGIO_Tick);
+
+    // Liga o TMR1 do perfilador de ciclos (vazio sem PERFIL_HABILITADO)
+    PERFIL_INICIALIZA();
 
     // Habilita as interrupes globais e perifricas
     INTERRUPT_GlobalInterruptEnable();
@@ -52,72 +61,77 @@ void main(void) {
     SSP1CON1bits.SSPEN = 0; 
     SSP1CON1bits.SSPEN = 1; 
 
+#if GRAVACAO_HABILITADA
+    // Depurao: abre a gravao das entradas com o contedo da EEPROM
+    UART_IniciaGravacao();
+#endif
+
+    // Recupera a posio da ltima parada (EEPROM), conferida com os sensores de andar
+    MEMORIA_Restaura();
+
     // Garante que o motor inicie parado
     Controle_Parar(); 
     
+    // Sem posio confivel: busca devagar o sensor de andar mais provvel
+    if (origem_posicao == POSICAO_DESCONHECIDA) {
+        Controle_IniciarBusca(MEMORIA_SentidoInterrompido());
+        estado_atual = ESTADO_BUSCA;
+    }
+    bool pronto = false;
+    
     // Inicializa e limpa a matriz de LEDs
     //MatrizInicializa();
     
     while (1) {
         
         // A. COMUNICAO BLUETOOTH
-        // Verifica se h novos dados recebidos na serial
-        if(EUSART_is_rx_ready()) {
-            if (UART_RecebePedido(&buffer_origem, &buffer_destino) == 0) { 
-                
-                // Converte caracteres ASCII para inteiros
-                int origem = buffer_origem - '0';
-                int destino = buffer_destino - '0';
-                
-                // Valida se os andares esto dentro do limite (0 a 3)
-                if (origem >= 0 && origem <= 3 && destino >= 0 && destino <= 3) {
-                    
-                    // Atualiza a varivel global de destino para telemetria
-                    andar_destino = (uint8_t)destino; 
-                    
-                    // Define a direo da solicitao com base na origem e destino
-                    if (origem < destino) { 
-                        chamadas_subida[origem] = true;
-                        chamadas_subida[destino] = true;
-                    } 
-                    else if (origem > destino) {
-                        chamadas_descida[origem] = true;
-                        chamadas_descida[destino] = true;
-                    }
-                }
-            }
-        }
+        // Consome os bytes recebidos sem bloquear e executa os quadros completos
+        // (pedidos, lotes de pedidos, fechamento de porta e consultas)
+        PERFIL_INICIO(PERFIL_RECEPCAO);
+        UART_ProcessaRecepcao();
+        PERFIL_FIM(PERFIL_RECEPCAO);
 
         // B. LEITURA DE SENSORES
         // Atualiza a posio atual do elevador
+        PERFIL_INICIO(PERFIL_SENSORES);
         Verificar_Sensores();
+        PERFIL_FIM(PERFIL_SENSORES);
 
         // C. MQUINA DE ESTADOS
+        PERFIL_INICIO(PERFIL_ESTADOS);
         switch (estado_atual) {
             
             // Estado 1: Elevador em repouso
             case ESTADO_PARADO:
                 // Prioridade 1: Atendimento local, verifica solicitaes de subida no andar atual
                 if (chamadas_subida[andar_atual]) {
-                    Limpar_Chamada_Atual(); 
-                    estado_atual = ESTADO_ESPERA_PORTA;
-                    contador_espera = 0;
+                    Abrir_Porta();
                 }
                 // Prioridade 2: Atendimento local, verifica solicitaes de descida no andar atual
                 else if (chamadas_descida[andar_atual]) {
-                    Limpar_Chamada_Atual();
-                    estado_atual = ESTADO_ESPERA_PORTA;
-                    contador_espera = 0;
+                    Abrir_Porta();
                 }
                 // Prioridade 3: Anlise de chamadas pendentes nos andares superiores
-                else if (Existe_Chamada_Acima(andar_atual)) {
-                    Controle_Subir();
-                    estado_atual = ESTADO_SUBINDO;
+                // (descendo, mantm o sentido enquanto houver chamadas abaixo: sem isso
+                // chamadas novas acima atrasariam os andares de baixo indefinidamente)
+                else if (Existe_Chamada_Acima(andar_atual) &&
+                         !(ultima_direcao == MOTOR_DESCENDO && Existe_Chamada_Abaixo(andar_atual))) {
+                    // Inverso de sentido com o motor ainda girando: aguarda a reverso
+                    if (Exige_Reversao(MOTOR_SUBINDO)) {
+                        estado_atual = ESTADO_REVERSAO;
+                    } else {
+                        Controle_Subir();
+                        estado_atual = ESTADO_SUBINDO;
+                    }
                 }
                 // Prioridade 4: Anlise de chamadas pendentes nos andares inferiores
                 else if (Existe_Chamada_Abaixo(andar_atual)) {
-                    Controle_Descer();
-                    estado_atual = ESTADO_DESCENDO;
+                    if (Exige_Reversao(MOTOR_DESCENDO)) {
+                        estado_atual = ESTADO_REVERSAO;
+                    } else {
+                        Controle_Descer();
+                        estado_atual = ESTADO_DESCENDO;
+                    }
                 }
                 // Prioridade 5: Retorno  base (Homing) em caso de ociosidade
                 else if (andar_atual != 0) {
@@ -127,12 +141,13 @@ void main(void) {
             
             // Estado 2: Elevador em movimento de subida     
             case ESTADO_SUBINDO:
+                // Entre andares no h deciso a tomar: segue at o prximo sensor
+                if (!Cabine_No_Andar()) break;
+                
                 // Prioridade 1: Verifica se deve parar no andar atual para atendimento (Carona)
                 if (chamadas_subida[andar_atual]) {
                     Controle_Parar();
-                    Limpar_Chamada_Atual();
-                    estado_atual = ESTADO_ESPERA_PORTA;
-                    contador_espera = 0;
+                    Abrir_Porta();
                 }
                 // Prioridade 2: Verifica o fim do percurso de subida
                 else if (!Existe_Chamada_Acima(andar_atual)) {
@@ -140,9 +155,7 @@ void main(void) {
                     // Se houver requisio de descida neste andar, realiza a inverso de servio
                     if (chamadas_descida[andar_atual]) {
                         Controle_Parar();
-                        Limpar_Chamada_Atual();
-                        estado_atual = ESTADO_ESPERA_PORTA;
-                        contador_espera = 0;
+                        Abrir_Porta();
                     } 
                     // Se no houver mais solicitaes, retorna ao repouso
                     else {
@@ -154,12 +167,12 @@ void main(void) {
             
             // Estado 3: Elevador em movimento de descida     
             case ESTADO_DESCENDO:
+                if (!Cabine_No_Andar()) break;
+                
                 // Prioridade 1: Verifica se deve parar no andar atual para atendimento
                 if (chamadas_descida[andar_atual]) {
                     Controle_Parar();
-                    Limpar_Chamada_Atual();
-                    estado_atual = ESTADO_ESPERA_PORTA;
-                    contador_espera = 0;
+                    Abrir_Porta();
                 }
                 // Prioridade 2: Verifica o fim do percurso de descida
                 else if (!Existe_Chamada_Abaixo(andar_atual)) {
@@ -167,9 +180,7 @@ void main(void) {
                     // Se houver requisio de subida neste andar, realiza a inverso de servio
                     if (chamadas_subida[andar_atual]) {
                          Controle_Parar();
-                         Limpar_Chamada_Atual();
-                         estado_atual = ESTADO_ESPERA_PORTA;
-                         contador_espera = 0;
+                         Abrir_Porta();
                     } 
                     // Se no houver mais solicitaes, retorna ao repouso
                     else {
@@ -182,32 +193,58 @@ void main(void) {
             // Estado 4: Simulao de porta aberta - Tempo de embarque
             case ESTADO_ESPERA_PORTA:
                 contador_espera++;
-                // Temporizao: 200 ciclos * 10ms = 2 Segundos
-                if (contador_espera >= 200) { 
-                    estado_atual = ESTADO_REVERSAO;
-                    contador_espera = 0;
+                // Temporizao adaptativa: tempo_porta ciclos * 10ms (calculado em Abrir_Porta)
+                // A reverso s  exigida em ESTADO_PARADO se o sentido mudar
+                if (contador_espera >= tempo_porta) { 
+                    estado_atual = ESTADO_PARADO;
                 }
                 break;
             
             // Estado 5: Reverso de segurana 
             case ESTADO_REVERSAO:
-                contador_espera++;
-                // Temporizao: 50 ciclos * 10ms = 0.5 Segundos
-                // Garante a parada total do motor antes de nova manobra
-                if (contador_espera >= 50) { 
+                // Garante a parada total do motor antes de inverter o sentido:
+                // encerra assim que o encoder confirma velocidade nula
+                if (ciclos_parado >= REVERSAO_CONFIRMA) { 
                     estado_atual = ESTADO_PARADO; 
                 }
                 break;
+            
+            // Estado 6: Busca de referncia aps reset sem posio confivel
+            // (os pedidos recebidos aguardam nas filas at o fim da busca)
+            case ESTADO_BUSCA:
+                if (Controle_Buscar()) {
+                    estado_atual = ESTADO_PARADO;
+                }
+                break;
+            
+            // Estado 7: Calibrao do poo (comando "$CA")
+            // (percorre S1 -> S4 -> S1 devagar; os pedidos aguardam nas filas)
+            case ESTADO_CALIBRACAO:
+                if (Controle_Calibrar()) {
+                    UART_EnviaCalibracao();
+                    estado_atual = ESTADO_PARADO;
+                }
+                break;
+        }
+        PERFIL_FIM(PERFIL_ESTADOS);
+        
+        // Primeiro ciclo fora da busca: anuncia o tempo at o primeiro atendimento
+        // (a busca tambm termina pela parada de segurana em S1/S4)
+        if (!pronto && estado_atual != ESTADO_BUSCA) {
+            UART_EnviaPronto();
+            pronto = true;
         }
 
         // D. TELEMETRIA E INTERFACE 
-        contador_telemetria++;
+        // Escalonador de TX: um quadro por ciclo. O quadro completo sai por evento
+        // (mudana de estado) ou a cada 100 ms em movimento / 1 s em repouso;
+        // os canais assinados com "$Scnnn" usam a banda restante
+        PERFIL_INICIO(PERFIL_TELEMETRIA);
+        uint8_t canal_enviado = UART_EscalonaTelemetria();
+        PERFIL_FIM(PERFIL_TELEMETRIA);
 
-        // Verifica se passaram 300ms 
-        if (contador_telemetria >= 30) { 
-            
-            // Envia os dados de telemetria via UART
-            UART_EnviaDados();
+        if (canal_enviado == CANAL_GERAL) { 
+            PERFIL_INICIO(PERFIL_MATRIZ);
             
             // Mapeamento de Dados: Unifica vetores de subida/descida para visualizao nica na Matriz
             for(int i=0; i<4; i++) {
@@ -216,11 +253,19 @@ void main(void) {
             
             // Atualiza o display da Matriz de LEDs
             //MatrizLed();
-            
-            // Reinicia o contador de tempo
-            contador_telemetria = 0; 
+            PERFIL_FIM(PERFIL_MATRIZ);
         }
 
-        __delay_ms(10);
+#if GRAVACAO_HABILITADA
+        // Depurao: escoa os registros de entrada do ciclo (inclusive os das interrupes)
+        UART_EnviaGravacao();
+#endif
+
+        // E. FIM DO CICLO (10 ms)
+        // No mximo uma escrita pendente na EEPROM (~4 ms) por ciclo
+        MEMORIA_Processa();
+
+        // Estacionado, dorme no lugar do atraso (s com SONO_HABILITADO)
+        SONO_Espera();
     }
 }
\ No newline at end of file
@@ -48,12 +48,12 @@
 
 // CONFIG1
 #pragma config FOSC = INTOSC    // Oscillator Selection->INTOSC oscillator: I/O function on CLKIN pin
-#pragma config WDTE = OFF    // Watchdog Timer Enable->WDT disabled
+#pragma config WDTE = SWDTEN    // Watchdog Timer Enable->WDT controlled by the SWDTEN bit in the WDTCON register
 #pragma config PWRTE = OFF    // Power-up Timer Enable->PWRT disabled
 #pragma config MCLRE = ON    // MCLR Pin Function Select->MCLR/VPP pin function is MCLR
 #pragma config CP = OFF    // Flash Program Memory Code Protection->Program memory code protection is disabled
 #pragma config CPD = OFF    // Data Memory Code Protection->Data memory code protection is disabled
-#pragma config BOREN = ON    // Brown-out Reset Enable->Brown-out Reset enabled
+#pragma config BOREN = NSLEEP    // Brown-out Reset Enable->Brown-out Reset enabled while running and disabled in Sleep
 #pragma config CLKOUTEN = OFF    // Clock Out Enable->CLKOUT function is disabled. I/O or oscillator function on the CLKOUT pin
 #pragma config IESO = ON    // Internal/External Switchover->Internal/External Switchover mode is enabled
 #pragma config FCMEN = ON    // Fail-Safe Clock Monitor Enable->Fail-Safe Clock Monitor is enabled
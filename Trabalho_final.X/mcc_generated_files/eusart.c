@@ -54,7 +54,7 @@
 */
 
 #define EUSART_TX_BUFFER_SIZE 8
-#define EUSART_RX_BUFFER_SIZE 8
+#define EUSART_RX_BUFFER_SIZE 32
 
 /**
   Section: Global Variables
@@ -48,9 +48,16 @@
 
 #include "interrupt_manager.h"
 #include "mcc.h"
+#include "../perfil.h"
 
+/*
+  PERFIL_IRQ_*: medio opcional por fonte (PERFIL_INTERRUPCOES, ver perfil.h).
+  Sem a opo as macros no geram cdigo. Reinserir aps regenerar no MCC.
+  Latncia dos timers: TMR2 conta 1 ciclo por passo; TMR4, 64 (prescaler 1:64).
+*/
 void __interrupt() INTERRUPT_InterruptManager (void)
 {
+    PERFIL_IRQ_ENTRADA();
     // interrupt handler
     if(INTCONbits.IOCIE == 1 && INTCONbits.IOCIF == 1)
     {
@@ -61,26 +68,34 @@ void __interrupt() INTERRUPT_InterruptManager (void)
         if(PIE1bits.TXIE == 1 && PIR1bits.TXIF == 1)
         {
             EUSART_TxDefaultInterruptHandler();
+            PERFIL_IRQ_SAIDA(IRQ_TX);
         } 
         else if(PIE1bits.RCIE == 1 && PIR1bits.RCIF == 1)
         {
             EUSART_RxDefaultInterruptHandler();
+            PERFIL_IRQ_SAIDA(IRQ_RX);
         } 
         else if(PIE2bits.C2IE == 1 && PIR2bits.C2IF == 1)
         {
             CMP2_ISR();
+            PERFIL_IRQ_SAIDA(IRQ_CMP2);
         } 
         else if(PIE2bits.C1IE == 1 && PIR2bits.C1IF == 1)
         {
             CMP1_ISR();
+            PERFIL_IRQ_SAIDA(IRQ_CMP1);
         } 
         else if(PIE3bits.TMR4IE == 1 && PIR3bits.TMR4IF == 1)
         {
+            PERFIL_IRQ_LATENCIA(IRQ_TMR4, (uint16_t)TMR4 << 6);
             TMR4_ISR();
+            PERFIL_IRQ_SAIDA(IRQ_TMR4);
         } 
         else if(PIE1bits.TMR2IE == 1 && PIR1bits.TMR2IF == 1)
         {
+            PERFIL_IRQ_LATENCIA(IRQ_TMR2, TMR2);
             TMR2_ISR();
+            PERFIL_IRQ_SAIDA(IRQ_TMR2);
         } 
         else
         {
@@ -63,6 +63,7 @@
 #include "pwm3.h"
 #include "adc.h"
 #include "eusart.h"
+#include "memory.h"
 
 
 
@@ -0,0 +1,129 @@
+/**
+  MEMORY Generated Driver API Header File
+
+  @Company
+    Microchip Technology Inc.
+
+  @File Name
+    memory.h
+
+  @Summary
+    This is the generated header file for the MEMORY driver using PIC10 / PIC12 / PIC16 / PIC18 MCUs
+
+  @Description
+    This header file provides APIs for driver for MEMORY.
+    Generation Information :
+        Product Revision  :  PIC10 / PIC12 / PIC16 / PIC18 MCUs - 1.81.8
+        Device            :  PIC16F1827
+        Driver Version    :  2.01
+    The generated drivers are tested against the following:
+        Compiler          :  XC8 2.36 and above
+        MPLAB 	          :  MPLAB X 6.00
+*/
+
+/*
+    (c) 2018 Microchip Technology Inc. and its subsidiaries. 
+    
+    Subject to your compliance with these terms, you may use Microchip software and any 
+    derivatives exclusively with Microchip products. It is your responsibility to comply with third party 
+    license terms applicable to your use of third party software (including open source software) that 
+    may accompany Microchip software.
+    
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER 
+    EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY 
+    IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS 
+    FOR A PARTICULAR PURPOSE.
+    
+    IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+    WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP 
+    HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO 
+    THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL 
+    CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT 
+    OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS 
+    SOFTWARE.
+*/
+
+#ifndef MEMORY_H
+#define MEMORY_H
+
+/**
+  Section: Included Files
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+
+/**
+  Section: Data EEPROM Module APIs
+*/
+
+/**
+  @Summary
+    Writes a data byte to Data EEPROM
+
+  @Description
+    This routine writes a data byte to given Data EEPROM location
+
+  @Preconditions
+    None
+
+  @Param
+    bAdd  - Data EEPROM location to which data to be written
+    bData - Data to be written to Data EEPROM location
+
+  @Returns
+    None
+
+  @Example
+    <code>
+    uint8_t dataeeAddr = 0x10;
+    uint8_t dataeeData = 0x55;
+
+    DATAEE_WriteByte(dataeeAddr, dataeeData);
+    </code>
+*/
+void DATAEE_WriteByte(uint8_t bAdd, uint8_t bData);
+
+/**
+  @Summary
+    Reads a data byte from Data EEPROM
+
+  @Description
+    This routine reads a data byte from given Data EEPROM location
+
+  @Preconditions
+    None
+
+  @Param
+    bAdd  - Data EEPROM location from which data has to be read
+
+  @Returns
+    Data byte read from given Data EEPROM location
+
+  @Example
+    <code>
+    uint8_t dataeeAddr = 0x10;
+    uint8_t readData;
+
+    readData = DATAEE_ReadByte(dataeeAddr);
+    </code>
+*/
+uint8_t DATAEE_ReadByte(uint8_t bAdd);
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    }
+
+#endif
+
+#endif // MEMORY_H
+/**
+ End of File
+*/
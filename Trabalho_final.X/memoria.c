@@ -0,0 +1,343 @@
+/**
+ * @file memoria.c
+ * @brief Persistncia da posio da cabine na EEPROM de dados.
+ * @details O PIC16F1827 no avisa a queda de tenso antes do reset do BOR
+ * (no h interrupo de brown-out), ento no  possvel gravar na falta de
+ * energia. Em vez disso a posio  gravada em toda parada, quando ela 
+ * exata, e o marcador de parada limpa  trocado pelo sentido da partida
+ * quando o motor liga: um reset com o sentido no marcador indica queda de
+ * energia em movimento e para onde a cabine ia.
+ *
+ * Os registros formam um anel de 8 posies na EEPROM; cada parada usa a
+ * posio seguinte, dividindo o desgaste (100 mil escritas por byte) entre
+ * elas. O registro mais recente  o de maior sequncia.
+ *
+ * Cada escrita prende o loop principal por ~4 ms. O registro de parada no 
+ * gravado de uma vez (~24 ms, mais do que o anel de 32 bytes da RX suporta a
+ * 19200 bps): MEMORIA_SalvaParada() s o prepara e MEMORIA_Processa() grava
+ * um byte por ciclo, com a verificao por ltimo. O mapa do poo (16 bytes,
+ * ~64 ms) segue pelo mesmo caminho, depois do registro de parada.
+ */
+
+#include "memoria.h"
+#include "globals.h"
+#include "motor.h"
+#include "mcc_generated_files/mcc.h"
+
+
+// CONSTANTES E DEFINIES
+
+/**
+ * @brief Anel de registros: 8 posies de 8 bytes a partir do endereo 0x00.
+ * @note ANEL_TAMANHO deve ser potncia de 2.
+ */
+#define ANEL_INICIO       0x00
+#define ANEL_TAMANHO      8
+#define REGISTRO_BYTES    8
+
+/**
+ * @brief Deslocamento de cada campo dentro do registro.
+ * - SEQUENCIA:   Contador de gravaes (8 bits, com retorno a 0).
+ * - ANDAR:       Andar da parada (0 a 3).
+ * - PULSOS_L/H:  Contador de pulsos do encoder.
+ * - VERIFICACAO: Complemento da soma dos quatro campos anteriores.
+ * - MARCADOR:    #MARCADOR_LIMPO enquanto a cabine no partir de novo.
+ */
+#define CAMPO_SEQUENCIA   0
+#define CAMPO_ANDAR       1
+#define CAMPO_PULSOS_L    2
+#define CAMPO_PULSOS_H    3
+#define CAMPO_VERIFICACAO 4
+#define CAMPO_MARCADOR    5
+
+/**
+ * @brief Campos gravados por registro, na ordem de #ORDEM_GRAVACAO.
+ * - ORDEM_MARCADOR: Posio do marcador nessa ordem (antes da verificao).
+ */
+#define CAMPOS_GRAVADOS   6
+#define ORDEM_MARCADOR    4
+
+/**
+ * @brief Mapa do poo (calibrao "$CA"): 16 bytes a partir de 0x40, logo aps o anel.
+ * - ANDAR:       Pulsos de cada andar (bytes 0 a 3).
+ * - BORDA:       Bordas inferior e superior de cada m (bytes 4 a 11).
+ * - MICRONS_L/H: Escala do encoder em m por pulso.
+ * - HISTERESE:   Histerese das bordas dos ms em pulsos.
+ * - VERIFICACAO: Complemento da soma dos bytes anteriores.
+ */
+#define MAPA_INICIO       0x40
+#define MAPA_ANDAR        0
+#define MAPA_BORDA        4
+#define MAPA_MICRONS_L    12
+#define MAPA_MICRONS_H    13
+#define MAPA_HISTERESE    14
+#define MAPA_VERIFICACAO  15
+#define MAPA_BYTES        16
+
+/**
+ * @brief Valor do marcador de desligamento limpo.
+ * @note Com o motor em movimento o marcador guarda o sentido da partida
+ * (#MOTOR_SUBINDO ou #MOTOR_DESCENDO), usado para orientar a busca de referncia.
+ */
+#define MARCADOR_LIMPO    0x5A
+
+/**
+ * @brief Retorno de MEMORIA_SensorAtivo() com a cabine fora dos sensores.
+ */
+#define SEM_SENSOR        0xFF
+
+
+// VARIVEIS INTERNAS
+
+/**
+ * @brief Contedo de um registro do anel.
+ */
+typedef struct {
+    uint8_t sequencia;
+    uint8_t andar;
+    uint16_t pulsos;
+    uint8_t marcador;
+} RegistroPosicao;
+
+/**
+ * @brief Posio do anel com o registro mais recente e sua sequncia.
+ * @note Sem registro vlido a prxima gravao vai para a posio 0 com sequncia 0.
+ */
+static uint8_t registro_atual = ANEL_TAMANHO - 1;
+static uint8_t sequencia = 0xFF;
+
+/**
+ * @brief Sentido do movimento interrompido pelo reset (#MOTOR_PARADO se desconhecido).
+ */
+static uint8_t sentido_interrompido = MOTOR_PARADO;
+
+/**
+ * @brief Registro de parada aguardando gravao (ver MEMORIA_Processa()).
+ * - registro_pendente: Valor de cada campo, indexado por CAMPO_*.
+ * - gravados:          Campos j gravados; #CAMPOS_GRAVADOS = nada pendente.
+ */
+static uint8_t registro_pendente[REGISTRO_BYTES];
+static uint8_t gravados = CAMPOS_GRAVADOS;
+
+/**
+ * @brief Mapa do poo aguardando gravao (ver MEMORIA_Processa()).
+ * - mapa_pendente: Bytes do mapa na ordem da EEPROM, verificao por ltimo.
+ * - mapa_gravados: Bytes j gravados; #MAPA_BYTES = nada pendente.
+ */
+static uint8_t mapa_pendente[MAPA_BYTES];
+static uint8_t mapa_gravados = MAPA_BYTES;
+
+
+// TABELAS
+
+/**
+ * @brief Ordem de gravao dos campos de um registro.
+ * @note A verificao vai por ltimo: um registro interrompido pela queda de
+ * energia fica invlido e a restaurao usa o anterior. O marcador vem antes
+ * dela para que um registro vlido nunca traga o marcador de 8 paradas atrs.
+ */
+static const uint8_t ORDEM_GRAVACAO[CAMPOS_GRAVADOS] = {
+    CAMPO_SEQUENCIA, CAMPO_ANDAR, CAMPO_PULSOS_L, CAMPO_PULSOS_H,
+    CAMPO_MARCADOR, CAMPO_VERIFICACAO
+};
+
+
+// FUNES AUXILIARES
+
+/**
+ * @brief Endereo na EEPROM de um campo de um registro.
+ */
+static uint8_t MEMORIA_Endereco(uint8_t registro, uint8_t campo){
+    return (uint8_t)(ANEL_INICIO + registro * REGISTRO_BYTES + campo);
+}
+
+/**
+ * @brief Grava um byte somente se ele mudou.
+ * @return true se houve escrita.
+ * @note Cada escrita leva ~4 ms e consome um ciclo de vida da clula.
+ */
+static bool MEMORIA_Grava(uint8_t endereco, uint8_t valor){
+    if(DATAEE_ReadByte(endereco) == valor) return false;
+    DATAEE_WriteByte(endereco, valor);
+    return true;
+}
+
+/**
+ * @brief Byte de verificao de um registro.
+ * @note O complemento faz uma EEPROM apagada (0xFF em tudo) ser invlida.
+ */
+static uint8_t MEMORIA_Verificacao(uint8_t seq, uint8_t andar, uint16_t pulsos){
+    return (uint8_t)~(uint8_t)(seq + andar + (uint8_t)pulsos + (uint8_t)(pulsos >> 8));
+}
+
+/**
+ * @brief L um registro do anel.
+ * @return false se o registro estiver corrompido ou nunca tiver sido gravado.
+ */
+static bool MEMORIA_Le(uint8_t registro, RegistroPosicao* r){
+    r->sequencia = DATAEE_ReadByte(MEMORIA_Endereco(registro, CAMPO_SEQUENCIA));
+    r->andar     = DATAEE_ReadByte(MEMORIA_Endereco(registro, CAMPO_ANDAR));
+    r->pulsos    = DATAEE_ReadByte(MEMORIA_Endereco(registro, CAMPO_PULSOS_L))
+                 | ((uint16_t)DATAEE_ReadByte(MEMORIA_Endereco(registro, CAMPO_PULSOS_H)) << 8);
+    r->marcador  = DATAEE_ReadByte(MEMORIA_Endereco(registro, CAMPO_MARCADOR));
+
+    if(r->andar > 3) return false;
+    return DATAEE_ReadByte(MEMORIA_Endereco(registro, CAMPO_VERIFICACAO))
+        == MEMORIA_Verificacao(r->sequencia, r->andar, r->pulsos);
+}
+
+/**
+ * @brief L o mapa do poo gravado pela calibrao.
+ * @return false se a EEPROM no tiver um mapa vlido.
+ */
+static bool MEMORIA_LeMapa(MapaPoco* m){
+    uint8_t bytes[MAPA_VERIFICACAO];
+    uint8_t soma = 0;
+
+    for(uint8_t i = 0; i < MAPA_VERIFICACAO; i++){
+        bytes[i] = DATAEE_ReadByte(MAPA_INICIO + i);
+        soma += bytes[i];
+    }
+    soma = (uint8_t)~soma;
+    if(DATAEE_ReadByte(MAPA_INICIO + MAPA_VERIFICACAO) != soma) return false;
+
+    for(uint8_t a = 0; a < 4; a++){
+        m->andar[a] = bytes[MAPA_ANDAR + a];
+        m->borda[a][0] = bytes[MAPA_BORDA + 2 * a];
+        m->borda[a][1] = bytes[MAPA_BORDA + 2 * a + 1];
+    }
+    m->microns   = bytes[MAPA_MICRONS_L] | ((uint16_t)bytes[MAPA_MICRONS_H] << 8);
+    m->histerese = bytes[MAPA_HISTERESE];
+    m->situacao  = MAPA_CALIBRADO;
+    return true;
+}
+
+/**
+ * @brief Andar cujo sensor est ativo no momento.
+ * @return 0 a 3, ou #SEM_SENSOR com a cabine entre andares.
+ */
+static uint8_t MEMORIA_SensorAtivo(void){
+    if(SENSOR_S4 == 1) return 3;
+    if(SENSOR_S3 == 1) return 2;
+    if(SENSOR_S2 == 0) return 1;
+    if(SENSOR_S1 == 0) return 0;
+    return SEM_SENSOR;
+}
+
+
+// FUNES DE PERSISTNCIA
+
+void MEMORIA_Restaura(void){
+    RegistroPosicao r;
+    RegistroPosicao ultimo = {0, 0, 0, 0};
+    MapaPoco mapa;
+    bool achou = false;
+
+    // 1. Mapa do poo da ltima calibrao (sem ele vale o nominal)
+    if(MEMORIA_LeMapa(&mapa)) SENSORES_DefineMapa(&mapa);
+
+    // 2. Registro mais recente do anel (maior sequncia em aritmtica de 8 bits)
+    for(uint8_t i = 0; i < ANEL_TAMANHO; i++){
+        if(!MEMORIA_Le(i, &r)) continue;
+        if(!achou || (int8_t)(r.sequencia - ultimo.sequencia) > 0){
+            ultimo = r;
+            registro_atual = i;
+            achou = true;
+        }
+    }
+    if(achou){
+        sequencia = ultimo.sequencia;
+        if(ultimo.marcador == MOTOR_SUBINDO || ultimo.marcador == MOTOR_DESCENDO){
+            sentido_interrompido = ultimo.marcador;
+        }
+    }
+
+    // 3. Validao com os sensores de andar
+    uint8_t sensor = MEMORIA_SensorAtivo();
+
+    if(achou && ultimo.marcador == MARCADOR_LIMPO
+            && (sensor == SEM_SENSOR || sensor == ultimo.andar)){
+        // Parada limpa e coerente com os sensores: posio exata
+        andar_atual = ultimo.andar;
+        SENSORES_DefinePulsos(ultimo.pulsos);
+        origem_posicao = POSICAO_MEMORIA;
+    }
+    else if(sensor != SEM_SENSOR){
+        // Queda em movimento, registro invlido ou cabine movida: confia no sensor
+        andar_atual = sensor;
+        SENSORES_DefinePulsos(mapa_poco.andar[sensor]);
+        origem_posicao = POSICAO_SENSOR;
+    }
+    else {
+        // Entre andares e sem parada limpa: posio desconhecida at cruzar um sensor
+        origem_posicao = POSICAO_DESCONHECIDA;
+    }
+}
+
+void MEMORIA_SalvaParada(void){
+    // Sem referncia no h o que gravar como parada limpa
+    if(origem_posicao == POSICAO_DESCONHECIDA) return;
+
+    // Um registro anterior ainda incompleto fica invlido e  abandonado
+    uint16_t pulsos = SENSORES_LePulsos();
+    uint8_t andar = andar_atual;
+
+    registro_atual = (registro_atual + 1) & (ANEL_TAMANHO - 1);
+    sequencia++;
+
+    registro_pendente[CAMPO_SEQUENCIA]   = sequencia;
+    registro_pendente[CAMPO_ANDAR]       = andar;
+    registro_pendente[CAMPO_PULSOS_L]    = (uint8_t)pulsos;
+    registro_pendente[CAMPO_PULSOS_H]    = (uint8_t)(pulsos >> 8);
+    registro_pendente[CAMPO_VERIFICACAO] = MEMORIA_Verificacao(sequencia, andar, pulsos);
+    registro_pendente[CAMPO_MARCADOR]    = MARCADOR_LIMPO;
+    gravados = 0;
+}
+
+void MEMORIA_Processa(void){
+    // Bytes que no mudaram no custam escrita: segue at a primeira gravao real
+    while(gravados < CAMPOS_GRAVADOS){
+        uint8_t campo = ORDEM_GRAVACAO[gravados++];
+        if(MEMORIA_Grava(MEMORIA_Endereco(registro_atual, campo), registro_pendente[campo])) return;
+    }
+
+    // Mapa do poo, depois do registro de parada
+    while(mapa_gravados < MAPA_BYTES){
+        uint8_t i = mapa_gravados++;
+        if(MEMORIA_Grava(MAPA_INICIO + i, mapa_pendente[i])) return;
+    }
+}
+
+bool MEMORIA_Ociosa(void){
+    return gravados >= CAMPOS_GRAVADOS && mapa_gravados >= MAPA_BYTES;
+}
+
+void MEMORIA_MarcaMovimento(uint8_t direcao){
+    // Registro de parada ainda na fila: o marcador sai nele com o sentido
+    registro_pendente[CAMPO_MARCADOR] = direcao;
+    if(gravados <= ORDEM_MARCADOR) return;
+
+    MEMORIA_Grava(MEMORIA_Endereco(registro_atual, CAMPO_MARCADOR), direcao);
+}
+
+uint8_t MEMORIA_SentidoInterrompido(void){
+    return sentido_interrompido;
+}
+
+void MEMORIA_SalvaMapa(const MapaPoco* m){
+    uint8_t soma = 0;
+
+    for(uint8_t a = 0; a < 4; a++){
+        mapa_pendente[MAPA_ANDAR + a] = m->andar[a];
+        mapa_pendente[MAPA_BORDA + 2 * a] = m->borda[a][0];
+        mapa_pendente[MAPA_BORDA + 2 * a + 1] = m->borda[a][1];
+    }
+    mapa_pendente[MAPA_MICRONS_L] = (uint8_t)m->microns;
+    mapa_pendente[MAPA_MICRONS_H] = (uint8_t)(m->microns >> 8);
+    mapa_pendente[MAPA_HISTERESE] = m->histerese;
+
+    // Verificao por ltimo, como nos registros de parada
+    for(uint8_t i = 0; i < MAPA_VERIFICACAO; i++) soma += mapa_pendente[i];
+    mapa_pendente[MAPA_VERIFICACAO] = (uint8_t)~soma;
+    mapa_gravados = 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file memoria.h
+ * @brief Persistncia da posio da cabine na EEPROM de dados.
+ * @details A cada parada o firmware grava o andar e o contador de pulsos do
+ * encoder com um marcador de desligamento limpo; ao partir, o marcador 
+ * trocado pelo sentido do movimento. No reset a posio  recuperada e conferida com os sensores de
+ * andar, de modo que a cabine volta ao servio sem precisar passar por um
+ * sensor para saber onde est.
+ */
+
+#ifndef MEMORIA_H
+#define MEMORIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "globals.h"
+
+
+/**
+ * @brief Recupera a posio da ltima parada e atualiza #origem_posicao.
+ * @details Antes carrega o mapa do poo gravado pela calibrao, se houver.
+ * Ordem de deciso:
+ * - Registro vlido, parada limpa e sensor ativo igual ao andar gravado
+ *   (ou nenhum sensor ativo): restaura andar e pulsos (#POSICAO_MEMORIA).
+ * - Algum sensor de andar ativo: assume esse andar com os pulsos do mapa
+ *   (#POSICAO_SENSOR).
+ * - Caso contrrio mantm andar 0 e posio 0 (#POSICAO_DESCONHECIDA).
+ * @note Chamar uma vez na inicializao, com os comparadores j configurados
+ * e antes de qualquer movimento.
+ */
+void MEMORIA_Restaura(void);
+
+/**
+ * @brief Prepara o registro da posio atual com o marcador de parada limpa.
+ * @note No grava nada: os bytes vo para a EEPROM em MEMORIA_Processa().
+ */
+void MEMORIA_SalvaParada(void);
+
+/**
+ * @brief Grava o prximo byte alterado do registro de parada ou do mapa pendente.
+ * @note Bloqueia ~4 ms quando h escrita (no mximo uma por chamada); chamar
+ * uma vez por ciclo no loop principal. O registro completo leva at 6 ciclos,
+ * o mapa at 16.
+ */
+void MEMORIA_Processa(void);
+
+/**
+ * @brief Verifica se no h gravao pendente na EEPROM.
+ * @return true - Registro de parada e mapa j gravados.
+ */
+bool MEMORIA_Ociosa(void);
+
+/**
+ * @brief Troca o marcador de parada limpa do ltimo registro pelo sentido da partida.
+ * @details Se o registro da parada ainda estiver pendente, o sentido vai no
+ * marcador dele; seno o marcador  gravado na hora.
+ * @param direcao #MOTOR_SUBINDO ou #MOTOR_DESCENDO.
+ * @note Bloqueia ~4 ms; chamar depois de ligar o PWM, para no atrasar a partida.
+ */
+void MEMORIA_MarcaMovimento(uint8_t direcao);
+
+/**
+ * @brief Sentido em que a cabine se movia quando a energia caiu.
+ * @return #MOTOR_SUBINDO, #MOTOR_DESCENDO ou #MOTOR_PARADO (parada limpa ou sem registro).
+ * @note Vlido aps MEMORIA_Restaura().
+ */
+uint8_t MEMORIA_SentidoInterrompido(void);
+
+/**
+ * @brief Prepara a gravao do mapa do poo medido pela calibrao (endereos 0x40-0x4F).
+ * @note No grava nada: os bytes vo para a EEPROM em MEMORIA_Processa(), um
+ * por ciclo, com a verificao por ltimo.
+ */
+void MEMORIA_SalvaMapa(const MapaPoco* m);
+
+#endif	/* MEMORIA_H */
@@ -7,6 +7,9 @@
 
 #include "motor.h"
 #include "globals.h"                
+#include "perfil.h"
+#include "gravacao.h"
+#include "memoria.h"
 #include "mcc_generated_files/mcc.h" 
 #include "mcc_generated_files/pwm3.h"
 
@@ -15,9 +18,10 @@
 // CONSTANTES E DEFINIES
 
 /** 
- * @brief Limite mximo de pulsos (segurana de software). 
+ * @brief Folga acima do 3 andar no limite de pulsos (segurana de software). 
+ * @note Com o mapa nominal o limite  216 + 4 = 220 pulsos.
  */
-#define MAX_PULSOS_TOPO   220
+#define FOLGA_TOPO        4
 
 /** 
  * @brief Posio fsica mxima em milmetros. 
@@ -25,23 +29,111 @@
 #define POSICAO_MAX_MM    180
 
 /** 
- * @brief Fator de converso: 0.837 mm/pulso * 1000 = 837. 
+ * @brief Perodo de execuo da tarefa de sensores (ms). 
  */
-#define MICRONS_POR_PULSO 837 
+#define TEMPO_TMR4_MS     100  
 
 /** 
- * @brief Perodo de execuo da tarefa de sensores (ms). 
+ * @brief Perodo da interrupo do TMR2 (s): 256 contagens * 0,5 s * ps-escala 4. 
  */
-#define TEMPO_TMR4_MS     100  
+#define TEMPO_TMR2_US     512
+
+/**
+ * @brief Limites do primeiro trecho da busca de referncia (o segundo usa o dobro).
+ * - PULSOS:  1,25 andar; h sempre um sensor a no mximo um andar de distncia.
+ * - TEMPO:   Segurana contra falha do encoder (1,25 andar a ~14 mm/s leva ~5,4 s).
+ */
+#define BUSCA_PULSOS      90
+#define BUSCA_TEMPO_MS    8000
+
+/**
+ * @brief Estimador alfa-beta da posio.
+ * - FRACAO_BITS: A posio  mantida em 1/16 de pulso.
+ * - ALFA:        Frao do resduo aplicada  posio em cada borda (12/16).
+ * - BETA:        Frao do resduo por pulso percorrido somada  taxa de deriva (4/16).
+ * - BASE_MIN:    Percurso mnimo desde a ancoragem anterior para atualizar a taxa;
+ *                abaixo disso (ex.: as duas bordas do mesmo m) a taxa seria rudo.
+ * - DERIVA_MAX:  Limite da taxa de deriva, em 1/4096 por pulso (1/8).
+ */
+#define FRACAO_BITS       4
+#define ESTIMADOR_ALFA    12
+#define ESTIMADOR_BETA    4
+#define ESTIMADOR_BASE    24
+#define DERIVA_MAX        512
+
+/**
+ * @brief Parmetros da calibrao do poo.
+ * - TEMPO:       Limite de cada trecho (o poo inteiro a ~14 mm/s leva ~13 s).
+ * - FECHAMENTO:  Diferena mxima, em pulsos, entre o repouso em S1 no incio e no fim.
+ * - MICRONS_MIN/MAX: Faixa aceita para a escala medida (nominal #MICRONS_POR_PULSO).
+ */
+#define CALIB_TEMPO_MS    20000
+#define CALIB_FECHAMENTO  4
+#define CALIB_MICRONS_MIN 600
+#define CALIB_MICRONS_MAX 1100
+
+/**
+ * @brief Fases da calibrao.
+ */
+#define CALIB_PROCURA_S1  0   // Desce at o fim de curso S1
+#define CALIB_SUBIDA      1   // Sobe de S1 a S4 registrando as bordas dos ms
+#define CALIB_DESCIDA     2   // Desce de S4 a S1 registrando as bordas dos ms
+
+/**
+ * @brief Tempos de porta aberta (ciclos de 10 ms).
+ * - EMBARQUE:    Parada com passageiro embarcando (2 s).
+ * - DESEMBARQUE: Parada apenas para desembarque (1 s).
+ * - EXTRA:       Acrscimo em andares de grande movimento (+1 s).
+ * - FILA:        Reduo quando h chamadas aguardando em outros andares (-0,5 s).
+ * - MINIMO:      Limite inferior de segurana (0,8 s).
+ */
+#define PORTA_EMBARQUE    200
+#define PORTA_DESEMBARQUE 100
+#define PORTA_EXTRA       100
+#define PORTA_FILA        50
+#define PORTA_MINIMO      80
+
+/**
+ * @brief Incremento de demanda por pedido e limiar de andar movimentado.
+ */
+#define DEMANDA_PASSO     4
+#define DEMANDA_ALTA      16
 
 
 // VARIVEIS INTERNAS 
 
 /**
- * @brief Contador acumulativo de pulsos do encoder.
- * Utilizado para o clculo de posio absoluta.
+ * @brief Posio estimada em 1/16 de pulso desde o trreo.
+ * @details Avanada pelo encoder na interrupo do TMR4 (predio) e corrigida
+ * nas bordas dos sensores de andar por SENSORES_Ancora() (atualizao).
  */
-static uint16_t total_pulsos = 0;            
+static uint16_t posicao_fina = 0;            
+
+/**
+ * @brief Trava lgica de #posicao_fina: 3 andar do mapa + #FOLGA_TOPO, em 1/16 de pulso.
+ */
+static uint16_t limite_fino = (3 * PULSOS_POR_ANDAR + FOLGA_TOPO) << FRACAO_BITS;
+
+/**
+ * @brief Taxa de deriva aprendida: pulsos no contados por pulso contado, em 1/4096.
+ * @note Positiva quando o encoder perde pulsos (escorregamento); lida na interrupo do TMR4.
+ */
+static int16_t taxa_deriva = 0;
+
+/**
+ * @brief Pulsos contados desde a ltima ancoragem (base da taxa de deriva).
+ */
+static uint16_t pulsos_desde_ancora = 0;
+
+/**
+ * @brief Mscara dos sensores de andar no ciclo anterior, para detectar as bordas.
+ */
+static uint8_t sensores_anteriores = 0;
+
+/**
+ * @brief Estatsticas das ancoragens (consulta "$?D").
+ */
+static EstatisticaDeriva deriva = {0, 0, 0};
 
 /**
  * @brief Armazena o valor anterior do TMR0.
@@ -49,18 +141,127 @@ static uint16_t total_pulsos = 0;
  */
 static uint8_t ultimo_valor_timer0 = 0;
 
+/**
+ * @brief Frao de milissegundo acumulada pelas interrupes do TMR2 (s).
+ */
+static uint16_t acumulador_us = 0;
+
+/**
+ * @brief Referncias das decises de parada (ver Cabine_No_Andar()).
+ * - andar_partida:  Andar de onde partiu o movimento atual.
+ * - entrada_timer0: TMR0 na ltima ativao de um sensor de andar.
+ */
+static uint8_t andar_partida = 0;
+static uint8_t entrada_timer0 = 0;
+
+/**
+ * @brief Estado da busca de referncia.
+ * - sentido: Sentido do trecho atual.
+ * - trecho:  0 = primeiro sentido, 1 = sentido invertido.
+ * - pulsos:  Pulsos do encoder percorridos no trecho.
+ * - timer0:  ltima leitura do TMR0.
+ * - inicio:  Instante de incio do trecho (ms).
+ */
+static uint8_t busca_sentido = MOTOR_DESCENDO;
+static uint8_t busca_trecho = 0;
+static uint16_t busca_pulsos = 0;
+static uint8_t busca_timer0 = 0;
+static uint16_t busca_inicio_ms = 0;
+
+/**
+ * @brief Estado da calibrao do poo.
+ * - fase:     #CALIB_PROCURA_S1, #CALIB_SUBIDA ou #CALIB_DESCIDA.
+ * - pulsos:   Pulsos desde o repouso em S1, com sinal (lidos direto do TMR0).
+ * - topo:     Pulsos no repouso em S4, fim da subida.
+ * - sensores: Mscara dos sensores ativos no ciclo anterior.
+ * - bordas:   Pulsos de cada borda [sentido][andar][0 = inferior, 1 = superior].
+ * @note As bordas cabem em 8 bits: o poo nominal tem ~216 pulsos.
+ */
+static uint8_t calib_fase;
+static int16_t calib_pulsos;
+static int16_t calib_topo;
+static uint8_t calib_timer0;
+static uint16_t calib_inicio_ms;
+static uint8_t calib_sensores;
+static uint8_t calib_bordas[2][4][2];
+
+
+// RELGIO DO SISTEMA
+
+/**
+ * @brief Incrementa o relgio de milissegundos a partir da interrupo do TMR2.
+ * @details A cada 512 s soma o perodo ao acumulador e avana #tempo_ms
+ * quando ele passa de 1000 s, sem erro acumulado a longo prazo.
+ */
+void RELOGIO_Tick(void){
+    PERFIL_INICIO(PERFIL_RELOGIO);
+    acumulador_us += TEMPO_TMR2_US;
+    if (acumulador_us >= 1000) {
+        acumulador_us -= 1000;
+        tempo_ms++;
+    }
+    PERFIL_FIM(PERFIL_RELOGIO);
+}
+
+/**
+ * @brief L o relgio de milissegundos de forma atmica.
+ * @note A leitura de 16 bits exige duas instrues no PIC; a interrupo do
+ * TMR2  suspensa para no ler um byte antes e outro depois do incremento.
+ * @return Tempo desde o reset em ms (volta a 0 a cada 65,5 s).
+ */
+uint16_t RELOGIO_Ms(void){
+    PIE1bits.TMR2IE = 0;
+    uint16_t agora = tempo_ms;
+    PIE1bits.TMR2IE = 1;
+    return agora;
+}
+
 
 // CLCULO DOS SENSORES
 
+/**
+ * @brief Converte a posio estimada para #posicao_mm.
+ * @details Frmula Otimizada: mm = (pulsos * m por pulso) / 1000, com a escala
+ * do mapa do poo (nominal 837) e a posio em 1/16 de pulso.
+ */
+static void SENSORES_ConverteMm(void){
+    //  utilizada uma varivel temporria de 32 bits para a multiplicao no estourar o limite de 16 bits
+    uint32_t calculo_posicao = (uint32_t)posicao_fina * mapa_poco.microns;
+    posicao_mm = (uint8_t)(calculo_posicao / (1000u << FRACAO_BITS)); // Guarda na varivel global (0-180mm)
+}
+
+/**
+ * @brief L a contagem do encoder no TMR0 (registrada na gravao de entradas).
+ */
+static uint8_t SENSORES_LeTimer0(void) {
+    uint8_t valor = TMR0_ReadTimer();
+    GRAVA(GRAVA_TIMER0, valor);
+    return valor;
+}
+
+/**
+ * @brief Mscara dos sensores de andar ativos (bit n = andar n).
+ */
+static uint8_t SENSORES_Mascara(void) {
+    uint8_t mascara = 0;
+    if (SENSOR_S1 == 0) mascara |= 0x01;
+    if (SENSOR_S2 == 0) mascara |= 0x02;
+    if (SENSOR_S3 == 1) mascara |= 0x04;
+    if (SENSOR_S4 == 1) mascara |= 0x08;
+    return mascara;
+}
+
 /**
  * @brief Realiza a telemetria do sistema (Velocidade, Posio e Temperatura).
  * @note Modifica as variveis globais: #posicao_mm, #velocidade_atual e #temperatura_ponte.
  */
 void SENSORES_CalcularVelocidade(void){
     
+    PERFIL_INICIO(PERFIL_VELOCIDADE);
+    
     // 1. LEITURA DO ENCODER
     // L o registrador TMR0 que conta os pulsos fsicos do disco do motor
-    uint8_t valor_atual = TMR0_ReadTimer();     
+    uint8_t valor_atual = SENSORES_LeTimer0();     
 
     // Calcula quantos pulsos aconteceram desde a ltima leitura
     uint8_t delta = valor_atual - ultimo_valor_timer0;
@@ -68,31 +269,33 @@ void SENSORES_CalcularVelocidade(void){
     // Salva o valor atual para a prxima conta
     ultimo_valor_timer0 = valor_atual;
 
-    // 2. ATUALIZAO DA POSIO 
-    if (estado_motor == MOTOR_SUBINDO) {
-        total_pulsos += delta; // Se estiver subindo, soma-se os pulsos
+    // 2. ATUALIZAO DA POSIO (predio do estimador)
+    // Os pulsos seguem o ltimo sentido comandado, inclusive na inrcia aps a
+    // parada, e recebem a correo da deriva aprendida nas bordas dos sensores
+    if (ultima_direcao != MOTOR_PARADO && delta) {
+        int16_t passo = ((int16_t)delta << FRACAO_BITS) + (int16_t)(((int32_t)delta * taxa_deriva) >> 8);
+        if (passo < 0) passo = 0;
+        if (pulsos_desde_ancora < 0xFFFF - 255) pulsos_desde_ancora += delta;
         
-        // Trava de segurana lgica
-        if(total_pulsos > MAX_PULSOS_TOPO) total_pulsos = MAX_PULSOS_TOPO; 
-    } 
-    
-    else if (estado_motor == MOTOR_DESCENDO) {
-        if(delta > total_pulsos) total_pulsos = 0;  // Proteo para no ficar negativo
-        else total_pulsos -= delta; // Se estiver descendo, subtraem-se os pulsos
+        if (ultima_direcao == MOTOR_SUBINDO) {
+            posicao_fina += (uint16_t)passo; // Se estiver subindo, soma-se os pulsos
+            
+            // Trava de segurana lgica
+            if(posicao_fina > limite_fino) posicao_fina = limite_fino; 
+        } 
+        else {
+            if((uint16_t)passo > posicao_fina) posicao_fina = 0;  // Proteo para no ficar negativo
+            else posicao_fina -= (uint16_t)passo; // Se estiver descendo, subtraem-se os pulsos
+        }
     }
     
     // 3. CONVERSO MATEMTICA 
-    // Converso dos pulsos para milmetros 
-    // Frmula Otimizada: mm = (pulsos * 837) / 1000
-    
-    //  utilizada uma varivel temporria de 32 bits para a multiplicao no estourar o limite de 16 bits
-    uint32_t calculo_posicao = (uint32_t)total_pulsos * MICRONS_POR_PULSO;
-    posicao_mm = (uint8_t)(calculo_posicao / 1000); // Guarda na varivel global (0-180mm)
+    SENSORES_ConverteMm();
 
     // 4. CLCULO DA VELOCIDADE
     // Velocidade = Distncia / Tempo
-    // Frmula utilizada: (delta * 837) / 100, velocidade em mm/s
-    uint32_t calculo_velocidade = (uint32_t)delta * MICRONS_POR_PULSO;
+    // Frmula utilizada: (delta * m por pulso) / 100, velocidade em mm/s
+    uint32_t calculo_velocidade = (uint32_t)delta * mapa_poco.microns;
     velocidade_atual = (uint8_t)(calculo_velocidade / 100);
     
     // 5. CLCULO DA TEMPERATURA
@@ -115,6 +318,117 @@ void SENSORES_CalcularVelocidade(void){
     // Como o Timer 4 j chama essa funo a cada 100ms, a leitura j  peridica.
     // Isso libera o processador para rodar o loop principal (main).
     temperatura_ponte = ADC_GetConversion(channel_AN2);
+    GRAVA(GRAVA_ADC, temperatura_ponte);
+    
+    PERFIL_FIM(PERFIL_VELOCIDADE);
+}
+
+
+/**
+ * @brief L #posicao_fina sem a interrupo do TMR4 no meio da leitura de 16 bits.
+ * @return Pulsos desde o trreo, arredondados.
+ */
+uint16_t SENSORES_LePulsos(void){
+    PIE3bits.TMR4IE = 0;
+    uint16_t pulsos = posicao_fina;
+    PIE3bits.TMR4IE = 1;
+    return (pulsos + (1 << (FRACAO_BITS - 1))) >> FRACAO_BITS;
+}
+
+/**
+ * @brief Redefine a posio absoluta a partir de um contador de pulsos conhecido.
+ * @note Atualiza #posicao_mm na hora, sem esperar a prxima amostra do TMR4.
+ */
+void SENSORES_DefinePulsos(uint16_t pulsos){
+    uint16_t fina = pulsos << FRACAO_BITS;
+    PIE3bits.TMR4IE = 0;
+    posicao_fina = (fina > limite_fino) ? limite_fino : fina;
+    pulsos_desde_ancora = 0;
+    SENSORES_ConverteMm();
+    PIE3bits.TMR4IE = 1;
+}
+
+/**
+ * @brief Troca o mapa do poo em uso e a trava lgica de pulsos.
+ * @note A cpia  feita sem a interrupo do TMR4, que l a escala do mapa.
+ */
+void SENSORES_DefineMapa(const MapaPoco* mapa){
+    PIE3bits.TMR4IE = 0;
+    mapa_poco = *mapa;
+    limite_fino = ((uint16_t)mapa->andar[3] + FOLGA_TOPO) << FRACAO_BITS;
+    PIE3bits.TMR4IE = 1;
+}
+
+/**
+ * @brief Corrige a posio estimada nas bordas dos sensores de andar (atualizao do estimador).
+ * @details A altura de cada borda vem do mapa do poo; neste sentido de
+ * movimento o sensor comuta deslocado de meia histerese. O resduo
+ * (altura da borda - estimativa)  aplicado  posio com ganho
+ * #ESTIMADOR_ALFA e, dividido pelo percurso desde a ancoragem anterior, 
+ * taxa de deriva com ganho #ESTIMADOR_BETA. Sem posio conhecida (busca de
+ * referncia) a borda fixa a posio diretamente.
+ * @param sensores Mscara atual dos sensores.
+ * @param mudou Bits que mudaram desde o ciclo anterior.
+ */
+static void SENSORES_Ancora(uint8_t sensores, uint8_t mudou){
+    bool subindo = (ultima_direcao == MOTOR_SUBINDO);
+    
+    for(uint8_t a = 0; a < 4; a++){
+        if(!(mudou & (1 << a))) continue;
+        
+        // Subindo, o sensor  ativado pela borda inferior e liberado pela superior
+        bool ativou = (sensores >> a) & 1;
+        uint8_t borda = mapa_poco.borda[a][(ativou == subindo) ? 0 : 1];
+        if(borda == BORDA_NULA) continue;
+        
+        int16_t esperado = (int16_t)borda << FRACAO_BITS;
+        int16_t meia_histerese = (int16_t)mapa_poco.histerese << (FRACAO_BITS - 1);
+        esperado += subindo ? meia_histerese : -meia_histerese;
+        
+        PIE3bits.TMR4IE = 0;
+        
+        // Estimativa neste instante: inclui os pulsos que o TMR4 ainda no somou
+        int16_t pendentes = (int16_t)(uint8_t)(SENSORES_LeTimer0() - ultimo_valor_timer0) << FRACAO_BITS;
+        int16_t estimado = (int16_t)posicao_fina + (subindo ? pendentes : -pendentes);
+        int16_t residuo = esperado - estimado;
+        int16_t nova;
+        
+        if(origem_posicao == POSICAO_DESCONHECIDA){
+            nova = (int16_t)posicao_fina + residuo;
+            origem_posicao = POSICAO_SENSOR;
+        }
+        else {
+            nova = (int16_t)posicao_fina + (int16_t)(((int32_t)residuo * ESTIMADOR_ALFA) >> 4);
+            
+            // Taxa no sentido do movimento, em 1/4096 por pulso: resduo (1/16) * 256 / pulsos
+            if(pulsos_desde_ancora >= ESTIMADOR_BASE){
+                int32_t correcao = (int32_t)(subindo ? residuo : -residuo) * (256 * ESTIMADOR_BETA / 16);
+                taxa_deriva += (int16_t)(correcao / (int16_t)pulsos_desde_ancora);
+                if(taxa_deriva > DERIVA_MAX) taxa_deriva = DERIVA_MAX;
+                if(taxa_deriva < -DERIVA_MAX) taxa_deriva = -DERIVA_MAX;
+            }
+            
+            if(deriva.ancoragens != 0xFFFF) deriva.ancoragens++;
+            deriva.ultimo = residuo;
+            uint16_t modulo = (residuo < 0) ? (uint16_t)-residuo : (uint16_t)residuo;
+            if(modulo > deriva.maior) deriva.maior = modulo;
+        }
+        
+        if(nova < 0) nova = 0;
+        posicao_fina = ((uint16_t)nova > limite_fino) ? limite_fino : (uint16_t)nova;
+        pulsos_desde_ancora = 0;
+        SENSORES_ConverteMm();
+        
+        PIE3bits.TMR4IE = 1;
+    }
+}
+
+/**
+ * @brief Copia as estatsticas das ancoragens e a taxa de deriva atual.
+ */
+void SENSORES_Deriva(EstatisticaDeriva* copia, int16_t* taxa){
+    *copia = deriva;
+    *taxa = taxa_deriva;
 }
 
 
@@ -124,30 +438,292 @@ void SENSORES_CalcularVelocidade(void){
 /**
  * @brief Envia comando para o motor subir.
  * @note Configura o PWM com duty cycle #MOTOR_ON e define #DIR como #DIRECAO_SUBIR.
+ * Partindo do repouso, troca em seguida o marcador de parada limpa na EEPROM
+ * (a escrita de ~4 ms no atrasa a partida).
  */
 void Controle_Subir() {
+    bool partindo = (estado_motor == MOTOR_PARADO);
+    if (partindo) andar_partida = andar_atual;
     DIR = DIRECAO_SUBIR;          // Atualiza a varivel DIR 
     PWM3_LoadDutyValue(MOTOR_ON); // Ativa o PWM
+    PERFIL_MARCA_PARTIDA();
     estado_motor = MOTOR_SUBINDO; // Atualiza o estado lgico
+    ultima_direcao = MOTOR_SUBINDO;
+    if (partindo) MEMORIA_MarcaMovimento(MOTOR_SUBINDO);
 }
 
 /**
  * @brief Envia comando para o motor descer.
  * @note Configura o PWM com duty cycle #MOTOR_ON e define #DIR como #DIRECAO_DESCER.
+ * Partindo do repouso, troca em seguida o marcador de parada limpa na EEPROM
+ * (a escrita de ~4 ms no atrasa a partida).
  */
 void Controle_Descer() {
+    bool partindo = (estado_motor == MOTOR_PARADO);
+    if (partindo) andar_partida = andar_atual;
     DIR = DIRECAO_DESCER;          // Atualiza a varivel DIR
     PWM3_LoadDutyValue(MOTOR_ON);  // Ativa o PWM
+    PERFIL_MARCA_PARTIDA();
     estado_motor = MOTOR_DESCENDO; // Atualiza o estado lgico
+    ultima_direcao = MOTOR_DESCENDO;
+    if (partindo) MEMORIA_MarcaMovimento(MOTOR_DESCENDO);
 }
 
 /**
  * @brief Para o motor imediatamente.
  * @note Zera o PWM (#MOTOR_OFF) e define estado como #MOTOR_PARADO.
+ * Se o motor estava em movimento, agenda a gravao da posio da parada na
+ * EEPROM (um byte por ciclo, em MEMORIA_Processa()).
  */
 void Controle_Parar() {
+    bool estava_movendo = (estado_motor != MOTOR_PARADO);
+    
     PWM3_LoadDutyValue(MOTOR_OFF); // Desativa o PWM
     estado_motor = MOTOR_PARADO;   // Atualiza o estado lgico
+    
+    if (estava_movendo) MEMORIA_SalvaParada();
+}
+
+
+// BUSCA DE REFERNCIA
+
+
+/**
+ * @brief Inicia um trecho da busca: zera a distncia percorrida e liga o motor devagar.
+ */
+static void Busca_Partir(uint8_t sentido) {
+    busca_pulsos = 0;
+    busca_timer0 = SENSORES_LeTimer0();
+    busca_inicio_ms = RELOGIO_Ms();
+    
+    if (sentido == MOTOR_SUBINDO) Controle_Subir();
+    else Controle_Descer();
+    PWM3_LoadDutyValue(MOTOR_BUSCA);
+}
+
+/**
+ * @brief Inicia a busca de referncia aps um reset sem posio confivel.
+ * @details A cabine parou fora de um sensor porque a energia caiu em movimento.
+ * O andar de onde ela partiu est no sentido oposto ao do movimento
+ * interrompido, a no mximo um andar de distncia se nenhum sensor foi
+ * cruzado; sem essa informao a busca desce, em direo ao fim de curso S1.
+ * @param sentido_interrompido Retorno de MEMORIA_SentidoInterrompido().
+ */
+void Controle_IniciarBusca(uint8_t sentido_interrompido) {
+    busca_sentido = (sentido_interrompido == MOTOR_DESCENDO) ? MOTOR_SUBINDO : MOTOR_DESCENDO;
+    busca_trecho = 0;
+    Busca_Partir(busca_sentido);
+}
+
+/**
+ * @brief Acompanha a busca de referncia; chamada a cada ciclo em #ESTADO_BUSCA.
+ * @details Verificar_Sensores() ancora a posio no primeiro sensor cruzado.
+ * Cada trecho  limitado pelos pulsos do encoder (#BUSCA_PULSOS por trecho,
+ * lidos direto do TMR0, pois #posicao_fina no tem referncia) e pelo tempo
+ * (#BUSCA_TEMPO_MS, caso o encoder falhe). Esgotado o primeiro trecho, a
+ * cabine para, confirma a parada e inverte com o dobro do limite.
+ * @return true Se a busca terminou (sensor encontrado ou os dois sentidos esgotados).
+ * @return false Se a busca continua.
+ */
+bool Controle_Buscar(void) {
+    
+    // 1. Sensor encontrado: posio j ancorada por Verificar_Sensores()
+    if (origem_posicao != POSICAO_DESCONHECIDA) {
+        if (estado_motor != MOTOR_PARADO) Controle_Parar();
+        return true;
+    }
+    
+    // 2. Parado entre os trechos: espera a confirmao do encoder para inverter
+    if (estado_motor == MOTOR_PARADO) {
+        if (ciclos_parado >= REVERSAO_CONFIRMA) {
+            busca_sentido = (busca_sentido == MOTOR_SUBINDO) ? MOTOR_DESCENDO : MOTOR_SUBINDO;
+            Busca_Partir(busca_sentido);
+        }
+        return false;
+    }
+    
+    // 3. Distncia percorrida no trecho (o TMR0 de 8 bits  lido a cada 10 ms)
+    uint8_t agora = SENSORES_LeTimer0();
+    busca_pulsos += (uint8_t)(agora - busca_timer0);
+    busca_timer0 = agora;
+    
+    uint8_t escala = busca_trecho + 1;
+    if (busca_pulsos > BUSCA_PULSOS * escala ||
+        (uint16_t)(RELOGIO_Ms() - busca_inicio_ms) > BUSCA_TEMPO_MS * escala) {
+        Controle_Parar();
+        // Nenhum sensor nos dois sentidos: falha de sensor ou de encoder
+        if (busca_trecho) return true;
+        busca_trecho = 1;
+    }
+    return false;
+}
+
+
+// CALIBRAO DO POO
+
+
+/**
+ * @brief Inicia uma fase da calibrao com o motor em velocidade reduzida.
+ */
+static void Calibracao_Partir(uint8_t fase) {
+    calib_fase = fase;
+    calib_inicio_ms = RELOGIO_Ms();
+    calib_sensores = SENSORES_Mascara();
+    
+    if (fase == CALIB_SUBIDA) Controle_Subir();
+    else Controle_Descer();
+    PWM3_LoadDutyValue(MOTOR_BUSCA);
+}
+
+/**
+ * @brief Deriva o mapa do poo das bordas registradas e o grava na EEPROM.
+ * @details Cada m intermedirio tem quatro bordas (inferior e superior,
+ * subindo e descendo); dos fins de curso s se v a borda voltada para o
+ * poo, pois a cabine para sobre eles.
+ * - Andares 1 e 2: mdia das quatro bordas, na qual a histerese se cancela.
+ * - Andares 0 e 3: repouso aps a parada de segurana, como no servio normal.
+ * - Histerese: mdia de (borda subindo - mesma borda descendo) nas seis bordas vistas.
+ * - Escala: os centros de S1 e S4 distam #POSICAO_MAX_MM; entre a borda superior
+ *   de S1 e a inferior de S4 falta uma largura de janela, medida em S2 e S3.
+ * @return false se faltar alguma borda ou o resultado for incoerente.
+ */
+static bool Calibracao_Calcula(void) {
+    uint8_t (*sobe)[2] = calib_bordas[0];
+    uint8_t (*desce)[2] = calib_bordas[1];
+    MapaPoco novo;
+    int16_t soma = 0;
+    
+    // 1. Bordas previstas e fechamento da volta (perda de pulsos no encoder)
+    for (uint8_t a = 0; a < 4; a++) {
+        for (uint8_t lado = 0; lado < 2; lado++) {
+            if ((a == 0 && lado == 0) || (a == 3 && lado == 1)) continue;
+            if (sobe[a][lado] == BORDA_NULA || desce[a][lado] == BORDA_NULA) return false;
+            soma += (int16_t)sobe[a][lado] - desce[a][lado];
+        }
+    }
+    if (calib_pulsos > CALIB_FECHAMENTO || calib_pulsos < -CALIB_FECHAMENTO) return false;
+    if (calib_topo <= 0 || calib_topo >= BORDA_NULA) return false;
+    
+    // 2. Posio dos andares
+    novo.andar[0] = 0;
+    for (uint8_t a = 1; a < 3; a++) {
+        novo.andar[a] = (uint8_t)(((uint16_t)sobe[a][0] + sobe[a][1] + desce[a][0] + desce[a][1] + 2) / 4);
+    }
+    novo.andar[3] = (uint8_t)calib_topo;
+    if (novo.andar[1] == 0 || novo.andar[2] <= novo.andar[1] || novo.andar[3] <= novo.andar[2]) return false;
+    
+    // 3. Bordas na mdia dos dois sentidos e histerese
+    for (uint8_t a = 0; a < 4; a++) {
+        for (uint8_t lado = 0; lado < 2; lado++) {
+            novo.borda[a][lado] = (sobe[a][lado] == BORDA_NULA || desce[a][lado] == BORDA_NULA) ? BORDA_NULA
+                                : (uint8_t)(((uint16_t)sobe[a][lado] + desce[a][lado] + 1) / 2);
+        }
+    }
+    novo.histerese = (soma > 0) ? (uint8_t)((soma + 3) / 6) : 0;
+    
+    // 4. Escala, em meios pulsos para no perder a frao das mdias:
+    //    janela2 = 2 * largura da janela (mdia de S2 e S3)
+    //    vao2    = 2 * (borda inferior de S4 - borda superior de S1 + largura)
+    int16_t janela2 = ((int16_t)sobe[1][1] + desce[1][1] - sobe[1][0] - desce[1][0]
+                     + sobe[2][1] + desce[2][1] - sobe[2][0] - desce[2][0]) / 2;
+    int16_t vao2 = (int16_t)sobe[3][0] + desce[3][0] - sobe[0][1] - desce[0][1] + janela2;
+    if (vao2 <= 0) return false;
+    
+    uint32_t microns = ((uint32_t)POSICAO_MAX_MM * 2000 + (uint16_t)vao2 / 2) / (uint16_t)vao2;
+    if (microns < CALIB_MICRONS_MIN || microns > CALIB_MICRONS_MAX) return false;
+    novo.microns = (uint16_t)microns;
+    novo.situacao = MAPA_CALIBRADO;
+    
+    // 5. Gravao (um byte por ciclo) e troca do mapa; a cabine est em repouso sobre S1
+    MEMORIA_SalvaMapa(&novo);
+    SENSORES_DefineMapa(&novo);
+    SENSORES_DefinePulsos(calib_pulsos > 0 ? (uint16_t)calib_pulsos : 0);
+    MEMORIA_SalvaParada();
+    return true;
+}
+
+/**
+ * @brief Inicia a calibrao do poo (comando "$CA").
+ * @details A cabine desce devagar at S1, sobe at S4 e volta a S1,
+ * registrando a contagem do encoder em cada borda dos sensores de andar.
+ * @return false se o elevador no estiver em repouso ou exigir a reverso de segurana.
+ */
+bool Controle_IniciarCalibracao(void) {
+    if (estado_atual != ESTADO_PARADO || Exige_Reversao(MOTOR_DESCENDO)) return false;
+    
+    uint8_t* borda = &calib_bordas[0][0][0];
+    for (uint8_t i = 0; i < sizeof(calib_bordas); i++) {
+        borda[i] = BORDA_NULA;
+    }
+    calib_pulsos = 0;
+    calib_timer0 = SENSORES_LeTimer0();
+    
+    Calibracao_Partir(CALIB_PROCURA_S1);
+    estado_atual = ESTADO_CALIBRACAO;
+    return true;
+}
+
+/**
+ * @brief Acompanha a calibrao; chamada a cada ciclo em #ESTADO_CALIBRACAO.
+ * @details Os fins de curso S1 e S4 param o motor em Verificar_Sensores();
+ * confirmada a parada pelo encoder, a calibrao passa  fase seguinte.
+ * As bordas so amostradas a cada ciclo de 10 ms, menos de 0,2 pulso na
+ * velocidade de #MOTOR_BUSCA.
+ * @return true Se a calibrao terminou; #mapa_poco.situacao indica o resultado.
+ * @return false Se a calibrao continua.
+ */
+bool Controle_Calibrar(void) {
+    
+    // 1. Pulsos desde o ltimo ciclo, com o sinal do ltimo sentido comandado
+    //    (inclui a inrcia depois da parada)
+    uint8_t agora = SENSORES_LeTimer0();
+    uint8_t delta = (uint8_t)(agora - calib_timer0);
+    calib_timer0 = agora;
+    if (ultima_direcao == MOTOR_SUBINDO) calib_pulsos += delta;
+    else calib_pulsos -= delta;
+    
+    // 2. Bordas dos ms: subindo, o sensor  ativado pela borda inferior e
+    //    liberado pela superior; descendo, o contrrio
+    if (calib_fase != CALIB_PROCURA_S1) {
+        uint8_t sensores = SENSORES_Mascara();
+        uint8_t mudou = sensores ^ calib_sensores;
+        uint8_t sentido = calib_fase - CALIB_SUBIDA;
+        
+        for (uint8_t a = 0; a < 4; a++) {
+            if (mudou & (1 << a)) {
+                bool ativou = (sensores >> a) & 1;
+                uint8_t lado = (ativou == (sentido == 0)) ? 0 : 1;
+                calib_bordas[sentido][a][lado] = (calib_pulsos < 0 || calib_pulsos >= BORDA_NULA)
+                                               ? BORDA_NULA : (uint8_t)calib_pulsos;
+            }
+        }
+        calib_sensores = sensores;
+    }
+    
+    // 3. Trecho longo demais: fim de curso ou encoder com defeito
+    if ((uint16_t)(RELOGIO_Ms() - calib_inicio_ms) > CALIB_TEMPO_MS) {
+        Controle_Parar();
+        mapa_poco.situacao = MAPA_FALHA;
+        return true;
+    }
+    
+    // 4. Aguarda a parada no fim de curso e a confirmao do encoder
+    if (estado_motor != MOTOR_PARADO || ciclos_parado < REVERSAO_CONFIRMA) return false;
+    
+    if (calib_fase == CALIB_PROCURA_S1) {
+        calib_pulsos = 0; // Referncia: repouso em S1
+        Calibracao_Partir(CALIB_SUBIDA);
+        return false;
+    }
+    if (calib_fase == CALIB_SUBIDA) {
+        calib_topo = calib_pulsos;
+        Calibracao_Partir(CALIB_DESCIDA);
+        return false;
+    }
+    
+    // 5. Volta completa: calcula o mapa
+    if (!Calibracao_Calcula()) mapa_poco.situacao = MAPA_FALHA;
+    return true;
 }
 
 
@@ -158,8 +734,10 @@ void Controle_Parar() {
  * @brief Verifica os sensores de fim de curso e de andar.
  * @details Realiza a leitura dos sensores S1, S2, S3 e S4
  * para atualizar a varivel global #andar_atual.
- * Tambm atua como segurana de hardware (Emergency Stop) caso o elevador
- * passe dos limites.
+ * Tambm ancora a posio estimada nas bordas dos sensores (SENSORES_Ancora()),
+ * atua como segurana de hardware (Emergency Stop) caso o elevador
+ * passe dos limites e atualiza a confirmao de parada #ciclos_parado.
+ * @note A posio nos fins de curso vem da borda de S1/S4, no de um valor fixo.
  */
 void Verificar_Sensores() {
     
@@ -170,19 +748,44 @@ void Verificar_Sensores() {
     // S3/S4: Analgicos (Comparador - Ativo em 1)
     if (SENSOR_S3 == 1) andar_atual = 2; 
     if (SENSOR_S4 == 1) andar_atual = 3; 
+    
+    // Bordas dos ms: corrigem a posio estimada (a calibrao mede as bordas
+    // sem correo; sem movimento desde o reset no h sentido para interpret-las)
+    uint8_t sensores = SENSORES_Mascara();
+    uint8_t mudou = sensores ^ sensores_anteriores;
+    sensores_anteriores = sensores;
+    if (mudou) GRAVA(GRAVA_SENSORES, sensores);
+    if (mudou & sensores) entrada_timer0 = SENSORES_LeTimer0();
+    if (mudou && ultima_direcao != MOTOR_PARADO && estado_atual != ESTADO_CALIBRACAO) {
+        SENSORES_Ancora(sensores, mudou);
+    }
+    
+    // Sensor ativo sem posio conhecida e sem borda til:
+    // ancora o contador de pulsos na posio do andar
+    if (origem_posicao == POSICAO_DESCONHECIDA && sensores) {
+        SENSORES_DefinePulsos(mapa_poco.andar[andar_atual]);
+        origem_posicao = POSICAO_SENSOR;
+    }
 
     // SEGURANA EXTREMA 
+    // (a calibrao usa essas paradas como pontos de retorno e continua no prprio estado)
     // Se bater no cho descendo, motor para
     if (SENSOR_S1 == 0 && estado_motor == MOTOR_DESCENDO) {
         Controle_Parar();
-        estado_atual = ESTADO_PARADO;
-        posicao_mm = 0; // Recalibra a posio fsica para 0
+        if (estado_atual != ESTADO_CALIBRACAO) estado_atual = ESTADO_PARADO;
     }
     // Se bater no teto subindo, motor para
     if (SENSOR_S4 == 1 && estado_motor == MOTOR_SUBINDO) {
         Controle_Parar();
-        estado_atual = ESTADO_PARADO;
-        posicao_mm = POSICAO_MAX_MM; // Recalibra a posio fsica para o mximo
+        if (estado_atual != ESTADO_CALIBRACAO) estado_atual = ESTADO_PARADO;
+    }
+    
+    // CONFIRMAO DE PARADA
+    // Conta os ciclos com motor desligado e encoder sem pulsos (usado na reverso)
+    if (estado_motor == MOTOR_PARADO && velocidade_atual == 0) {
+        if (ciclos_parado < 255) ciclos_parado++;
+    } else {
+        ciclos_parado = 0;
     }
 }
 
@@ -220,6 +823,24 @@ bool Existe_Chamada_Abaixo(uint8_t andar_ref) {
     return false;
 }
 
+/**
+ * @brief Verifica se a cabine chegou ao sensor de #andar_atual neste movimento.
+ * @details Em movimento, #andar_atual guarda o ltimo andar detectado at o
+ * sensor seguinte; as decises de parada s valem com a cabine no m, seno
+ * uma chamada nova para o andar que acabou de ficar para trs pararia a cabine
+ * entre dois andares. O m do andar de partida tambm no vale: parando na
+ * sada dele, a cabine desliza para fora da janela do sensor. Pelo mesmo
+ * motivo a deciso s vale at o centro do m (#MEIA_JANELA pulsos aps a
+ * ativao do sensor); uma chamada que chega depois espera a volta da cabine.
+ * @return true Se a cabine estiver na metade de entrada do m de um andar alcanado.
+ * @return false Se estiver entre andares, alm do centro do m ou no andar de partida.
+ */
+bool Cabine_No_Andar(void) {
+    if (andar_atual == andar_partida) return false;
+    if (!((SENSORES_Mascara() >> andar_atual) & 0x01)) return false;
+    return (uint8_t)(SENSORES_LeTimer0() - entrada_timer0) <= MEIA_JANELA;
+}
+
 /**
  * @brief Limpa a solicitao do andar atual aps o atendimento.
  * @details Remove a pendncia dos vetores globais (#chamadas_subida ou #chamadas_descida)
@@ -245,3 +866,123 @@ void Limpar_Chamada_Atual() {
     if (andar_atual == 0) chamadas_descida[0] = false;
 }
 
+/**
+ * @brief Verifica se um novo movimento exige a reverso de segurana.
+ * @details A reverso s  necessria quando o sentido pedido  oposto ao ltimo
+ * sentido comandado e o encoder ainda no confirmou a parada por
+ * #REVERSAO_CONFIRMA ciclos. Movimentos no mesmo sentido, ou aps o motor j
+ * estar parado (ex.: depois da espera de porta), no pagam a penalidade.
+ * @param direcao Sentido desejado (#MOTOR_SUBINDO ou #MOTOR_DESCENDO).
+ * @return true Se deve aguardar em #ESTADO_REVERSAO.
+ * @return false Se o motor pode ser acionado imediatamente.
+ */
+bool Exige_Reversao(uint8_t direcao) {
+    if (ultima_direcao == MOTOR_PARADO || ultima_direcao == direcao) return false;
+    return (ciclos_parado < REVERSAO_CONFIRMA);
+}
+
+/**
+ * @brief Registra um novo pedido de embarque no andar de origem.
+ * @details Marca o embarque pendente e acumula a demanda do andar,
+ * usada por Abrir_Porta() para estender o tempo em andares movimentados.
+ * @param andar Andar de origem do pedido (0 a 3).
+ */
+void Registrar_Embarque(uint8_t andar) {
+    embarque_pendente[andar] = true;
+    
+    // Soma saturada em 255
+    if (demanda_andar[andar] <= 255 - DEMANDA_PASSO) {
+        demanda_andar[andar] += DEMANDA_PASSO;
+    }
+}
+
+/**
+ * @brief Registra um pedido de viagem nas filas do SCAN.
+ * @details Marca a origem no vetor do sentido da viagem e guarda o destino em
+ * #destinos_pendentes at o embarque, atualiza #andar_destino para a
+ * telemetria e registra o embarque na origem. Com origem igual ao destino
+ * nenhuma chamada entra nas filas e o embarque no  registrado.
+ * @param origem Andar de origem (0 a 3).
+ * @param destino Andar de destino (0 a 3).
+ */
+void Registrar_Pedido(uint8_t origem, uint8_t destino) {
+    
+    // Atualiza a varivel global de destino para telemetria
+    andar_destino = destino;
+    
+    // Define a direo da solicitao com base na origem e destino
+    // (o destino s entra nas filas quando o passageiro embarca)
+    if (origem < destino) { 
+        chamadas_subida[origem] = true;
+        destinos_pendentes[origem] |= (uint8_t)(1u << destino);
+    } 
+    else if (origem > destino) {
+        chamadas_descida[origem] = true;
+        destinos_pendentes[origem] |= (uint8_t)(1u << destino);
+    }
+    
+    // Registra o embarque na origem para o clculo do tempo de porta
+    // (sem viagem, marc-lo daria tempo de embarque  prxima parada no andar)
+    if (origem != destino) Registrar_Embarque(origem);
+    pedidos_recebidos++;
+}
+
+/**
+ * @brief Inicia o atendimento no andar atual com tempo de porta adaptativo.
+ * @details Calcula #tempo_porta antes de limpar a chamada:
+ * - Parte de #PORTA_EMBARQUE se algum embarca, seno #PORTA_DESEMBARQUE.
+ * - Acrescenta #PORTA_EXTRA em andares com demanda acima de #DEMANDA_ALTA.
+ * - Embarca os passageiros do andar: seus destinos viram chamadas.
+ * - Reduz #PORTA_FILA se houver chamadas pendentes em outros andares.
+ * Em seguida limpa a chamada, decai a demanda e entra em #ESTADO_ESPERA_PORTA.
+ */
+void Abrir_Porta() {
+    
+    // 1. Tempo base: embarque ou apenas desembarque
+    if (embarque_pendente[andar_atual]) tempo_porta = PORTA_EMBARQUE;
+    else tempo_porta = PORTA_DESEMBARQUE;
+    
+    // 2. Andar movimentado: mais tempo para o fluxo de passageiros
+    if (demanda_andar[andar_atual] >= DEMANDA_ALTA) tempo_porta += PORTA_EXTRA;
+    
+    // 3. Embarque: os destinos dos passageiros deste andar entram nas filas
+    for (uint8_t i = 0; i < 4; i++) {
+        if (destinos_pendentes[andar_atual] & (1u << i)) {
+            if (i > andar_atual) chamadas_subida[i] = true;
+            else chamadas_descida[i] = true;
+        }
+    }
+    destinos_pendentes[andar_atual] = 0;
+    
+    // 4. Chamadas aguardando em outros andares: encurta a parada
+    if (Existe_Chamada_Acima(andar_atual) || Existe_Chamada_Abaixo(andar_atual)) {
+        tempo_porta -= PORTA_FILA;
+        if (tempo_porta < PORTA_MINIMO) tempo_porta = PORTA_MINIMO;
+    }
+    
+    // 5. Atendimento da chamada
+    Limpar_Chamada_Atual();
+    
+    // O embarque s  concludo quando no resta pendncia no andar
+    if (!chamadas_subida[andar_atual] && !chamadas_descida[andar_atual]) {
+        embarque_pendente[andar_atual] = false;
+    }
+    
+    // 6. Decaimento lento da demanda (mdia mvel exponencial, 1/8 por parada)
+    for (uint8_t i = 0; i < 4; i++) {
+        demanda_andar[i] -= demanda_andar[i] >> 3;
+    }
+    
+    estado_atual = ESTADO_ESPERA_PORTA;
+    contador_espera = 0;
+}
+
+/**
+ * @brief Encerra o embarque imediatamente (comando "$PF").
+ * @note Sem efeito fora de #ESTADO_ESPERA_PORTA.
+ */
+void Fechar_Porta() {
+    if (estado_atual == ESTADO_ESPERA_PORTA) {
+        contador_espera = tempo_porta;
+    }
+}
\ No newline at end of file
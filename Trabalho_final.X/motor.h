@@ -11,11 +11,37 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "globals.h"
+
+
+/**
+ * @brief Estatsticas do estimador de posio desde o reset (consulta "$?D").
+ * - ancoragens: Bordas de sensor usadas para corrigir a posio.
+ * - ultimo:     Resduo da ltima ancoragem (borda - estimativa), em 1/16 de pulso.
+ * - maior:      Maior resduo em mdulo, em 1/16 de pulso.
+ */
+typedef struct {
+    uint16_t ancoragens;
+    int16_t ultimo;
+    uint16_t maior;
+} EstatisticaDeriva;
 
 
 // FUNES DE TELEMETRIA E SENSORES
 
 
+/**
+ * @brief Tarefa da interrupo do TMR2 (512 s): avana o relgio de ms.
+ */
+void RELOGIO_Tick(void);
+
+/**
+ * @brief L o relgio de milissegundos livre.
+ * @return Tempo desde o reset em ms, com retorno a 0 a cada 65,5 s.
+ */
+uint16_t RELOGIO_Ms(void);
+
+
 /**
  * @brief Atualiza a telemetria do sistema (Velocidade e Posio).
  * @details Esta funo deve ser chamada periodicamente para garantir
@@ -23,6 +49,31 @@
  */
 void SENSORES_CalcularVelocidade(void);
 
+/**
+ * @brief L o contador de pulsos do encoder de forma atmica.
+ * @return Pulsos desde o trreo.
+ */
+uint16_t SENSORES_LePulsos(void);
+
+/**
+ * @brief Redefine o contador de pulsos e a posio em mm (sem passar pelo estimador).
+ * @param pulsos Pulsos desde o trreo (ex.: restaurados da EEPROM).
+ */
+void SENSORES_DefinePulsos(uint16_t pulsos);
+
+/**
+ * @brief Troca o mapa do poo em uso (escala e posio dos andares).
+ * @param mapa Mapa lido da EEPROM ou medido pela calibrao.
+ */
+void SENSORES_DefineMapa(const MapaPoco* mapa);
+
+/**
+ * @brief Copia as estatsticas do estimador de posio.
+ * @param copia Destino das estatsticas das ancoragens.
+ * @param taxa Taxa de deriva aprendida, em 1/4096 por pulso (positiva = pulsos perdidos).
+ */
+void SENSORES_Deriva(EstatisticaDeriva* copia, int16_t* taxa);
+
 /**
  * @brief L os sensores de andar.
  * @details Atualiza a varivel global de "andar atual" e verifica colises
@@ -52,6 +103,31 @@ void Controle_Descer(void);
 void Controle_Parar(void);
 
 
+/**
+ * @brief Inicia a busca lenta do sensor de andar mais provvel.
+ * @param sentido_interrompido Sentido do movimento interrompido pelo reset.
+ */
+void Controle_IniciarBusca(uint8_t sentido_interrompido);
+
+/**
+ * @brief Acompanha a busca de referncia.
+ * @return true quando a busca termina.
+ */
+bool Controle_Buscar(void);
+
+/**
+ * @brief Inicia a calibrao do poo e entra em #ESTADO_CALIBRACAO.
+ * @return false se o elevador no estiver em repouso.
+ */
+bool Controle_IniciarCalibracao(void);
+
+/**
+ * @brief Acompanha a calibrao do poo.
+ * @return true quando a calibrao termina (resultado em #mapa_poco.situacao).
+ */
+bool Controle_Calibrar(void);
+
+
 // ALGORITMOS DE LGICA
 
 
@@ -69,9 +145,45 @@ bool Existe_Chamada_Acima(uint8_t andar_ref);
  */
 bool Existe_Chamada_Abaixo(uint8_t andar_ref);
 
+/**
+ * @brief Verifica se a cabine chegou ao sensor de #andar_atual neste movimento.
+ * @return true/false.
+ */
+bool Cabine_No_Andar(void);
+
 /**
  * @brief Remove a pendncia do andar atual dos vetores globais.
  */
 void Limpar_Chamada_Atual(void);  
 
+/**
+ * @brief Verifica se a inverso de sentido exige espera pela parada do motor.
+ * @param direcao Sentido desejado.
+ * @return true/false.
+ */
+bool Exige_Reversao(uint8_t direcao);
+
+/**
+ * @brief Registra um pedido de embarque no andar de origem.
+ * @param andar Andar de origem.
+ */
+void Registrar_Embarque(uint8_t andar);
+
+/**
+ * @brief Registra um pedido de viagem nas filas do SCAN.
+ * @param origem Andar de origem (0 a 3).
+ * @param destino Andar de destino (0 a 3).
+ */
+void Registrar_Pedido(uint8_t origem, uint8_t destino);
+
+/**
+ * @brief Atende o andar atual e abre a porta com tempo adaptativo.
+ */
+void Abrir_Porta(void);
+
+/**
+ * @brief Encerra imediatamente o tempo de porta aberta.
+ */
+void Fechar_Porta(void);
+
 #endif	/* MOTOR_H */
\ No newline at end of file
@@ -0,0 +1,268 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Orçamento de memória do firmware (PIC16F1827)
+---------------------------------------------
+- Lê o .map, o .lst e o .sdb gerados pelo XC8 em dist/<conf>/<imagem>.
+- Memória de programa (palavras) e de dados (bytes) por módulo.
+- Cadeia de chamadas mais profunda do loop principal e da interrupção, que
+  somadas dão os níveis usados da pilha de hardware (16 níveis; com STVREN,
+  o estouro reinicia o PIC).
+- Termina com código 1 se algum orçamento for excedido.
+
+Uso:
+    python3 orcamento.py dist/default/production --flash 3900 --ram 360 --pilha 14
+"""
+import argparse
+import glob
+import os
+import re
+import sys
+from collections import defaultdict
+
+AQUI = os.path.dirname(os.path.abspath(__file__))
+
+FLASH_TOTAL = 4096       # Palavras de 14 bits
+RAM_TOTAL = 384          # Bytes de uso geral (bancos 0-4 + área comum)
+PILHA_TOTAL = 16         # Níveis da pilha de hardware
+
+CLASSES_PROGRAMA = {"CODE", "STRCODE", "STRING", "CONST", "ENTRY"}
+CLASSES_DADOS = re.compile(r"^(COMMON|BANK\d+|ABS1)$")
+PILHA_COMPILADA = "(pilha compilada)"
+SEM_MODULO = "(runtime)"
+
+
+def arquivo(diretorio, sufixo):
+    achados = sorted(glob.glob(os.path.join(diretorio, "*" + sufixo)))
+    if not achados:
+        sys.exit(f"{diretorio}: nenhum arquivo *{sufixo}; compile o projeto no MPLAB X antes")
+    return achados[0]
+
+
+def normaliza(caminho, modulos=()):
+    """Nome curto do módulo: relativo ao projeto ou "xc8/arquivo.c" para a biblioteca."""
+    caminho = caminho.replace("\\", "/")
+    for m in modulos:
+        if caminho == m or caminho.endswith("/" + m):
+            return m
+    if caminho.startswith("/") or ":" in caminho:
+        return "xc8/" + os.path.basename(caminho)
+    return caminho
+
+
+# LEITURA DO .map
+
+def le_classes(texto):
+    """Tabela TOTAL do .map: comprimento de cada psect por classe."""
+    classes = defaultdict(dict)
+    inicio = texto.find("\nTOTAL")
+    fim = texto.find("\nSEGMENTS", inicio)
+    classe = None
+    for linha in texto[inicio:fim].splitlines()[1:]:
+        m = re.match(r"\s+CLASS\s+(\S+)", linha)
+        if m:
+            classe = m.group(1)
+            continue
+        campos = linha.split()
+        if classe and len(campos) == 5:
+            classes[classe][campos[0]] = int(campos[3], 16)
+    return classes
+
+
+def le_modulos(texto):
+    """Seção MODULE INFORMATION do .map: {módulo: [(símbolo, classe, tamanho)]}."""
+    modulos = defaultdict(list)
+    inicio = texto.find("MODULE INFORMATION")
+    if inicio < 0:
+        return modulos
+    atual = None
+    for linha in texto[inicio:].splitlines()[3:]:
+        if not linha.strip() or "estimated size" in linha:
+            continue
+        if not linha.startswith("\t"):
+            atual = normaliza(linha.strip())
+            continue
+        campos = linha.split()
+        if atual and len(campos) == 5:
+            modulos[atual].append((campos[0], campos[1], int(campos[4])))
+    return modulos
+
+
+# LEITURA DO .lst
+
+def le_variaveis(texto):
+    """Tamanho de cada variável estática: rótulos seguidos de 'ds N' nos psects de dados."""
+    espaco_dados = set()
+    for m in re.finditer(r"\bpsect\s+(\w+),[^\n]*\bspace=1\b", texto):
+        if not m.group(1).startswith("cstack"):
+            espaco_dados.add(m.group(1))
+
+    tamanhos = defaultdict(int)
+    psect = None
+    rotulo = None
+    for linha in texto.splitlines():
+        m = re.search(r"\tpsect\t(\w+)\s*$", linha)
+        if m:
+            psect = m.group(1)
+            rotulo = None
+            continue
+        if psect not in espaco_dados:
+            continue
+        m = re.match(r"\s*\d+\s+[0-9A-F]+\s+(\w+):", linha)
+        if m:
+            rotulo = m.group(1)
+            continue
+        m = re.search(r"\tds\t(\d+)", linha)
+        if m and rotulo:
+            tamanhos[rotulo] += int(m.group(1))
+    return tamanhos
+
+
+def le_grafo(texto):
+    """Tabelas de grafo de chamadas do .lst: (raízes, {função: [chamadas]}).
+
+    Há uma tabela para o loop principal e outra para a interrupção, cada uma
+    encerrada por "Estimated maximum stack depth"; a primeira entrada é a raiz.
+    """
+    grafo = defaultdict(list)
+    raizes = []
+    inicio = texto.find("Call Graph Tables:")
+    fim = texto.find("Call Graph Graphs:", inicio)
+    for tabela in texto[inicio:fim].split("Estimated maximum stack depth")[:-1]:
+        atual = None
+        raiz = None
+        for linha in tabela.splitlines():
+            m = re.match(r"\s*\(\d+\)\s+(\S+)", linha)
+            if m:
+                atual = None if m.group(1).startswith("NULL") else m.group(1)
+                if atual and raiz is None:
+                    raiz = atual
+                    raizes.append(raiz)
+            elif atual and re.match(r"\s+[_A-Za-z]\S*(\s+\*)?\s*$", linha):
+                nome = linha.split()[0]
+                if nome != "NULL":
+                    grafo[atual].append(nome)
+    return raizes, grafo
+
+
+def mais_profunda(raiz, grafo):
+    """Cadeia de chamadas mais longa a partir da raiz (o grafo do XC8 não tem recursão)."""
+    memo = {}
+
+    def visita(f):
+        if f not in memo:
+            melhor = []
+            for g in grafo.get(f, []):
+                c = visita(g)
+                if len(c) > len(melhor):
+                    melhor = c
+            memo[f] = [f] + melhor
+        return memo[f]
+
+    return visita(raiz)
+
+
+# LEITURA DO .sdb
+
+def le_origem(texto, modulos):
+    """Arquivo fonte de cada símbolo global, pelas diretivas '"linha arquivo' do .sdb."""
+    origem = {}
+    atual = None
+    for linha in texto.splitlines():
+        if linha.startswith('"'):
+            partes = linha[1:].split(" ", 1)
+            if len(partes) == 2:
+                atual = normaliza(partes[1].strip(), modulos)
+        elif linha.startswith("[v ") and atual:
+            origem.setdefault(linha.split()[1], atual)
+    return origem
+
+
+# RELATÓRIO
+
+def main():
+    ap = argparse.ArgumentParser(description="Orçamento de RAM, flash e pilha do firmware")
+    ap.add_argument("diretorio", help="pasta com o .map e o .lst (ex.: dist/default/production)")
+    ap.add_argument("--flash", type=int, default=FLASH_TOTAL, help="orçamento de programa (palavras)")
+    ap.add_argument("--ram", type=int, default=RAM_TOTAL, help="orçamento de dados (bytes)")
+    ap.add_argument("--pilha", type=int, default=PILHA_TOTAL, help="orçamento da pilha de hardware (níveis)")
+    args = ap.parse_args()
+
+    with open(arquivo(args.diretorio, ".map"), encoding="latin-1") as f:
+        mapa = f.read()
+    with open(arquivo(args.diretorio, ".lst"), encoding="latin-1") as f:
+        lst = f.read()
+    sdb = ""
+    achados = glob.glob(os.path.join(args.diretorio, "*.sdb"))
+    if achados:
+        with open(achados[0], encoding="latin-1") as f:
+            sdb = f.read()
+
+    classes = le_classes(mapa)
+    modulos = le_modulos(mapa)
+    fontes = [os.path.relpath(c, AQUI).replace(os.sep, "/") for c in
+              glob.glob(os.path.join(AQUI, "*.c")) + glob.glob(os.path.join(AQUI, "mcc_generated_files", "*.c"))]
+    origem = le_origem(sdb, fontes)
+
+    # Totais
+    flash = sum(sum(p.values()) for c, p in classes.items() if c in CLASSES_PROGRAMA)
+    ram = sum(sum(p.values()) for c, p in classes.items() if CLASSES_DADOS.match(c))
+    cstack = sum(n for c, p in classes.items() if CLASSES_DADOS.match(c)
+                 for nome, n in p.items() if nome.startswith("cstack"))
+
+    # Programa por módulo (tabelas "shared" voltam ao módulo de origem pelo .sdb)
+    flash_mod = defaultdict(int)
+    for mod, simbolos in modulos.items():
+        for simbolo, _classe, tamanho in simbolos:
+            destino = mod
+            if mod == "shared":
+                destino = origem.get(simbolo, origem.get(simbolo.replace("i1_", "", 1), SEM_MODULO))
+            flash_mod[destino] += tamanho
+    flash_mod[SEM_MODULO] += flash - sum(flash_mod.values())
+
+    # Dados por módulo
+    ram_mod = defaultdict(int)
+    for rotulo, tamanho in le_variaveis(lst).items():
+        ram_mod[origem.get(rotulo, SEM_MODULO)] += tamanho
+    ram_mod[PILHA_COMPILADA] = cstack
+    ram_mod[SEM_MODULO] += ram - sum(ram_mod.values())
+
+    # Pilha de hardware: main entra por salto (0 níveis); a interrupção empilha
+    # o PC (1 nível) sobre o ponto mais fundo do loop principal
+    raizes, grafo = le_grafo(lst)
+    cadeias = [mais_profunda(r, grafo) for r in raizes]
+    pilha = 0
+    for i, c in enumerate(cadeias):
+        pilha += len(c) - 1 + (1 if i else 0)
+
+    print(f"{'módulo':<40} {'programa':>9} {'dados':>6}")
+    nomes = sorted(set(flash_mod) | set(ram_mod),
+                   key=lambda n: (n.startswith("("), -flash_mod.get(n, 0), n))
+    for nome in nomes:
+        if flash_mod.get(nome, 0) or ram_mod.get(nome, 0):
+            print(f"{nome:<40} {flash_mod.get(nome, 0):>9} {ram_mod.get(nome, 0):>6}")
+    print()
+
+    for i, c in enumerate(cadeias):
+        rotulo = "interrupção" if i else "loop principal"
+        niveis = len(c) - 1 + (1 if i else 0)
+        print(f"{rotulo} ({niveis} níveis): {' -> '.join(c)}")
+    print()
+
+    excedido = []
+    for nome, usado, total, orcamento, unidade in (
+            ("programa", flash, FLASH_TOTAL, args.flash, "palavras"),
+            ("dados", ram, RAM_TOTAL, args.ram, "bytes"),
+            ("pilha", pilha, PILHA_TOTAL, args.pilha, "níveis")):
+        estado = "OK" if usado <= orcamento else "EXCEDIDO"
+        print(f"{nome:<9} {usado:>5} de {total:>5} {unidade:<8} ({100.0 * usado / total:5.1f}%)  "
+              f"orçamento {orcamento:>5}  {estado}")
+        if usado > orcamento:
+            excedido.append(nome)
+
+    if excedido:
+        sys.exit(f"orçamento excedido: {', '.join(excedido)}")
+
+
+if __name__ == "__main__":
+    main()
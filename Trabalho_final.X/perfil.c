@@ -0,0 +1,215 @@
+/**
+ * @file perfil.c
+ * @brief Perfilador de ciclos baseado no TMR1 livre.
+ * @details Compilado apenas com PERFIL_HABILITADO = 1 e/ou PERFIL_INTERRUPCOES = 1.
+ * O TMR1 no  usado pelo MCC neste projeto:  configurado aqui diretamente
+ * (Fosc/4, prescaler 1:1), com estouro a cada 65536 ciclos (32,8 ms), acima
+ * da fase mais longa do loop.
+ */
+
+#include "perfil.h"
+
+#if PERFIL_HABILITADO || PERFIL_INTERRUPCOES
+
+#include "globals.h"
+#include "mcc_generated_files/mcc.h"
+
+
+// CONSTANTES E VARIVEIS
+
+/**
+ * @brief TMR1 ligado, clock Fosc/4, prescaler 1:1, oscilador secundrio desligado.
+ */
+#define T1CON_PERFIL  0x01
+
+#if PERFIL_HABILITADO
+
+const char LUT_perfil[NUM_PERFIS] = {'R', 'S', 'E', 'T', 'L', 'V', 'C'};
+
+static PerfilRegistro registros[NUM_PERFIS];
+
+/**
+ * @brief Leitura do TMR1 na entrada de cada fase.
+ */
+static uint16_t inicio_fase[NUM_PERFIS];
+
+/**
+ * @brief Ciclos gastos pelo prprio par PERFIL_Inicio/PERFIL_Fim.
+ */
+static uint16_t custo_medicao = 0;
+
+#endif
+
+#if PERFIL_INTERRUPCOES
+
+/**
+ * @brief Contagem e histograma de servio por fonte.
+ */
+static uint16_t contagem_irq[NUM_IRQ];
+static uint8_t servico_irq[NUM_IRQ][IRQ_FAIXAS];
+
+/**
+ * @brief Histogramas de latncia das fontes de timer (ndice 0 = TMR4, 1 = TMR2).
+ */
+static uint8_t latencia_irq[2][IRQ_FAIXAS];
+
+/**
+ * @brief Leitura do TMR1 na entrada do despachante.
+ */
+static uint16_t inicio_irq;
+
+static uint16_t estouros_rx = 0;
+
+#endif
+
+
+// FUNES AUXILIARES
+
+/**
+ * @brief L os 16 bits do TMR1 sem rasgar a leitura.
+ * @note Se o byte alto mudar entre as leituras, o baixo estourou: l de novo.
+ */
+static uint16_t PERFIL_LeTimer(void){
+    uint8_t alto = TMR1H;
+    uint8_t baixo = TMR1L;
+    if(TMR1H != alto){
+        alto = TMR1H;
+        baixo = TMR1L;
+    }
+    return ((uint16_t)alto << 8) | baixo;
+}
+
+#if PERFIL_HABILITADO
+/**
+ * @brief Zera o acumulador de uma fase.
+ */
+static void PERFIL_Zera(uint8_t fase){
+    registros[fase].minimo = 0xFFFF;
+    registros[fase].maximo = 0;
+    registros[fase].soma = 0;
+    registros[fase].amostras = 0;
+}
+#endif
+
+#if PERFIL_INTERRUPCOES
+/**
+ * @brief Soma uma amostra ao histograma logartmico, saturando em 255.
+ * @param base log2 do limite superior da faixa 0.
+ */
+static void PERFIL_Histograma(uint8_t* faixas, uint16_t ciclos, uint8_t base){
+    uint8_t k = 0;
+    ciclos >>= base;
+    while(ciclos && k < IRQ_FAIXAS - 1){
+        ciclos >>= 1;
+        k++;
+    }
+    if(faixas[k] != 0xFF) faixas[k]++;
+}
+
+/**
+ * @brief Tratador de estouro da RX: conta e reinicia a recepo como o padro do MCC.
+ */
+static void PERFIL_EstouroRx(void){
+    if(estouros_rx != 0xFFFF) estouros_rx++;
+    RCSTAbits.CREN = 0;
+    RCSTAbits.CREN = 1;
+}
+#endif
+
+
+// FUNES DO PERFILADOR
+
+void PERFIL_Inicializa(void){
+    T1GCON = 0x00;
+    TMR1H = 0;
+    TMR1L = 0;
+    T1CON = T1CON_PERFIL;
+
+#if PERFIL_HABILITADO
+    // Mede uma fase vazia para descontar o custo da instrumentao
+    PERFIL_Inicio(0);
+    PERFIL_Fim(0);
+    custo_medicao = registros[0].maximo;
+
+    for(uint8_t i = 0; i < NUM_PERFIS; i++){
+        PERFIL_Zera(i);
+    }
+#endif
+
+#if PERFIL_INTERRUPCOES
+    EUSART_SetOverrunErrorHandler(PERFIL_EstouroRx);
+#endif
+}
+
+#if PERFIL_HABILITADO
+
+void PERFIL_Inicio(uint8_t fase){
+    inicio_fase[fase] = PERFIL_LeTimer();
+}
+
+void PERFIL_Fim(uint8_t fase){
+    uint16_t ciclos = PERFIL_LeTimer() - inicio_fase[fase];
+    PerfilRegistro* r = &registros[fase];
+
+    ciclos = (ciclos > custo_medicao) ? ciclos - custo_medicao : 0;
+
+    if(ciclos < r->minimo) r->minimo = ciclos;
+    if(ciclos > r->maximo) r->maximo = ciclos;
+    if(r->amostras != 0xFFFF){
+        r->soma += ciclos;
+        r->amostras++;
+    }
+}
+
+bool PERFIL_Consulta(uint8_t fase, PerfilRegistro* copia){
+    INTCONbits.GIE = 0;
+    *copia = registros[fase];
+    PERFIL_Zera(fase);
+    INTCONbits.GIE = 1;
+    return copia->amostras != 0;
+}
+
+#endif
+
+#if PERFIL_INTERRUPCOES
+
+void PERFIL_IrqEntrada(void){
+    inicio_irq = PERFIL_LeTimer();
+}
+
+void PERFIL_IrqLatencia(uint8_t fonte, uint16_t ciclos){
+    PERFIL_Histograma(latencia_irq[fonte - IRQ_TMR4], ciclos, IRQ_BASE_LATENCIA);
+}
+
+void PERFIL_IrqSaida(uint8_t fonte){
+    if(contagem_irq[fonte] != 0xFFFF) contagem_irq[fonte]++;
+    PERFIL_Histograma(servico_irq[fonte], PERFIL_LeTimer() - inicio_irq, IRQ_BASE_SERVICO);
+}
+
+void PERFIL_ConsultaIrq(uint8_t fonte, PerfilIrq* copia){
+    INTCONbits.GIE = 0;
+    copia->contagem = contagem_irq[fonte];
+    contagem_irq[fonte] = 0;
+    for(uint8_t k = 0; k < IRQ_FAIXAS; k++){
+        copia->servico[k] = servico_irq[fonte][k];
+        servico_irq[fonte][k] = 0;
+        copia->latencia[k] = 0;
+        if(fonte >= IRQ_TMR4){
+            copia->latencia[k] = latencia_irq[fonte - IRQ_TMR4][k];
+            latencia_irq[fonte - IRQ_TMR4][k] = 0;
+        }
+    }
+    INTCONbits.GIE = 1;
+}
+
+uint16_t PERFIL_EstourosRx(void){
+    INTCONbits.GIE = 0;
+    uint16_t n = estouros_rx;
+    estouros_rx = 0;
+    INTCONbits.GIE = 1;
+    return n;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,219 @@
+/**
+ * @file perfil.h
+ * @brief Perfilador de ciclos das fases do loop principal e das interrupes.
+ * @details Cada fase  delimitada por PERFIL_INICIO()/PERFIL_FIM(), que leem o
+ * TMR1 livre (Fosc/4, 1 ciclo de instruo = 0,5 s a 8 MHz). O perfilador
+ * acumula mnimo, mximo e mdia de ciclos por fase; o resultado  consultado
+ * com "$?P".
+ * @note Habilitado apenas com PERFIL_HABILITADO = 1 (ex.: -DPERFIL_HABILITADO=1
+ * nas macros do projeto). Desligado, as macros no geram cdigo, o TMR1 fica
+ * parado e a consulta "$?P"  rejeitada como quadro invlido.
+ *
+ * Com PERFIL_INTERRUPCOES = 1, o despachante de interrupes tambm conta
+ * cada fonte e monta histogramas do tempo de servio e, para os timers, da
+ * latncia entre a flag de hardware e o atendimento (consulta "$?I").
+ * As duas opes so independentes e compartilham o TMR1.
+ *
+ * Com PERFIL_MARCADOR = 1, o pino RB1 marca o caminho do pedido at o motor
+ * para o analisador lgico (ver PERFIL_MARCA_PEDIDO()).
+ */
+
+#ifndef PERFIL_H
+#define PERFIL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef PERFIL_HABILITADO
+#define PERFIL_HABILITADO 0
+#endif
+
+#ifndef PERFIL_INTERRUPCOES
+#define PERFIL_INTERRUPCOES 0
+#endif
+
+#ifndef PERFIL_MARCADOR
+#define PERFIL_MARCADOR 0
+#endif
+
+
+/**
+ * @brief Fases medidas.
+ * - RECEPCAO:   'R' - UART_ProcessaRecepcao.
+ * - SENSORES:   'S' - Verificar_Sensores.
+ * - ESTADOS:    'E' - Mquina de estados.
+ * - TELEMETRIA: 'T' - UART_EscalonaTelemetria (inclui o envio bloqueante).
+ * - MATRIZ:     'L' - Mapeamento das solicitaes e MatrizLed.
+ * - VELOCIDADE: 'V' - SENSORES_CalcularVelocidade (interrupo do TMR4).
+ * - RELOGIO:    'C' - RELOGIO_Tick (interrupo do TMR2).
+ * @note As fases do loop incluem o tempo das interrupes que ocorrerem dentro delas.
+ */
+#define PERFIL_RECEPCAO    0
+#define PERFIL_SENSORES    1
+#define PERFIL_ESTADOS     2
+#define PERFIL_TELEMETRIA  3
+#define PERFIL_MATRIZ      4
+#define PERFIL_VELOCIDADE  5
+#define PERFIL_RELOGIO     6
+#define NUM_PERFIS         7
+
+/**
+ * @brief Estatsticas acumuladas de uma fase, em ciclos de instruo.
+ * @note A soma para de acumular quando #amostras satura em 65535.
+ */
+typedef struct {
+    uint16_t minimo;
+    uint16_t maximo;
+    uint32_t soma;
+    uint16_t amostras;
+} PerfilRegistro;
+
+
+/**
+ * @brief Fontes de interrupo, na ordem de prioridade do despachante do MCC.
+ */
+#define IRQ_TX             0
+#define IRQ_RX             1
+#define IRQ_CMP2           2
+#define IRQ_CMP1           3
+#define IRQ_TMR4           4
+#define IRQ_TMR2           5
+#define NUM_IRQ            6
+
+/**
+ * @brief Faixas dos histogramas, em potncias de 2 de ciclos de instruo.
+ * - Servio:  faixa k cobre [32*2^(k-1), 32*2^k) ciclos; 0 = abaixo de 32, 7 = 2048 ou mais.
+ * - Latncia: faixa k cobre [8*2^(k-1), 8*2^k) ciclos; 0 = abaixo de 8, 7 = 512 ou mais.
+ */
+#define IRQ_FAIXAS         8
+#define IRQ_BASE_SERVICO   5
+#define IRQ_BASE_LATENCIA  3
+
+/**
+ * @brief Estatsticas de uma fonte de interrupo desde a ltima consulta.
+ * @note Os histogramas saturam em 255 por faixa. A latncia s  medida nas
+ * fontes de timer, cujo contador indica h quanto tempo a flag subiu.
+ */
+typedef struct {
+    uint16_t contagem;
+    uint8_t servico[IRQ_FAIXAS];
+    uint8_t latencia[IRQ_FAIXAS];
+} PerfilIrq;
+
+
+#if PERFIL_HABILITADO || PERFIL_INTERRUPCOES
+
+/**
+ * @brief Liga o TMR1; com o perfilador de fases, mede o custo do prprio par Incio/Fim.
+ * @note Custo em RAM: ~84 bytes com PERFIL_HABILITADO e ~80 bytes com PERFIL_INTERRUPCOES.
+ */
+void PERFIL_Inicializa(void);
+
+#define PERFIL_INICIALIZA()   PERFIL_Inicializa()
+
+#else
+
+#define PERFIL_INICIALIZA()
+
+#endif
+
+
+#if PERFIL_HABILITADO
+
+/**
+ * @brief LUT com a letra de cada fase na resposta de "$?P".
+ */
+extern const char LUT_perfil[];
+
+/**
+ * @brief Marca a entrada na fase.
+ */
+void PERFIL_Inicio(uint8_t fase);
+
+/**
+ * @brief Marca a sada da fase e acumula os ciclos gastos.
+ */
+void PERFIL_Fim(uint8_t fase);
+
+/**
+ * @brief Copia as estatsticas de uma fase e zera o acumulador.
+ * @details A cpia  feita com as interrupes desabilitadas, pois as fases
+ * de interrupo so acumuladas dentro das prprias ISRs.
+ * @return false se a fase no tiver amostras na janela.
+ */
+bool PERFIL_Consulta(uint8_t fase, PerfilRegistro* copia);
+
+#define PERFIL_INICIO(fase)   PERFIL_Inicio(fase)
+#define PERFIL_FIM(fase)      PERFIL_Fim(fase)
+
+#else
+
+#define PERFIL_INICIO(fase)
+#define PERFIL_FIM(fase)
+
+#endif
+
+
+#if PERFIL_INTERRUPCOES
+
+/**
+ * @brief Marca a entrada no despachante de interrupes.
+ */
+void PERFIL_IrqEntrada(void);
+
+/**
+ * @brief Registra a latncia de uma fonte de timer.
+ * @param ciclos Ciclos de instruo desde que a flag de hardware subiu.
+ */
+void PERFIL_IrqLatencia(uint8_t fonte, uint16_t ciclos);
+
+/**
+ * @brief Conta o atendimento da fonte e registra o tempo desde a entrada no despachante.
+ */
+void PERFIL_IrqSaida(uint8_t fonte);
+
+/**
+ * @brief Copia as estatsticas de uma fonte e zera o acumulador.
+ */
+void PERFIL_ConsultaIrq(uint8_t fonte, PerfilIrq* copia);
+
+/**
+ * @brief L e zera o contador de estouros do registrador de recepo (OERR).
+ * @note Um estouro indica que a interrupo de RX atrasou mais de dois bytes.
+ */
+uint16_t PERFIL_EstourosRx(void);
+
+#define PERFIL_IRQ_ENTRADA()                PERFIL_IrqEntrada()
+#define PERFIL_IRQ_LATENCIA(fonte, ciclos)  PERFIL_IrqLatencia(fonte, ciclos)
+#define PERFIL_IRQ_SAIDA(fonte)             PERFIL_IrqSaida(fonte)
+
+#else
+
+#define PERFIL_IRQ_ENTRADA()
+#define PERFIL_IRQ_LATENCIA(fonte, ciclos)
+#define PERFIL_IRQ_SAIDA(fonte)
+
+#endif
+
+
+#if PERFIL_MARCADOR
+
+/**
+ * @brief Marcador de latncia no pino RB1 (CS da matriz, ocioso em 1).
+ * @details Vai a 0 quando um quadro de pedido  executado e volta a 1 quando
+ * o motor recebe o comando de partida. Capturado junto com RX e PWM, divide a
+ * latncia do pedido em recepo (CR -> descida), deciso (largura do pulso,
+ * inclui a marcao na EEPROM) e alinhamento ao perodo do PWM (subida -> PWM).
+ * @note S com a matriz de LEDs desligada (MatrizLed tambm aciona o RB1).
+ */
+#define PERFIL_MARCA_PEDIDO()    (LATBbits.LATB1 = 0)
+#define PERFIL_MARCA_PARTIDA()   (LATBbits.LATB1 = 1)
+
+#else
+
+#define PERFIL_MARCA_PEDIDO()    ((void)0)
+#define PERFIL_MARCA_PARTIDA()   ((void)0)
+
+#endif
+
+#endif	/* PERFIL_H */
@@ -0,0 +1,137 @@
+/**
+ * @file sono.c
+ * @brief SLEEP do PIC com a cabine estacionada, despertado pelo WDT ou pela RX.
+ * @details Compilado apenas com SONO_HABILITADO = 1. No SLEEP o oscilador
+ * principal para: TMR2 (PWM e relgio de ms), TMR4 (velocidade) e TMR0
+ * (encoder) ficam parados, por isso s se dorme com o motor desligado e a
+ * parada j confirmada pelo encoder. A UART tambm para: a transmisso
+ * precisa ter terminado e a recepo depende do despertar por BAUDCON.WUE.
+ */
+
+#include "sono.h"
+
+#if SONO_HABILITADO
+
+#include "globals.h"
+#include "comm.h"
+#include "memoria.h"
+#include "mcc_generated_files/mcc.h"
+
+
+// CONSTANTES E VARIVEIS
+
+/**
+ * @brief WDTCON do sono leve: WDTPS = 1:256 (~8 ms com o LFINTOSC de 31 kHz) e SWDTEN.
+ */
+#define WDTCON_SONO_LEVE  ((0x03 << 1) | 0x01)
+
+/**
+ * @brief Diviso do ciclo de 10 ms no sono leve (ms).
+ * - LEVE:     Perodo nominal do WDT, somado ao relgio a cada despertar por ele.
+ * - ACORDADO: Restante do ciclo, com o TMR2 rodando.
+ * - RX:       Despertar pela RX no meio do perodo: metade dele, em mdia.
+ * @note O LFINTOSC tem tolerncia bem maior que o HFINTOSC: estacionado, o
+ * relgio de ms (carimbo da telemetria) deriva alguns por cento.
+ */
+#define SONO_LEVE_MS      8
+#define SONO_ACORDADO_MS  2
+#define SONO_RX_MS        4
+
+/**
+ * @brief Ciclos seguidos com a cabine estacionada (saturado em 255).
+ * @note S se dorme a partir do segundo: no ciclo em que a mquina chega ao
+ * repouso as prioridades de #ESTADO_PARADO (ex.: retorno ao trreo) ainda
+ * no foram avaliadas.
+ */
+static uint8_t ciclos_estacionado = 0;
+
+static SonoEstatisticas estat;
+
+
+// FUNES AUXILIARES
+
+/**
+ * @brief Verifica se o PIC pode dormir sem perder nada do controle.
+ * @return true - Parado em repouso, sem chamadas, encoder parado, EEPROM e UART ociosas.
+ */
+static bool SONO_Estacionado(void){
+    if(estado_atual != ESTADO_PARADO || estado_motor != MOTOR_PARADO) return false;
+
+    // O TMR0 no conta no SLEEP: pulsos de inrcia seriam perdidos
+    if(ciclos_parado < REVERSAO_CONFIRMA) return false;
+
+    for(uint8_t i=0; i<4; i++){
+        if(chamadas_subida[i] || chamadas_descida[i]) return false;
+    }
+
+    // MEMORIA_Processa() s roda acordado: o mapa da calibrao leva at 16 ciclos
+    if(!MEMORIA_Ociosa()) return false;
+    return UART_Ociosa();
+}
+
+/**
+ * @brief Soma ao relgio de ms o tempo em que o TMR2 ficou parado.
+ * @param ms Tempo dormido.
+ */
+static void SONO_CompensaRelogio(uint8_t ms){
+    PIE1bits.TMR2IE = 0;
+    tempo_ms += ms;
+    PIE1bits.TMR2IE = 1;
+}
+
+
+// FUNES PBLICAS
+
+void SONO_Espera(void){
+
+    if(!SONO_Estacionado()) ciclos_estacionado = 0;
+    else if(ciclos_estacionado < 255) ciclos_estacionado++;
+    
+    if(ciclos_estacionado < 2){
+        __delay_ms(10);
+        return;
+    }
+
+    // 1. Modo: sem assinantes da telemetria no h o que fazer at o prximo quadro
+    bool profundo = !UART_TelemetriaAssinada();
+    if(!profundo) WDTCON = WDTCON_SONO_LEVE;
+
+    // 2. Dorme: a borda de descida na RX ou o WDT acordam o PIC
+    // (a instruo aps o SLEEP executa antes da interrupo da RX). O CLRWDT
+    // leva nTO e nPD a 1; s o SLEEP executado zera o nPD
+    BAUDCONbits.WUE = 1;
+    CLRWDT();
+    SLEEP();
+    NOP();
+    WDTCONbits.SWDTEN = 0;
+
+    // 3. Flag de interrupo ativa antes do SLEEP: ele executou como NOP, o
+    // nTO no diz nada e nenhum tempo foi dormido
+    if(STATUSbits.nPD){
+        BAUDCONbits.WUE = 0;
+        __delay_ms(10);
+        return;
+    }
+    if(profundo) estat.profundos++;
+    else estat.leves++;
+
+    // 4. Despertar pelo WDT (nTO = 0): a linha RX continuou em repouso
+    if(!STATUSbits.nTO){
+        BAUDCONbits.WUE = 0;
+        SONO_CompensaRelogio(SONO_LEVE_MS);
+        __delay_ms(SONO_ACORDADO_MS);
+        return;
+    }
+
+    // 5. Despertar pela RX: o WUE  limpo pelo hardware no fim do byte, e o
+    // byte lido pela interrupo (0x00) inicia a viglia da UART. No sono
+    // profundo o tempo dormido  desconhecido e o relgio no  corrigido
+    estat.despertares++;
+    if(!profundo) SONO_CompensaRelogio(SONO_RX_MS);
+}
+
+const SonoEstatisticas* SONO_Estatisticas(void){
+    return &estat;
+}
+
+#endif
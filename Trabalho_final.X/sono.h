@@ -0,0 +1,71 @@
+/**
+ * @file sono.h
+ * @brief Economia de energia com a cabine estacionada (SLEEP entre os ciclos).
+ * @details O loop principal termina cada ciclo em SONO_Espera(), que substitui
+ * o __delay_ms(10). Com a cabine parada, sem chamadas e com a UART ociosa:
+ * - Sono leve: o WDT (LFINTOSC, 1:256) acorda o PIC aps ~8 ms e o ciclo
+ *   termina com 2 ms acordado, mantendo a cadncia de 10 ms do escalonador
+ *   e da telemetria. O relgio de ms  compensado pelo tempo dormido.
+ * - Sono profundo: sem nenhum canal de telemetria assinado ("$SG000" e demais
+ *   canais em 000), o WDT fica desligado e s a RX acorda o PIC.
+ * Nos dois modos BAUDCON.WUE fica ligado: a borda de descida do start bit
+ * acorda o PIC, mas esse primeiro byte  perdido (lido como 0x00). O host
+ * deve mandar um NUL (0x00) antes de cada quadro; o NUL  ignorado fora de
+ * quadro e, com o PIC acordado, no tem efeito. Aps um byte recebido o PIC
+ * fica acordado por #VIGILIA_RX ciclos para receber o restante do quadro.
+ * @note Habilitado apenas com SONO_HABILITADO = 1 (ex.: -DSONO_HABILITADO=1
+ * nas macros do projeto). Desligado, SONO_Espera()  o __delay_ms(10) de
+ * antes e a consulta "$?Z"  rejeitada como quadro invlido. Requer
+ * WDTE = SWDTEN nos bits de configurao (device_config.c).
+ */
+
+#ifndef SONO_H
+#define SONO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef SONO_HABILITADO
+#define SONO_HABILITADO 0
+#endif
+
+/**
+ * @brief Ciclos de 10 ms acordado aps o ltimo byte recebido (500 ms).
+ * @note Maior que o intervalo entre os bytes de um quadro e que o tempo de
+ * retransmisso do host (250 ms), que assim no paga um novo despertar.
+ */
+#define VIGILIA_RX  50
+
+
+#if SONO_HABILITADO
+
+/**
+ * @brief Contadores desde o reset (consulta "$?Z", voltam a 0 em 65536).
+ * - leves:      Entradas no sono leve (~8 ms cada).
+ * - profundos:  Entradas no sono profundo.
+ * - despertares: Despertares pela RX (BAUDCON.WUE), nos dois modos.
+ */
+typedef struct {
+    uint16_t leves;
+    uint16_t profundos;
+    uint16_t despertares;
+} SonoEstatisticas;
+
+/**
+ * @brief Encerra o ciclo do loop principal: dorme estacionado, seno espera 10 ms.
+ * @note Chamar apenas no loop principal, no lugar do __delay_ms(10).
+ */
+void SONO_Espera(void);
+
+/**
+ * @brief Contadores de sono desde o reset.
+ */
+const SonoEstatisticas* SONO_Estatisticas(void);
+
+#else
+
+#define SONO_Espera()   __delay_ms(10)
+
+#endif
+
+#endif	/* SONO_H */
@@ -0,0 +1,1025 @@
+/**
+ * @file analisador.c
+ * @brief Executável "elevlogic": análise offline de capturas do Saleae Logic 2.
+ * @details Lê a exportação de dados brutos do Logic 2 em uma única passada,
+ * sem carregar a captura na memória:
+ * - CSV ("Time [s],PWM,Dir,...", uma linha por transição de qualquer canal);
+ * - binário (um arquivo digital_N.bin por canal, intercalados por instante).
+ *
+ * Cada transição passa, em ordem de tempo, pelos decodificadores:
+ * - UART 8N1 nas linhas TX e RX (amostragem no meio do bit), montando os
+ *   quadros entre '$'/'#'/'&' e CR;
+ * - PWM: frequência e duty de cada período, partidas e paradas do motor;
+ * - encoder: pulsos, taxa em janelas de 100 ms (como o TMR4) e inércia;
+ * - sensores de andar S1-S4 (ativos em 0): tempo ativo e repiques.
+ *
+ * E mede as latências de ponta a ponta:
+ * - pedido -> PWM: do CR de um quadro de pedido na RX à partida do motor;
+ * - sensor -> parada: da borda de entrada em um andar ao desligamento do PWM.
+ * Com o marcador do firmware (PERFIL_MARCADOR), a latência do pedido é
+ * dividida em recepção (CR -> descida do marcador) e alinhamento ao PWM
+ * (subida do marcador -> partida).
+ */
+
+#include <ctype.h>
+#include <dirent.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+
+// CONFIGURAÇÃO
+
+/**
+ * @brief Sinais do elevador reconhecidos na captura.
+ * @note Nomes iguais aos das linhas dos presets em elevator1x4/preset_analisador
+ * (sem diferenciar maiúsculas), usados para mapear as colunas do CSV.
+ */
+#define SINAL_PWM   0
+#define SINAL_DIR   1
+#define SINAL_ENC   2
+#define SINAL_S1    3
+#define SINAL_S2    4
+#define SINAL_S3    5
+#define SINAL_S4    6
+#define SINAL_TX    7
+#define SINAL_RX    8
+#define SINAL_MARCA 9
+#define NUM_SINAIS  10
+#define SEM_SINAL   (-1)
+
+static const char* const nome_sinal[NUM_SINAIS] = {
+    "pwm", "dir", "enc", "s1", "s2", "s3", "s4", "tx", "rx", "marca"
+};
+
+/**
+ * @brief Canais usados quando a captura não traz nomes: preset EE_PF_Elevador_Mov
+ * (PWM, Dir, Enc, -, S1, S2, S3, S4).
+ */
+static const int8_t sinal_padrao[8] = {
+    SINAL_PWM, SINAL_DIR, SINAL_ENC, SEM_SINAL, SINAL_S1, SINAL_S2, SINAL_S3, SINAL_S4
+};
+
+/**
+ * @brief Limites da análise.
+ * - MAX_CANAIS:      Colunas do CSV ou arquivos binários aceitos.
+ * - JANELA_ENCODER:  Janela da taxa do encoder (a mesma do TMR4).
+ * - REPIQUE:         Pulsos de sensor mais curtos que isto são repiques.
+ * - LINHA_MAX:       Maior quadro UART guardado (o excedente é descartado).
+ * - BUFFER:          Leitura da entrada em blocos deste tamanho.
+ */
+#define MAX_CANAIS          16
+#define NS                  1000000000LL
+#define JANELA_ENCODER_NS   (100LL * 1000000)
+#define REPIQUE_NS          (5LL * 1000000)
+#define LINHA_MAX           64
+#define BUFFER              (1 << 20)
+#define BORDAS_GUARDADAS    8
+
+static struct {
+    int8_t canal[NUM_SINAIS];   // Canal escolhido com --canal (-1 = pelo nome/padrão)
+    uint32_t baud;              // Taxa das linhas TX e RX
+    int64_t pwm_periodo_ns;     // Período nominal do PWM
+    int64_t janela_ns;          // Maior latência aceita nos pares de eventos
+    int eventos;                // Linha do tempo dos eventos na saída
+} cfg = { { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 }, 19200, 512000, 500LL * 1000000, 0 };
+
+static int8_t sinal_coluna[MAX_CANAIS];
+
+static double Segundos(int64_t ns) {
+    return (double)ns * 1e-9;
+}
+
+static double Ms(int64_t ns) {
+    return (double)ns * 1e-6;
+}
+
+
+// AMOSTRAS DE LATÊNCIA
+
+typedef struct {
+    int64_t* v;
+    size_t n;
+    size_t cap;
+    uint64_t sem_par;   // Eventos de origem sem o evento esperado na janela
+} Amostras;
+
+static void Amostras_Adiciona(Amostras* a, int64_t ns) {
+    if (a->n == a->cap) {
+        a->cap = a->cap ? a->cap * 2 : 256;
+        a->v = realloc(a->v, a->cap * sizeof(*a->v));
+        if (!a->v) {
+            perror("realloc");
+            exit(2);
+        }
+    }
+    a->v[a->n++] = ns;
+}
+
+static int Compara(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void Amostras_Relata(const char* titulo, Amostras* a) {
+    printf("%-17s", titulo);
+    if (a->n == 0) {
+        printf(" sem amostras");
+    } else {
+        qsort(a->v, a->n, sizeof(*a->v), Compara);
+        double soma = 0;
+        for (size_t i = 0; i < a->n; i++) soma += (double)a->v[i];
+        printf(" %zu amostras, mín %.3f, p50 %.3f, p95 %.3f, máx %.3f, média %.3f ms",
+               a->n, Ms(a->v[0]), Ms(a->v[a->n / 2]), Ms(a->v[(a->n * 95) / 100]),
+               Ms(a->v[a->n - 1]), soma / (double)a->n * 1e-6);
+    }
+    if (a->sem_par) printf(" (%llu sem par)", (unsigned long long)a->sem_par);
+    printf("\n");
+}
+
+static Amostras lat_pedido;     // CR do pedido na RX -> partida do PWM
+static Amostras lat_parada;     // Borda de entrada no andar -> parada do PWM
+static Amostras lat_recepcao;   // CR do pedido na RX -> descida do marcador
+static Amostras lat_comando;    // Subida do marcador -> partida do PWM
+
+
+// UART
+
+/**
+ * @brief Decodificador 8N1 de uma linha.
+ * @note Amostra k (0 = start, 1-8 = dados, 9 = stop) no instante
+ * inicio + (k + 0,5) bits; o nível vale até a próxima transição.
+ */
+typedef struct {
+    const char* nome;
+    int nivel;
+    bool ocupado;
+    int64_t t_inicio;
+    int bit;
+    uint8_t dado;
+    uint64_t bytes;
+    uint64_t erros_quadro;
+    uint64_t falsos_inicios;
+    uint64_t quadros;
+    char linha[LINHA_MAX];
+    int n_linha;
+} Uart;
+
+static Uart tx = { .nome = "tx", .nivel = 1 };
+static Uart rx = { .nome = "rx", .nivel = 1 };
+
+static int64_t pedido_pendente = -1;    // CR do pedido mais antigo ainda sem partida
+static bool pedido_marcado = false;     // Marcador já desceu para o pedido pendente
+static int64_t t_comando = -1;          // Última subida do marcador (comando de partida)
+static uint64_t pedidos = 0;
+
+static int64_t Uart_Amostra(const Uart* u, int bit) {
+    return u->t_inicio + (int64_t)(((double)bit + 0.5) * 1e9 / cfg.baud);
+}
+
+static void Evento(int64_t t, const char* tipo, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+static bool Pwm_Ligado_Em(int64_t t);
+
+static bool Quadro_Pedido(const char* q) {
+    // "$OD", "$O1D1O2D2..." com "@SS" opcional: os demais comandos não movem a cabine
+    return q[0] == '$' && q[1] >= '0' && q[1] <= '3';
+}
+
+static void Uart_Quadro(Uart* u, int64_t t) {
+    u->linha[u->n_linha] = '\0';
+    u->quadros++;
+    if (cfg.eventos) Evento(t, u->nome, "%s", u->linha);
+
+    // Só os pedidos com o motor parado medem a partida; com pedidos seguidos vale o mais antigo
+    if (u == &rx && Quadro_Pedido(u->linha)) {
+        pedidos++;
+        if (pedido_pendente >= 0 && t - pedido_pendente > cfg.janela_ns) {
+            lat_pedido.sem_par++;
+            pedido_pendente = -1;
+        }
+        if (pedido_pendente < 0 && !Pwm_Ligado_Em(t)) {
+            pedido_pendente = t;
+            pedido_marcado = false;
+        }
+    }
+}
+
+static void Uart_Byte(Uart* u, uint8_t b, int64_t t) {
+    u->bytes++;
+    if (b == '$' || b == '#' || b == '&') {
+        u->n_linha = 0;
+        u->linha[u->n_linha++] = (char)b;
+    } else if (b == '\r') {
+        if (u->n_linha > 0) Uart_Quadro(u, t);
+        u->n_linha = 0;
+    } else if (u->n_linha > 0 && u->n_linha < LINHA_MAX - 1) {
+        u->linha[u->n_linha++] = (b >= 0x20 && b < 0x7F) ? (char)b : '.';
+    }
+}
+
+/**
+ * @brief Avalia as amostras anteriores a t com o nível atual da linha.
+ */
+static void Uart_Avanca(Uart* u, int64_t t) {
+    while (u->ocupado) {
+        int64_t ta = Uart_Amostra(u, u->bit);
+        if (ta >= t) return;
+
+        if (u->bit == 0) {
+            // Start que não dura meio bit: ruído
+            if (u->nivel) {
+                u->falsos_inicios++;
+                u->ocupado = false;
+                return;
+            }
+        } else if (u->bit <= 8) {
+            if (u->nivel) u->dado |= (uint8_t)(1u << (u->bit - 1));
+        } else {
+            if (u->nivel) Uart_Byte(u, u->dado, ta);
+            else u->erros_quadro++;
+            u->ocupado = false;
+            return;
+        }
+        u->bit++;
+    }
+}
+
+static void Uart_Transicao(Uart* u, int64_t t, int nivel) {
+    if (!u->ocupado && u->nivel && !nivel) {
+        u->ocupado = true;
+        u->t_inicio = t;
+        u->bit = 0;
+        u->dado = 0;
+    }
+    u->nivel = nivel;
+}
+
+
+// PWM, ENCODER E SENSORES
+
+static struct {
+    int nivel;
+    bool ligado;
+    int64_t t_subida;
+    int64_t t_descida;
+    int64_t periodo;        // Último período medido (0 = nenhum na partida atual)
+    int64_t t_partida;
+    uint64_t periodos;
+    double soma_periodo;
+    double soma_duty;
+    int64_t periodo_min, periodo_max;
+    double duty_min, duty_max;
+    uint64_t partidas[2];   // Por nível do DIR: [descendo, subindo]
+    int64_t tempo_ligado;
+} pwm;
+
+static int nivel_dir = 0;
+
+static struct {
+    int nivel;
+    uint64_t pulsos;
+    uint64_t pulsos_ligado;
+    int64_t t_subida;
+    int64_t intervalo_min;
+    int64_t janela;         // Índice da janela de 100 ms corrente
+    uint32_t na_janela;
+    uint32_t janela_max;
+    uint64_t inercia;       // Pulsos desde a última parada do PWM
+    uint64_t inercia_soma;
+    uint64_t inercia_max;
+    uint64_t paradas;       // Paradas com a inércia já contada
+    bool apos_parada;       // Contando a inércia de uma parada
+} enc = { .t_subida = -1, .intervalo_min = INT64_MAX, .janela = -1 };
+
+typedef struct {
+    int nivel;
+    int64_t t_ativo;
+    int64_t t_inativo;
+    uint64_t ativacoes;
+    uint64_t repiques;
+    int64_t ativo_min, ativo_max;
+} Sensor;
+
+static Sensor sensores[4];
+
+// Últimas bordas de entrada em um andar, para o par sensor -> parada
+static int64_t bordas[BORDAS_GUARDADAS];
+static int n_bordas = 0;
+
+static void Pwm_Parada(int64_t t) {
+    pwm.ligado = false;
+    pwm.tempo_ligado += t - pwm.t_partida;
+    if (cfg.eventos) Evento(t, "pwm", "desligado após %.3f s", Segundos(t - pwm.t_partida));
+
+    // Borda mais recente de sensor antes da parada, dentro da janela
+    int64_t melhor = -1;
+    for (int i = 0; i < n_bordas; i++) {
+        if (bordas[i] <= t && t - bordas[i] <= cfg.janela_ns && bordas[i] > melhor) melhor = bordas[i];
+    }
+    if (melhor >= 0) Amostras_Adiciona(&lat_parada, t - melhor);
+    else lat_parada.sem_par++;
+    n_bordas = 0;
+
+    enc.apos_parada = true;
+    enc.inercia = 0;
+}
+
+/**
+ * @brief Fecha a contagem de pulsos de inércia da última parada.
+ */
+static void Encoder_FechaInercia(void) {
+    if (!enc.apos_parada) return;
+    enc.inercia_soma += enc.inercia;
+    if (enc.inercia > enc.inercia_max) enc.inercia_max = enc.inercia;
+    enc.paradas++;
+    enc.apos_parada = false;
+}
+
+/**
+ * @brief PWM ligado no instante t, antes mesmo de a parada ser detectada.
+ * @note Com a linha em 0 além do fim do período, o próximo pulso já faltou.
+ */
+static bool Pwm_Ligado_Em(int64_t t) {
+    if (!pwm.ligado) return false;
+    if (pwm.nivel) return true;
+    int64_t periodo = pwm.periodo ? pwm.periodo : cfg.pwm_periodo_ns;
+    return t < pwm.t_subida + periodo + periodo / 2;
+}
+
+/**
+ * @brief Detecta a parada do PWM: nenhuma subida por 4 períodos nominais.
+ * @note A parada vale no início do período que deixou de ter pulso
+ * (ou na descida, se o duty era 100%).
+ */
+static void Pwm_Avanca(int64_t t) {
+    if (!pwm.ligado || pwm.nivel) return;
+    if (t - pwm.t_subida <= 4 * cfg.pwm_periodo_ns) return;
+    int64_t periodo = pwm.periodo ? pwm.periodo : cfg.pwm_periodo_ns;
+    int64_t fim = pwm.t_subida + periodo;
+    Pwm_Parada(pwm.t_descida > fim ? pwm.t_descida : fim);
+}
+
+static void Pwm_Transicao(int64_t t, int nivel) {
+    pwm.nivel = nivel;
+    if (!nivel) {
+        pwm.t_descida = t;
+        return;
+    }
+
+    if (!pwm.ligado) {
+        pwm.ligado = true;
+        pwm.t_partida = t;
+        pwm.periodo = 0;
+        pwm.partidas[nivel_dir]++;
+        Encoder_FechaInercia();
+        if (cfg.eventos) Evento(t, "pwm", "ligado, %s", nivel_dir ? "subindo" : "descendo");
+        if (pedido_pendente >= 0) {
+            if (t - pedido_pendente <= cfg.janela_ns) Amostras_Adiciona(&lat_pedido, t - pedido_pendente);
+            else lat_pedido.sem_par++;
+            pedido_pendente = -1;
+        }
+        if (t_comando >= 0 && t - t_comando <= cfg.janela_ns) Amostras_Adiciona(&lat_comando, t - t_comando);
+        t_comando = -1;
+    } else {
+        int64_t periodo = t - pwm.t_subida;
+        double duty = (double)(pwm.t_descida - pwm.t_subida) / (double)periodo;
+        if (pwm.periodos == 0 || periodo < pwm.periodo_min) pwm.periodo_min = periodo;
+        if (pwm.periodos == 0 || periodo > pwm.periodo_max) pwm.periodo_max = periodo;
+        if (pwm.periodos == 0 || duty < pwm.duty_min) pwm.duty_min = duty;
+        if (pwm.periodos == 0 || duty > pwm.duty_max) pwm.duty_max = duty;
+        pwm.soma_periodo += (double)periodo;
+        pwm.soma_duty += duty;
+        pwm.periodos++;
+        pwm.periodo = periodo;
+    }
+    pwm.t_subida = t;
+}
+
+static void Encoder_Transicao(int64_t t, int nivel) {
+    enc.nivel = nivel;
+    if (!nivel) return;
+
+    enc.pulsos++;
+    if (Pwm_Ligado_Em(t)) enc.pulsos_ligado++;
+    else if (enc.apos_parada) enc.inercia++;
+    if (enc.t_subida >= 0 && t - enc.t_subida < enc.intervalo_min) enc.intervalo_min = t - enc.t_subida;
+    enc.t_subida = t;
+
+    int64_t janela = t / JANELA_ENCODER_NS;
+    if (janela != enc.janela) {
+        enc.janela = janela;
+        enc.na_janela = 0;
+    }
+    if (++enc.na_janela > enc.janela_max) enc.janela_max = enc.na_janela;
+}
+
+static void Sensor_Transicao(int andar, int64_t t, int nivel) {
+    Sensor* s = &sensores[andar];
+    s->nivel = nivel;
+
+    if (!nivel) {
+        // Entrada no andar (A3144 puxa a linha para 0)
+        s->ativacoes++;
+        if (s->t_inativo >= 0 && s->ativacoes > 1 && t - s->t_inativo < REPIQUE_NS) s->repiques++;
+        s->t_ativo = t;
+        if (n_bordas == BORDAS_GUARDADAS) {
+            memmove(bordas, bordas + 1, sizeof(bordas[0]) * (BORDAS_GUARDADAS - 1));
+            n_bordas--;
+        }
+        bordas[n_bordas++] = t;
+        if (cfg.eventos) Evento(t, nome_sinal[SINAL_S1 + andar], "ativo");
+    } else if (s->ativacoes) {
+        int64_t largura = t - s->t_ativo;
+        if (largura < REPIQUE_NS) s->repiques++;
+        if (s->ativacoes == 1 || largura < s->ativo_min) s->ativo_min = largura;
+        if (largura > s->ativo_max) s->ativo_max = largura;
+        s->t_inativo = t;
+        if (cfg.eventos) Evento(t, nome_sinal[SINAL_S1 + andar], "inativo após %.1f ms", Ms(largura));
+    }
+}
+
+
+/**
+ * @brief Marcador do firmware: 0 ao executar um pedido, 1 ao comandar a partida.
+ */
+static void Marca_Transicao(int64_t t, int nivel) {
+    if (!nivel) {
+        if (pedido_pendente >= 0 && !pedido_marcado && t - pedido_pendente <= cfg.janela_ns) {
+            Amostras_Adiciona(&lat_recepcao, t - pedido_pendente);
+            pedido_marcado = true;
+        }
+        if (cfg.eventos) Evento(t, "marc", "pedido executado");
+    } else {
+        t_comando = t;
+        if (cfg.eventos) Evento(t, "marc", "partida comandada");
+    }
+}
+
+
+// LINHA DO TEMPO
+
+static int64_t t_primeiro = INT64_MIN;
+static int64_t t_ultimo = 0;
+static uint64_t transicoes = 0;
+static bool presente[NUM_SINAIS];
+
+static void Evento(int64_t t, const char* tipo, const char* fmt, ...) {
+    va_list ap;
+    printf("%14.6f %-4s ", Segundos(t), tipo);
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    printf("\n");
+}
+
+/**
+ * @brief Leva os decodificadores com estado temporal até o instante t.
+ * @details Chamado antes de cada transição de qualquer canal, para que bytes
+ * e paradas sejam emitidos na ordem de tempo em relação aos demais sinais.
+ */
+static void Avanca(int64_t t) {
+    Uart_Avanca(&tx, t);
+    Uart_Avanca(&rx, t);
+    Pwm_Avanca(t);
+}
+
+/**
+ * @brief Nível do sinal no início da captura (não conta como transição).
+ */
+static void Inicia(int sinal, int64_t t, int nivel) {
+    if (sinal == SEM_SINAL) return;
+    presente[sinal] = true;
+    if (t_primeiro == INT64_MIN || t < t_primeiro) t_primeiro = t;
+
+    switch (sinal) {
+        case SINAL_PWM: pwm.nivel = nivel; if (nivel) { pwm.ligado = true; pwm.t_partida = pwm.t_subida = t; } break;
+        case SINAL_DIR: nivel_dir = nivel; break;
+        case SINAL_ENC: enc.nivel = nivel; break;
+        case SINAL_TX:  tx.nivel = nivel; break;
+        case SINAL_RX:  rx.nivel = nivel; break;
+        case SINAL_MARCA: break;
+        default:
+            sensores[sinal - SINAL_S1].nivel = nivel;
+            sensores[sinal - SINAL_S1].t_ativo = t;
+            sensores[sinal - SINAL_S1].t_inativo = -1;
+            break;
+    }
+}
+
+static void Transicao(int sinal, int64_t t, int nivel) {
+    if (sinal == SEM_SINAL) return;
+    Avanca(t);
+    transicoes++;
+    t_ultimo = t;
+
+    switch (sinal) {
+        case SINAL_PWM: Pwm_Transicao(t, nivel); break;
+        case SINAL_DIR: nivel_dir = nivel; break;
+        case SINAL_ENC: Encoder_Transicao(t, nivel); break;
+        case SINAL_TX:  Uart_Transicao(&tx, t, nivel); break;
+        case SINAL_RX:  Uart_Transicao(&rx, t, nivel); break;
+        case SINAL_MARCA: Marca_Transicao(t, nivel); break;
+        default:        Sensor_Transicao(sinal - SINAL_S1, t, nivel); break;
+    }
+}
+
+/**
+ * @brief Fim da captura: conclui os bytes em andamento e o PWM ligado.
+ */
+static void Finaliza(int64_t t) {
+    // A linha fica no último nível: conclui o byte cujo stop é a última transição
+    int64_t byte_ns = (int64_t)(11e9 / cfg.baud);
+    Uart_Avanca(&tx, t + byte_ns);
+    Uart_Avanca(&rx, t + byte_ns);
+    Avanca(t);
+    if (pwm.ligado) pwm.tempo_ligado += t - pwm.t_partida;
+    else Encoder_FechaInercia();
+    if (pedido_pendente >= 0) lat_pedido.sem_par++;
+}
+
+
+// MAPEAMENTO DAS COLUNAS
+
+static int Sinal_Por_Nome(const char* nome) {
+    for (int s = 0; s < NUM_SINAIS; s++) {
+        if (!strcasecmp(nome, nome_sinal[s])) return s;
+    }
+    return SEM_SINAL;
+}
+
+/**
+ * @brief Define o sinal de cada coluna: --canal, depois o nome, depois o preset Mov.
+ * @param nomes Nomes das colunas (NULL sem nomes, como nos arquivos binários).
+ */
+static void Mapeia(char* const* nomes, int n) {
+    bool algum = false;
+    for (int c = 0; c < MAX_CANAIS; c++) sinal_coluna[c] = SEM_SINAL;
+
+    if (nomes) {
+        for (int c = 0; c < n; c++) {
+            sinal_coluna[c] = (int8_t)Sinal_Por_Nome(nomes[c]);
+            if (sinal_coluna[c] != SEM_SINAL) algum = true;
+        }
+    }
+    if (!algum) {
+        for (int c = 0; c < n && c < 8; c++) sinal_coluna[c] = sinal_padrao[c];
+    }
+
+    for (int s = 0; s < NUM_SINAIS; s++) {
+        if (cfg.canal[s] < 0) continue;
+        for (int c = 0; c < MAX_CANAIS; c++) {
+            if (sinal_coluna[c] == s) sinal_coluna[c] = SEM_SINAL;
+        }
+        sinal_coluna[cfg.canal[s]] = (int8_t)s;
+    }
+}
+
+
+// ENTRADA CSV
+
+/**
+ * @brief Converte "s.fffffffff" em ns sem passar por double.
+ * @return false se o texto não for um instante relativo em segundos.
+ */
+static bool Le_Instante(const char* p, const char* fim, int64_t* ns) {
+    bool negativo = false;
+    int64_t seg = 0, frac = 0, escala = NS;
+    if (p < fim && *p == '-') { negativo = true; p++; }
+    if (p == fim || !isdigit((unsigned char)*p)) return false;
+    while (p < fim && isdigit((unsigned char)*p)) seg = seg * 10 + (*p++ - '0');
+    if (p < fim && *p == '.') {
+        p++;
+        while (p < fim && isdigit((unsigned char)*p)) {
+            if (escala > 1) {
+                escala /= 10;
+                frac += (*p - '0') * escala;
+            }
+            p++;
+        }
+    }
+    if (p != fim) return false;
+    *ns = seg * NS + frac;
+    if (negativo) *ns = -*ns;
+    return true;
+}
+
+static uint64_t bytes_lidos = 0;
+
+/**
+ * @param inicio Bytes já lidos da entrada para reconhecer o formato.
+ */
+static int Processa_Csv(FILE* f, const char* nome_arquivo, const char* inicio, size_t n_inicio) {
+    static char buf[BUFFER + 1];
+    size_t cheio = n_inicio;
+    bool cabecalho = true;
+    int colunas = 0;
+    int nivel[MAX_CANAIS];
+    bool primeira = true;
+    uint64_t linha = 0;
+
+    memcpy(buf, inicio, n_inicio);
+    bytes_lidos = n_inicio;
+    for (;;) {
+        size_t lidos = fread(buf + cheio, 1, BUFFER - cheio, f);
+        cheio += lidos;
+        bytes_lidos += lidos;
+        bool eof = (lidos == 0);
+        if (eof && cheio == 0) break;
+        if (eof) buf[cheio++] = '\n';   // Última linha sem terminador
+
+        char* p = buf;
+        char* fim = buf + cheio;
+        for (;;) {
+            char* nl = memchr(p, '\n', (size_t)(fim - p));
+            if (!nl) break;
+            char* fl = nl;
+            if (fl > p && fl[-1] == '\r') fl--;
+            linha++;
+
+            if (fl == p) { p = nl + 1; continue; }
+
+            if (cabecalho) {
+                // "Time [s],Nome 0,Nome 1,...": nomes dos canais no Logic 2
+                char* nomes[MAX_CANAIS];
+                *fl = '\0';
+                char* campo = strchr(p, ',');
+                while (campo && colunas < MAX_CANAIS) {
+                    *campo++ = '\0';
+                    nomes[colunas++] = campo;
+                    campo = strchr(campo, ',');
+                }
+                if (colunas == 0) {
+                    fprintf(stderr, "%s: cabeçalho sem canais\n", nome_arquivo);
+                    return 2;
+                }
+                for (int c = 0; c < colunas; c++) {
+                    while (*nomes[c] == ' ') nomes[c]++;
+                }
+                Mapeia(nomes, colunas);
+                cabecalho = false;
+                p = nl + 1;
+                continue;
+            }
+
+            char* virgula = memchr(p, ',', (size_t)(fl - p));
+            int64_t t;
+            if (!virgula || !Le_Instante(p, virgula, &t)) {
+                fprintf(stderr, "%s:%llu: instante inválido (exporte com tempos relativos em segundos)\n",
+                        nome_arquivo, (unsigned long long)linha);
+                return 2;
+            }
+
+            int c = 0;
+            char* q = virgula + 1;
+            while (q < fl && c < colunas) {
+                int v = (*q == '1');
+                if (primeira) {
+                    nivel[c] = v;
+                    Inicia(sinal_coluna[c], t, v);
+                } else if (v != nivel[c]) {
+                    nivel[c] = v;
+                    Transicao(sinal_coluna[c], t, v);
+                }
+                c++;
+                while (q < fl && *q != ',') q++;
+                q++;
+            }
+            primeira = false;
+            t_ultimo = t;
+            p = nl + 1;
+        }
+
+        cheio = (size_t)(fim - p);
+        memmove(buf, p, cheio);
+        if (eof) break;
+        if (cheio == BUFFER) {
+            fprintf(stderr, "%s:%llu: linha longa demais\n", nome_arquivo, (unsigned long long)linha);
+            return 2;
+        }
+    }
+
+    if (ferror(f)) {
+        perror(nome_arquivo);
+        return 2;
+    }
+    if (cabecalho || primeira) {
+        fprintf(stderr, "%s: captura vazia\n", nome_arquivo);
+        return 2;
+    }
+    return 0;
+}
+
+
+// ENTRADA BINÁRIA
+
+/**
+ * @brief Canal de um arquivo digital_N.bin exportado pelo Logic 2.
+ * @details Cabeçalho "<SALEAE>", versão (0 ou 1), tipo (0 = digital), nível
+ * inicial, instantes de início e fim e quantidade de transições, seguidos de
+ * um double por transição (segundos). Os arquivos são lidos juntos, sempre
+ * consumindo a transição mais antiga entre eles.
+ */
+typedef struct {
+    FILE* f;
+    const char* nome;
+    int sinal;
+    int nivel;
+    uint64_t restantes;
+    int64_t proxima;
+    double bloco[4096];
+    size_t n_bloco;
+    size_t i_bloco;
+} Binario;
+
+#pragma pack(push, 1)
+typedef struct {
+    char identificador[8];
+    int32_t versao;
+    int32_t tipo;
+    uint32_t nivel_inicial;
+    double inicio;
+    double fim;
+    uint64_t transicoes;
+} CabecalhoBinario;
+#pragma pack(pop)
+
+static bool Binario_Proxima(Binario* b) {
+    if (b->restantes == 0) return false;
+    if (b->i_bloco == b->n_bloco) {
+        size_t pedir = sizeof(b->bloco) / sizeof(b->bloco[0]);
+        if (pedir > b->restantes) pedir = (size_t)b->restantes;
+        b->n_bloco = fread(b->bloco, sizeof(double), pedir, b->f);
+        b->i_bloco = 0;
+        if (b->n_bloco == 0) {
+            fprintf(stderr, "%s: arquivo truncado\n", b->nome);
+            b->restantes = 0;
+            return false;
+        }
+    }
+    b->proxima = llround(b->bloco[b->i_bloco++] * 1e9);
+    b->restantes--;
+    return true;
+}
+
+static int Canal_Do_Arquivo(const char* caminho, int posicao) {
+    const char* base = strrchr(caminho, '/');
+    base = base ? base + 1 : caminho;
+    const char* d = strstr(base, "digital_");
+    if (d && isdigit((unsigned char)d[8])) return atoi(d + 8);
+    return posicao;
+}
+
+static int Processa_Binarios(char** caminhos, int n) {
+    Binario* b = calloc((size_t)n, sizeof(Binario));
+    int ativos = 0;
+    int64_t fim_captura = INT64_MIN;
+
+    Mapeia(NULL, MAX_CANAIS);
+    for (int i = 0; i < n; i++) {
+        CabecalhoBinario h;
+        b[i].nome = caminhos[i];
+        b[i].f = fopen(caminhos[i], "rb");
+        if (!b[i].f) {
+            perror(caminhos[i]);
+            return 2;
+        }
+        if (fread(&h, sizeof(h), 1, b[i].f) != 1 || memcmp(h.identificador, "<SALEAE>", 8)) {
+            fprintf(stderr, "%s: não é uma exportação binária do Logic 2\n", caminhos[i]);
+            return 2;
+        }
+        if (h.versao < 0 || h.versao > 1 || h.tipo != 0) {
+            fprintf(stderr, "%s: versão %d, tipo %d: apenas canais digitais (versão 0 ou 1)\n",
+                    caminhos[i], h.versao, h.tipo);
+            return 2;
+        }
+        int canal = Canal_Do_Arquivo(caminhos[i], i);
+        if (canal < 0 || canal >= MAX_CANAIS) {
+            fprintf(stderr, "%s: canal %d fora da faixa\n", caminhos[i], canal);
+            return 2;
+        }
+        b[i].sinal = sinal_coluna[canal];
+        b[i].nivel = h.nivel_inicial ? 1 : 0;
+        b[i].restantes = h.transicoes;
+        Inicia(b[i].sinal, llround(h.inicio * 1e9), b[i].nivel);
+        if (llround(h.fim * 1e9) > fim_captura) fim_captura = llround(h.fim * 1e9);
+        bytes_lidos += sizeof(h);
+        if (Binario_Proxima(&b[i])) ativos++;
+        else b[i].proxima = INT64_MAX;
+    }
+
+    while (ativos) {
+        int m = 0;
+        for (int i = 1; i < n; i++) {
+            if (b[i].proxima < b[m].proxima) m = i;
+        }
+        b[m].nivel ^= 1;
+        Transicao(b[m].sinal, b[m].proxima, b[m].nivel);
+        bytes_lidos += sizeof(double);
+        if (!Binario_Proxima(&b[m])) {
+            b[m].proxima = INT64_MAX;
+            ativos--;
+        }
+    }
+    if (fim_captura > t_ultimo) t_ultimo = fim_captura;
+
+    for (int i = 0; i < n; i++) fclose(b[i].f);
+    free(b);
+    return 0;
+}
+
+/**
+ * @brief Expande uma pasta da exportação binária nos seus arquivos digital_N.bin.
+ */
+static int Lista_Pasta(const char* pasta, char** saida, int max) {
+    DIR* d = opendir(pasta);
+    if (!d) return -1;
+    int n = 0;
+    struct dirent* e;
+    while ((e = readdir(d)) != NULL && n < max) {
+        if (strncmp(e->d_name, "digital_", 8) || !strstr(e->d_name, ".bin")) continue;
+        size_t tam = strlen(pasta) + strlen(e->d_name) + 2;
+        saida[n] = malloc(tam);
+        snprintf(saida[n], tam, "%s/%s", pasta, e->d_name);
+        n++;
+    }
+    closedir(d);
+    return n;
+}
+
+
+// RELATÓRIO
+
+static void Relata(double real_s) {
+    double duracao = Segundos(t_ultimo - t_primeiro);
+    printf("captura:          %.3f s, %llu transições", duracao, (unsigned long long)transicoes);
+    if (real_s > 0) {
+        printf(" (%.2f s reais", real_s);
+        if (bytes_lidos) printf(", %.0f MB/s", (double)bytes_lidos / real_s / 1e6);
+        printf(")");
+    }
+    printf("\n");
+
+    printf("sinais:          ");
+    for (int s = 0; s < NUM_SINAIS; s++) {
+        if (presente[s]) printf(" %s", nome_sinal[s]);
+    }
+    printf("\n");
+
+    if (presente[SINAL_PWM]) {
+        printf("pwm:              %llu partidas (%llu subindo, %llu descendo), %.3f s ligado\n",
+               (unsigned long long)(pwm.partidas[0] + pwm.partidas[1]),
+               (unsigned long long)pwm.partidas[1], (unsigned long long)pwm.partidas[0],
+               Segundos(pwm.tempo_ligado));
+        if (pwm.periodos) {
+            printf("                  %.1f Hz (%.1f-%.1f), duty %.1f%% (%.1f-%.1f%%), %llu períodos\n",
+                   1e9 * (double)pwm.periodos / pwm.soma_periodo,
+                   1e9 / (double)pwm.periodo_max, 1e9 / (double)pwm.periodo_min,
+                   100.0 * pwm.soma_duty / (double)pwm.periodos,
+                   100.0 * pwm.duty_min, 100.0 * pwm.duty_max, (unsigned long long)pwm.periodos);
+        }
+    }
+
+    if (presente[SINAL_ENC]) {
+        printf("encoder:          %llu pulsos, máx %.0f pulsos/s (janela de 100 ms)",
+               (unsigned long long)enc.pulsos, enc.janela_max * (double)NS / JANELA_ENCODER_NS);
+        if (pwm.tempo_ligado > 0) printf(", média %.1f pulsos/s com o PWM ligado",
+                                         (double)enc.pulsos_ligado / Segundos(pwm.tempo_ligado));
+        printf("\n");
+        if (enc.intervalo_min != INT64_MAX) {
+            printf("                  menor intervalo %.3f ms", Ms(enc.intervalo_min));
+            if (enc.paradas) printf(", inércia após a parada %.1f pulsos (máx %llu)",
+                                    (double)enc.inercia_soma / (double)enc.paradas,
+                                        (unsigned long long)enc.inercia_max);
+            printf("\n");
+        }
+    }
+
+    for (int a = 0; a < 4; a++) {
+        Sensor* s = &sensores[a];
+        if (!presente[SINAL_S1 + a]) continue;
+        printf("%s:               %llu ativações", nome_sinal[SINAL_S1 + a], (unsigned long long)s->ativacoes);
+        if (s->ativacoes) printf(", ativo %.1f-%.1f ms", Ms(s->ativo_min), Ms(s->ativo_max));
+        if (s->repiques) printf(", %llu repiques (< %lld ms)", (unsigned long long)s->repiques, REPIQUE_NS / 1000000);
+        printf("\n");
+    }
+
+    Uart* linhas[2] = { &tx, &rx };
+    for (int i = 0; i < 2; i++) {
+        Uart* u = linhas[i];
+        if (!presente[i ? SINAL_RX : SINAL_TX]) continue;
+        printf("%s:               %llu bytes, %llu quadros", u->nome,
+               (unsigned long long)u->bytes, (unsigned long long)u->quadros);
+        if (u == &rx) printf(" (%llu pedidos)", (unsigned long long)pedidos);
+        if (u->erros_quadro) printf(", %llu erros de quadro", (unsigned long long)u->erros_quadro);
+        if (u->falsos_inicios) printf(", %llu falsos inícios", (unsigned long long)u->falsos_inicios);
+        printf("\n");
+    }
+
+    if (presente[SINAL_RX] && presente[SINAL_PWM]) Amostras_Relata("pedido -> pwm:", &lat_pedido);
+    if (presente[SINAL_RX] && presente[SINAL_MARCA]) Amostras_Relata("pedido -> marca:", &lat_recepcao);
+    if (presente[SINAL_MARCA] && presente[SINAL_PWM]) Amostras_Relata("marca -> pwm:", &lat_comando);
+    if (presente[SINAL_PWM] && (presente[SINAL_S1] || presente[SINAL_S2] ||
+                                presente[SINAL_S3] || presente[SINAL_S4])) {
+        Amostras_Relata("sensor -> parada:", &lat_parada);
+    }
+}
+
+
+// PROGRAMA
+
+static double Relogio_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static void Uso(const char* prog) {
+    fprintf(stderr,
+        "uso: %s [opções] captura.csv | - | digital_N.bin... | pasta\n"
+        "  --canal SINAL=N    canal N para SINAL (pwm, dir, enc, s1-s4, tx, rx, marca)\n"
+        "  --baud B           taxa da UART (padrão 19200)\n"
+        "  --pwm-periodo US   período nominal do PWM em µs (padrão 512)\n"
+        "  --janela MS        maior latência aceita nos pares de eventos (padrão 500)\n"
+        "  -e                 linha do tempo dos eventos antes do relatório\n", prog);
+}
+
+static bool Le_Canal(const char* v) {
+    char nome[8];
+    const char* igual = strchr(v, '=');
+    if (!igual || igual == v || (size_t)(igual - v) >= sizeof(nome)) return false;
+    memcpy(nome, v, (size_t)(igual - v));
+    nome[igual - v] = '\0';
+    int s = Sinal_Por_Nome(nome);
+    int c = atoi(igual + 1);
+    if (s == SEM_SINAL || !isdigit((unsigned char)igual[1]) || c >= MAX_CANAIS) return false;
+    cfg.canal[s] = (int8_t)c;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    char* entradas[MAX_CANAIS];
+    int n_entradas = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!strcmp(a, "--canal") && v) { if (!Le_Canal(v)) { Uso(argv[0]); return 2; } i++; }
+        else if (!strcmp(a, "--baud") && v) { cfg.baud = (uint32_t)strtoul(v, NULL, 10); i++; }
+        else if (!strcmp(a, "--pwm-periodo") && v) { cfg.pwm_periodo_ns = (int64_t)(atof(v) * 1000); i++; }
+        else if (!strcmp(a, "--janela") && v) { cfg.janela_ns = (int64_t)(atof(v) * 1e6); i++; }
+        else if (!strcmp(a, "-e")) cfg.eventos = 1;
+        else if ((a[0] != '-' || !strcmp(a, "-")) && n_entradas < MAX_CANAIS) entradas[n_entradas++] = argv[i];
+        else { Uso(argv[0]); return 2; }
+    }
+    if (n_entradas == 0 || cfg.baud == 0 || cfg.pwm_periodo_ns <= 0 || cfg.janela_ns <= 0) {
+        Uso(argv[0]);
+        return 2;
+    }
+
+    // Pasta da exportação binária
+    if (n_entradas == 1 && strcmp(entradas[0], "-")) {
+        int n = Lista_Pasta(entradas[0], entradas, MAX_CANAIS);
+        if (n == 0) {
+            fprintf(stderr, "%s: nenhum digital_N.bin na pasta\n", entradas[0]);
+            return 2;
+        }
+        if (n > 0) n_entradas = n;
+    }
+
+    double inicio = Relogio_s();
+    int rc;
+
+    FILE* f = strcmp(entradas[0], "-") ? fopen(entradas[0], "rb") : stdin;
+    if (!f) {
+        perror(entradas[0]);
+        return 2;
+    }
+    char assinatura[8];
+    size_t n = fread(assinatura, 1, sizeof(assinatura), f);
+    bool binario = (n == sizeof(assinatura) && !memcmp(assinatura, "<SALEAE>", 8));
+
+    if (binario && f == stdin) {
+        fprintf(stderr, "stdin: a exportação binária deve ser lida dos arquivos digital_N.bin\n");
+        return 2;
+    } else if (binario) {
+        fclose(f);
+        rc = Processa_Binarios(entradas, n_entradas);
+    } else if (n_entradas > 1) {
+        fprintf(stderr, "%s: várias entradas só são aceitas na exportação binária\n", entradas[0]);
+        return 2;
+    } else {
+        rc = Processa_Csv(f, f == stdin ? "stdin" : entradas[0], assinatura, n);
+        if (f != stdin) fclose(f);
+    }
+    if (rc) return rc;
+
+    Finaliza(t_ultimo);
+    Relata(Relogio_s() - inicio);
+    return 0;
+}
@@ -0,0 +1,647 @@
+/**
+ * @file distribuidor.c
+ * @brief Executável "elevdist": compartilha uma serial do elevador entre vários programas.
+ * @details Abre a serial da placa (--dispositivo) ou executa o simulador em
+ * uma pty (após "--") e distribui cada linha recebida (telemetria '$',
+ * respostas '#', gravação '&') a todos os clientes:
+ * - conexões ao socket Unix (--socket), com o mesmo fluxo de bytes da serial;
+ * - portas seriais virtuais (--pty LINK), ptys cujo lado escravo é apontado
+ *   por LINK e abre como uma serial comum (ex.: no aplicativo em Python).
+ *
+ * As linhas são separadas no próprio buffer de leitura e escritas dali para
+ * cada cliente, sem cópia; só o que um cliente lento não absorve vai para o
+ * buffer dele (ou é descartado quando este enche).
+ *
+ * No sentido contrário, os quadros "$...<CR>" dos clientes são multiplexados
+ * para a placa:
+ * - cada cliente tem um limite de quadros por segundo (balde de fichas);
+ *   quadros acima do limite são descartados, com "#N,SS,L" se sequenciados;
+ * - os quadros vão para a placa espaçados de --intervalo, para não estourar
+ *   o anel de 32 bytes da RX do firmware, cada um precedido de um NUL que
+ *   acorda o PIC estacionado (firmware com SONO_HABILITADO) sem ser perdido;
+ * - a sequência "@SS" é trocada por uma sequência própria do distribuidor,
+ *   para que quadros de clientes diferentes com a mesma sequência não sejam
+ *   tomados por retransmissões pelo firmware; o "#K"/"#N" da resposta volta
+ *   só ao cliente de origem, com a sequência original. Uma retransmissão do
+ *   cliente (mesma sequência em até 2 s) reaproveita a sequência própria e
+ *   continua sendo reconhecida como tal pelo firmware. Só a última sequência
+ *   de cada cliente é lembrada: o cliente aguarda o "#K"/"#N" antes do
+ *   próximo quadro sequenciado, como a interface em Python.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+
+// CONFIGURAÇÃO
+
+/**
+ * @brief Limites do distribuidor.
+ * - MAX_CLIENTES:  Conexões ao socket e ptys simultâneas.
+ * - MAX_PTYS:      Portas seriais virtuais (--pty).
+ * - QUADRO_MAX:    Caracteres entre '$' e CR aceitos do cliente (o mesmo do firmware).
+ * - ENTRADA:       Buffer de leitura da placa (linhas maiores são descartadas).
+ * - SAIDA:         Buffer de cada cliente de socket que não absorve as linhas na hora.
+ * - FILA:          Quadros aguardando a vez de ir para a placa.
+ * - JANELA_RETX:   Janela de retransmissão do firmware (JANELA_SEQUENCIA, 2 s).
+ * - BYTE_US:       Tempo de um byte a 19200 bps, 8N1.
+ */
+#define MAX_CLIENTES    32
+#define MAX_PTYS        8
+#define QUADRO_MAX      13
+#define ENTRADA         4096
+#define SAIDA           8192
+#define FILA            64
+#define JANELA_RETX_US  2000000ULL
+#define BYTE_US         521
+
+static struct {
+    const char* socket;         // Caminho do socket Unix
+    const char* dispositivo;    // Serial da placa (NULL = simulador)
+    char** simulador;           // Comando do simulador (argv após "--")
+    const char* pty[MAX_PTYS];  // Links das portas virtuais
+    int n_pty;
+    double limite;              // Quadros por segundo por cliente
+    double rajada;              // Quadros seguidos aceitos acima do limite médio
+    uint32_t intervalo_us;      // Espaço mínimo entre quadros na placa
+    bool verboso;
+} cfg = { "/tmp/elevador.sock", NULL, NULL, { NULL }, 0, 10.0, 5.0, 20000, false };
+
+static volatile sig_atomic_t encerrar = 0;
+
+static uint64_t Agora_us(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000u + (uint64_t)t.tv_nsec / 1000u;
+}
+
+static void Log(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+
+// CLIENTES
+
+#define CLIENTE_LIVRE   0
+#define CLIENTE_SOCKET  1
+#define CLIENTE_PTY     2
+
+typedef struct {
+    int tipo;
+    int fd;
+    int escravo;                // PTY: lado escravo, mantido aberto (sem leitor o mestre daria EIO)
+    const char* link;           // PTY: link para o lado escravo
+    uint32_t geracao;           // Distingue ocupantes sucessivos da mesma posição
+    // Quadro em montagem
+    char quadro[QUADRO_MAX + 1];
+    int n_quadro;               // -1 = fora de quadro
+    // Linhas pendentes (socket sem espaço)
+    uint8_t saida[SAIDA];
+    size_t n_saida;
+    // Balde de fichas
+    double fichas;
+    uint64_t t_fichas;
+    // Última sequência encaminhada, para reconhecer retransmissões
+    int seq_cliente;            // -1 = nenhuma
+    uint8_t seq_propria;
+    uint64_t t_seq;
+    // Estatísticas
+    uint64_t linhas, descartadas, quadros, limitados;
+} Cliente;
+
+static Cliente clientes[MAX_CLIENTES];
+static uint32_t proxima_geracao = 1;
+
+/**
+ * @brief Dono de cada sequência própria em uso: a quem devolver o ACK/NAK.
+ */
+static struct {
+    int cliente;                // -1 = livre
+    uint32_t geracao;
+    uint8_t seq_cliente;
+} donos[256];
+static uint8_t proxima_seq = 0;
+
+static uint64_t linhas_recebidas = 0;
+static uint64_t quadros_enviados = 0;
+
+static const char* Nome_Cliente(int i) {
+    static char nome[64];
+    if (clientes[i].tipo == CLIENTE_PTY) snprintf(nome, sizeof(nome), "pty %s", clientes[i].link);
+    else snprintf(nome, sizeof(nome), "cliente %d", i);
+    return nome;
+}
+
+static int Novo_Cliente(int tipo, int fd) {
+    for (int i = 0; i < MAX_CLIENTES; i++) {
+        Cliente* c = &clientes[i];
+        if (c->tipo != CLIENTE_LIVRE) continue;
+        memset(c, 0, sizeof(*c));
+        c->tipo = tipo;
+        c->fd = fd;
+        c->escravo = -1;
+        c->geracao = proxima_geracao++;
+        c->n_quadro = -1;
+        c->fichas = cfg.rajada;
+        c->t_fichas = Agora_us();
+        c->seq_cliente = -1;
+        return i;
+    }
+    return -1;
+}
+
+static void Fecha_Cliente(int i) {
+    Cliente* c = &clientes[i];
+    Log("%s: desconectado (%llu linhas, %llu descartadas, %llu quadros, %llu acima do limite)\n",
+        Nome_Cliente(i), (unsigned long long)c->linhas, (unsigned long long)c->descartadas,
+        (unsigned long long)c->quadros, (unsigned long long)c->limitados);
+    close(c->fd);
+    if (c->escravo >= 0) close(c->escravo);
+    c->tipo = CLIENTE_LIVRE;
+}
+
+/**
+ * @brief Escreve uma linha completa para o cliente, sem bloquear.
+ * @details Socket: o que não couber agora fica no buffer do cliente; com o
+ * buffer cheio a linha inteira é descartada. PTY: sem leitor acompanhando,
+ * a fila da pty é esvaziada (o próximo leitor não recebe linhas velhas).
+ */
+static void Envia_Cliente(int i, const uint8_t* dados, size_t n) {
+    Cliente* c = &clientes[i];
+    ssize_t w = 0;
+
+    if (c->tipo == CLIENTE_PTY) {
+        w = write(c->fd, dados, n);
+        if (w == (ssize_t)n) {
+            c->linhas++;
+        } else {
+            tcflush(c->escravo, TCIFLUSH);
+            c->descartadas++;
+        }
+        return;
+    }
+
+    if (c->n_saida == 0) {
+        w = write(c->fd, dados, n);
+        if (w < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                Fecha_Cliente(i);
+                return;
+            }
+            w = 0;
+        }
+        if ((size_t)w == n) {
+            c->linhas++;
+            return;
+        }
+    }
+    if (c->n_saida + n - (size_t)w > SAIDA) {
+        c->descartadas++;   // Só linhas inteiras: w > 0 implica buffer vazio
+        return;
+    }
+    memcpy(c->saida + c->n_saida, dados + w, n - (size_t)w);
+    c->n_saida += n - (size_t)w;
+    c->linhas++;
+}
+
+static void Escoa_Cliente(int i) {
+    Cliente* c = &clientes[i];
+    ssize_t w = write(c->fd, c->saida, c->n_saida);
+    if (w < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) Fecha_Cliente(i);
+        return;
+    }
+    memmove(c->saida, c->saida + w, c->n_saida - (size_t)w);
+    c->n_saida -= (size_t)w;
+}
+
+
+// PLACA
+
+static int placa = -1;
+static pid_t pid_simulador = 0;
+
+// Quadros aguardando a vez, já com a sequência própria
+static struct {
+    char dados[QUADRO_MAX + 3];     // NUL + '$' + conteúdo + CR
+    uint8_t n;
+} fila[FILA];
+static int fila_ini = 0, fila_n = 0;
+static uint64_t proxima_escrita = 0;
+
+static bool Hex(char c, uint8_t* v) {
+    if (c >= '0' && c <= '9') *v = (uint8_t)(c - '0');
+    else if (c >= 'A' && c <= 'F') *v = (uint8_t)(c - 'A' + 10);
+    else if (c >= 'a' && c <= 'f') *v = (uint8_t)(c - 'a' + 10);
+    else return false;
+    return true;
+}
+
+static void Poe_Hex(char* p, uint8_t v) {
+    static const char digitos[] = "0123456789ABCDEF";
+    p[0] = digitos[v >> 4];
+    p[1] = digitos[v & 0x0F];
+}
+
+/**
+ * @brief Lê a sequência "@SS" do fim de um quadro (conteúdo sem '$' e CR).
+ * @return -1 se o quadro não for sequenciado.
+ */
+static int Sequencia(const char* q, int n) {
+    uint8_t alta, baixa;
+    if (n < 3 || q[n - 3] != '@' || !Hex(q[n - 2], &alta) || !Hex(q[n - 1], &baixa)) return -1;
+    return (alta << 4) | baixa;
+}
+
+static void Rejeita(int i, int seq) {
+    char nak[] = "#N,SS,L\r";
+    if (seq < 0) return;
+    Poe_Hex(nak + 3, (uint8_t)seq);
+    Envia_Cliente(i, (const uint8_t*)nak, sizeof(nak) - 1);
+}
+
+/**
+ * @brief Quadro completo de um cliente: limite, troca da sequência e fila da placa.
+ * @param q Conteúdo entre '$' e CR.
+ */
+static void Encaminha(int i, char* q, int n) {
+    Cliente* c = &clientes[i];
+    uint64_t agora = Agora_us();
+    int seq = Sequencia(q, n);
+
+    c->fichas += (double)(agora - c->t_fichas) * 1e-6 * cfg.limite;
+    if (c->fichas > cfg.rajada) c->fichas = cfg.rajada;
+    c->t_fichas = agora;
+    if (c->fichas < 1.0 || fila_n == FILA) {
+        c->limitados++;
+        Rejeita(i, seq);
+        return;
+    }
+    c->fichas -= 1.0;
+    c->quadros++;
+
+    if (seq >= 0) {
+        uint8_t propria;
+        if (seq == c->seq_cliente && agora - c->t_seq < JANELA_RETX_US
+                && donos[c->seq_propria].cliente == i && donos[c->seq_propria].geracao == c->geracao) {
+            propria = c->seq_propria;   // Retransmissão: o firmware deve reconhecê-la
+        } else {
+            propria = proxima_seq++;
+            donos[propria].cliente = i;
+            donos[propria].geracao = c->geracao;
+            donos[propria].seq_cliente = (uint8_t)seq;
+            c->seq_cliente = seq;
+            c->seq_propria = propria;
+        }
+        c->t_seq = agora;
+        Poe_Hex(q + n - 2, propria);
+    }
+
+    int k = (fila_ini + fila_n++) % FILA;
+    fila[k].dados[0] = '\0';
+    fila[k].dados[1] = '$';
+    memcpy(fila[k].dados + 2, q, (size_t)n);
+    fila[k].dados[n + 2] = '\r';
+    fila[k].n = (uint8_t)(n + 3);
+    if (cfg.verboso) Log("%s: $%.*s\n", Nome_Cliente(i), n, q);
+}
+
+/**
+ * @brief Envia o próximo quadro da fila se o intervalo desde o anterior passou.
+ */
+static void Escreve_Placa(void) {
+    uint64_t agora = Agora_us();
+    if (!fila_n || agora < proxima_escrita) return;
+    ssize_t w = write(placa, fila[fila_ini].dados, fila[fila_ini].n);
+    if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+    // O intervalo conta a partir do fim da transmissão do quadro
+    proxima_escrita = agora + (uint64_t)fila[fila_ini].n * BYTE_US + cfg.intervalo_us;
+    fila_ini = (fila_ini + 1) % FILA;
+    fila_n--;
+    quadros_enviados++;
+}
+
+/**
+ * @brief Distribui uma linha da placa (terminada em CR) direto do buffer de leitura.
+ * @details "#K,SS" e "#N,SS,c" com uma sequência própria voltam só ao cliente
+ * de origem, com a sequência dele; as demais linhas vão a todos.
+ */
+static void Distribui(const uint8_t* linha, size_t n) {
+    linhas_recebidas++;
+    if (n >= 6 && linha[0] == '#' && (linha[1] == 'K' || linha[1] == 'N') && linha[2] == ',') {
+        uint8_t alta, baixa;
+        if (Hex((char)linha[3], &alta) && Hex((char)linha[4], &baixa)) {
+            uint8_t propria = (uint8_t)((alta << 4) | baixa);
+            int i = donos[propria].cliente;
+            if (i >= 0 && clientes[i].tipo != CLIENTE_LIVRE && clientes[i].geracao == donos[propria].geracao) {
+                uint8_t resposta[32];
+                if (n > sizeof(resposta)) return;
+                memcpy(resposta, linha, n);
+                Poe_Hex((char*)resposta + 3, donos[propria].seq_cliente);
+                Envia_Cliente(i, resposta, n);
+            }
+            return;     // Resposta a um cliente que já saiu
+        }
+    }
+    for (int i = 0; i < MAX_CLIENTES; i++) {
+        if (clientes[i].tipo != CLIENTE_LIVRE) Envia_Cliente(i, linha, n);
+    }
+}
+
+/**
+ * @brief Lê a placa e distribui as linhas completas.
+ * @return false se a placa foi fechada (simulador encerrado, serial removida).
+ */
+static bool Le_Placa(void) {
+    static uint8_t buf[ENTRADA];
+    static size_t n = 0;
+
+    ssize_t r = read(placa, buf + n, sizeof(buf) - n);
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return true;
+    if (r <= 0) return false;
+    n += (size_t)r;
+
+    uint8_t* inicio = buf;
+    uint8_t* fim = buf + n;
+    uint8_t* cr;
+    while ((cr = memchr(inicio, '\r', (size_t)(fim - inicio))) != NULL) {
+        Distribui(inicio, (size_t)(cr - inicio) + 1);
+        inicio = cr + 1;
+    }
+    n = (size_t)(fim - inicio);
+    if (n == sizeof(buf)) n = 0;    // Linha sem CR ocupando todo o buffer: ruído
+    else if (inicio != buf) memmove(buf, inicio, n);
+    return true;
+}
+
+/**
+ * @brief Lê um cliente e monta os quadros entre '$' e CR, como o firmware.
+ */
+static void Le_Cliente(int i) {
+    Cliente* c = &clientes[i];
+    char buf[512];
+    ssize_t r = read(c->fd, buf, sizeof(buf));
+
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return;
+    if (r <= 0) {
+        // PTY sem ninguém no lado escravo: não é desconexão
+        if (c->tipo == CLIENTE_SOCKET) Fecha_Cliente(i);
+        return;
+    }
+    for (ssize_t k = 0; k < r; k++) {
+        char b = buf[k];
+        if (b == '$') c->n_quadro = 0;
+        else if (c->n_quadro < 0) continue;
+        else if (b == '\r') {
+            Encaminha(i, c->quadro, c->n_quadro);
+            c->n_quadro = -1;
+        } else if (c->n_quadro < QUADRO_MAX) c->quadro[c->n_quadro++] = b;
+        else c->n_quadro = -1;      // Longo demais: descartado, como no firmware
+    }
+}
+
+
+// ABERTURA
+
+static void Modo_Bruto(int fd, bool serial) {
+    struct termios t;
+    if (tcgetattr(fd, &t) < 0) return;
+    cfmakeraw(&t);
+    if (serial) {
+        cfsetispeed(&t, B19200);
+        cfsetospeed(&t, B19200);
+        t.c_cflag = (t.c_cflag & ~(CSTOPB | PARENB | CRTSCTS)) | CLOCAL | CREAD | CS8;
+    }
+    tcsetattr(fd, TCSANOW, &t);
+}
+
+static void Nao_Bloqueante(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+static bool Abre_Dispositivo(void) {
+    placa = open(cfg.dispositivo, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (placa < 0) return false;
+    if (isatty(placa)) Modo_Bruto(placa, true);
+    return true;
+}
+
+/**
+ * @brief Executa o simulador com a entrada e a saída padrão em uma pty.
+ */
+static bool Inicia_Simulador(void) {
+    int escravo;
+    if (openpty(&placa, &escravo, NULL, NULL, NULL) < 0) return false;
+    Modo_Bruto(escravo, false);
+    pid_simulador = fork();
+    if (pid_simulador < 0) return false;
+    if (pid_simulador == 0) {
+        setsid();
+        dup2(escravo, STDIN_FILENO);
+        dup2(escravo, STDOUT_FILENO);
+        close(escravo);
+        close(placa);
+        execvp(cfg.simulador[0], cfg.simulador);
+        fprintf(stderr, "elevdist: não foi possível executar %s: %s\n", cfg.simulador[0], strerror(errno));
+        _exit(127);
+    }
+    close(escravo);
+    Nao_Bloqueante(placa);
+    return true;
+}
+
+static bool Cria_Pty(const char* link) {
+    int mestre, escravo;
+    if (openpty(&mestre, &escravo, NULL, NULL, NULL) < 0) return false;
+    Modo_Bruto(escravo, false);
+    Nao_Bloqueante(mestre);
+
+    struct stat st;
+    if (lstat(link, &st) == 0 && S_ISLNK(st.st_mode)) unlink(link);
+    if (symlink(ttyname(escravo), link) < 0) {
+        close(mestre);
+        close(escravo);
+        return false;
+    }
+    int i = Novo_Cliente(CLIENTE_PTY, mestre);
+    clientes[i].escravo = escravo;
+    clientes[i].link = link;
+    Log("%s -> %s\n", link, ttyname(escravo));
+    return true;
+}
+
+static int Cria_Socket(void) {
+    struct sockaddr_un end = { .sun_family = AF_UNIX };
+    if (strlen(cfg.socket) >= sizeof(end.sun_path)) return -1;
+    strcpy(end.sun_path, cfg.socket);
+    int s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s < 0) return -1;
+    unlink(cfg.socket);
+    if (bind(s, (struct sockaddr*)&end, sizeof(end)) < 0 || listen(s, 8) < 0) {
+        close(s);
+        return -1;
+    }
+    Nao_Bloqueante(s);
+    return s;
+}
+
+static void Aceita(int s) {
+    int fd = accept(s, NULL, NULL);
+    if (fd < 0) return;
+    Nao_Bloqueante(fd);
+    int i = Novo_Cliente(CLIENTE_SOCKET, fd);
+    if (i < 0) {
+        close(fd);
+        Log("conexão recusada: %d clientes\n", MAX_CLIENTES);
+        return;
+    }
+    Log("%s: conectado\n", Nome_Cliente(i));
+}
+
+
+// ENTRADA
+
+static void Log(const char* fmt, ...) {
+    va_list ap;
+    if (!cfg.verboso) return;
+    va_start(ap, fmt);
+    fputs("elevdist: ", stderr);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+}
+
+static void Sinal(int s) {
+    encerrar = 1;
+}
+
+static void Uso(const char* prog) {
+    fprintf(stderr,
+        "uso: %s [opções] (--dispositivo SERIAL | -- SIMULADOR [ARGS...])\n"
+        "  --dispositivo ARQ  serial da placa (19200 8N1)\n"
+        "  --socket ARQ       socket Unix dos clientes (padrão /tmp/elevador.sock)\n"
+        "  --pty LINK         porta serial virtual: LINK aponta para uma pty (até %d)\n"
+        "  --limite N         quadros por segundo aceitos de cada cliente (padrão 10)\n"
+        "  --rajada N         quadros seguidos aceitos acima do limite médio (padrão 5)\n"
+        "  --intervalo MS     espaço mínimo entre quadros enviados à placa (padrão 20)\n"
+        "  -v                 conexões, quadros encaminhados e estatísticas na saída de erro\n"
+        "  -- CMD [ARGS...]   executa o simulador em uma pty, ex.: -- ../simulador/build/elevsim --tempo-real 1\n",
+        prog, MAX_PTYS);
+}
+
+int main(int argc, char** argv) {
+    int i;
+    for (i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!strcmp(a, "--")) { cfg.simulador = argv + i + 1; break; }
+        else if (!strcmp(a, "--dispositivo") && v) { cfg.dispositivo = v; i++; }
+        else if (!strcmp(a, "--socket") && v) { cfg.socket = v; i++; }
+        else if (!strcmp(a, "--pty") && v && cfg.n_pty < MAX_PTYS) { cfg.pty[cfg.n_pty++] = v; i++; }
+        else if (!strcmp(a, "--limite") && v) { cfg.limite = atof(v); i++; }
+        else if (!strcmp(a, "--rajada") && v) { cfg.rajada = atof(v); i++; }
+        else if (!strcmp(a, "--intervalo") && v) { cfg.intervalo_us = (uint32_t)(atof(v) * 1000.0); i++; }
+        else if (!strcmp(a, "-v")) cfg.verboso = true;
+        else { Uso(argv[0]); return 2; }
+    }
+    if ((cfg.dispositivo != NULL) == (cfg.simulador != NULL && cfg.simulador[0] != NULL)
+            || cfg.limite <= 0.0 || cfg.rajada < 1.0) {
+        Uso(argv[0]);
+        return 2;
+    }
+
+    for (i = 0; i < 256; i++) donos[i].cliente = -1;
+    signal(SIGPIPE, SIG_IGN);
+    struct sigaction sa = { .sa_handler = Sinal };
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    if (cfg.dispositivo ? !Abre_Dispositivo() : !Inicia_Simulador()) {
+        fprintf(stderr, "elevdist: não foi possível abrir %s: %s\n",
+                cfg.dispositivo ? cfg.dispositivo : cfg.simulador[0], strerror(errno));
+        return 2;
+    }
+    int s = Cria_Socket();
+    if (s < 0) {
+        fprintf(stderr, "elevdist: não foi possível criar o socket %s: %s\n", cfg.socket, strerror(errno));
+        return 2;
+    }
+    for (i = 0; i < cfg.n_pty; i++) {
+        if (!Cria_Pty(cfg.pty[i])) {
+            fprintf(stderr, "elevdist: não foi possível criar a pty %s: %s\n", cfg.pty[i], strerror(errno));
+            return 2;
+        }
+    }
+
+    int codigo = 0;
+    while (!encerrar) {
+        struct pollfd pf[2 + MAX_CLIENTES];
+        int indice[MAX_CLIENTES];
+        int n = 0;
+        pf[n++] = (struct pollfd){ .fd = placa, .events = POLLIN };
+        pf[n++] = (struct pollfd){ .fd = s, .events = POLLIN };
+        for (i = 0; i < MAX_CLIENTES; i++) {
+            if (clientes[i].tipo == CLIENTE_LIVRE) continue;
+            indice[n - 2] = i;
+            pf[n++] = (struct pollfd){ .fd = clientes[i].fd,
+                                       .events = (short)(POLLIN | (clientes[i].n_saida ? POLLOUT : 0)) };
+        }
+
+        // Com quadros na fila, acorda a tempo do próximo envio à placa
+        int espera = -1;
+        if (fila_n) {
+            uint64_t agora = Agora_us();
+            espera = proxima_escrita > agora ? (int)((proxima_escrita - agora + 999) / 1000) : 0;
+        }
+        if (poll(pf, (nfds_t)n, espera) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if ((pf[0].revents & (POLLIN | POLLHUP | POLLERR)) && !Le_Placa()) {
+            fprintf(stderr, "elevdist: %s encerrado\n", cfg.dispositivo ? cfg.dispositivo : "simulador");
+            codigo = 1;
+            break;
+        }
+        if (pf[1].revents & POLLIN) Aceita(s);
+        for (int k = 2; k < n; k++) {
+            int c = indice[k - 2];
+            if (clientes[c].tipo == CLIENTE_LIVRE || clientes[c].fd != pf[k].fd) continue;
+            if (pf[k].revents & POLLOUT) Escoa_Cliente(c);
+            if (clientes[c].tipo != CLIENTE_LIVRE && (pf[k].revents & (POLLIN | POLLHUP | POLLERR))) {
+                Le_Cliente(c);
+            }
+        }
+        Escreve_Placa();
+    }
+
+    Log("%llu linhas distribuídas, %llu quadros enviados à placa\n",
+        (unsigned long long)linhas_recebidas, (unsigned long long)quadros_enviados);
+    for (i = 0; i < MAX_CLIENTES; i++) {
+        if (clientes[i].tipo == CLIENTE_LIVRE) continue;
+        if (clientes[i].tipo == CLIENTE_PTY) unlink(clientes[i].link);
+        Fecha_Cliente(i);
+    }
+    close(s);
+    unlink(cfg.socket);
+    if (pid_simulador > 0) {
+        kill(pid_simulador, SIGTERM);
+        waitpid(pid_simulador, NULL, 0);
+    }
+    return codigo;
+}
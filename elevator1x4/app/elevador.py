@@ -5,101 +5,434 @@ Elevador GUI (COM apenas) com gráficos em tempo real
 ----------------------------------------------------
 - Lista e permite selecionar apenas portas COM (Windows).
 - Botões: Atualizar lista, Conectar/Desconectar.
-- Plota Posição (mm), Velocidade (mm/s) e Temperatura (°C) em tempo real.
-- Protocolo: 19200 8N1; linhas terminadas em CR (\r); quadro "$A,D,M,HHH,VV.V,TT.T\r".
-- Envia solicitação "$OD\r" (O,D em 0..3).
-- Leitura não-bloqueante com Tk.after().
+- Plota Posição (mm), Velocidade (mm/s) e Temperatura (°C) em tempo real, em uma
+  figura com eixo x (s) compartilhado, redesenhando só as curvas (blitting).
+- Protocolo: 19200 8N1; linhas terminadas em CR (\r); quadro "$A,D,M,HHH,VV.V,TT.T,NN,MMMM\r".
+- Usa a sequência (NN) e o relógio do firmware (MMMM, ms) para datar as amostras,
+  contar quadros perdidos e medir o jitter do enlace.
+- Envia solicitação "$OD\r" (O,D em 0..3) e consultas "$?S", "$?F", "$?E" (respostas "#...\r").
+- Entrega confirmada: cada quadro leva a sequência "@SS" e é retransmitido até
+  receber "#K,SS" (ACK) ou esgotar as tentativas; mostra a latência de entrega.
+- Assina canais de telemetria "$Scnnn\r" e exibe os quadros "$c,valor\r".
+- Leitura e escrita da serial em threads próprias: a thread de leitura separa e
+  interpreta as linhas e as entrega à interface por uma fila sem trava; os
+  quadros enviados saem na hora pela thread de escrita.
+- Registra a telemetria em trilha binária colunar (.elt, ver trilha.py) ou em CSV.
+- Reproduz um registro (.elt ou CSV) pelo mesmo caminho dos quadros da serial,
+  a 1x, 10x, 100x ou o mais rápido possível, com busca por instante.
 """
 from collections import deque
 from datetime import datetime
 import os
 import csv
+import queue
+import random
+import threading
+import time
 import tkinter as tk
 from tkinter import ttk, messagebox, filedialog
 
 import serial
 import serial.tools.list_ports
 
+import numpy as np
 import matplotlib
-matplotlib.use("Agg")
+matplotlib.use("TkAgg")
+
 from matplotlib.figure import Figure
 from matplotlib.backends.backend_tkagg import FigureCanvasTkAgg
 
+from trilha import EscritorTrilha, FLAG_CARIMBO, ler_trilha
+
 BAUDRATE = 19200
 LINE_END = b"\r"
-POLL_MS = 50
-PLOT_INTERVAL_MS = 300
-MAX_POINTS = 600
+DESPERTAR = b"\x00"      # Antes de cada quadro: acorda o PIC estacionado (SONO_HABILITADO)
+POLL_MS = 50             # Retransmissões e reserva da entrega dos quadros recebidos
+LEITURA_TIMEOUT_S = 0.05 # Espera máxima de cada leitura (a thread confere o encerramento)
+PLOT_INTERVAL_MS = 50    # Só as curvas são redesenhadas: ~20 quadros/s custam pouco
+MAX_POINTS = 6000        # 60 s a 100 Hz
+JANELA_S = 60.0          # Largura do eixo x
+AVANCO_S = 15.0          # Deslocamento do eixo x quando a curva chega à borda direita
+MARGEM_Y = 0.1           # Folga relativa ao expandir o eixo y
+REPRODUCAO_MS = 20       # Período de entrega dos quadros na reprodução
+REPRODUCAO_ORCAMENTO_S = 0.03  # Tempo máximo de processamento por entrega
+VELOCIDADES = {"1x": 1.0, "10x": 10.0, "100x": 100.0, "Máx": 0.0}
+ACK_TIMEOUT_S = 0.25     # Espera pelo ACK antes de retransmitir
+MAX_TENTATIVAS = 4       # Envios por quadro sem resposta (entrega garantida em ~1 s ou erro)
 
 MOTOR_ESTADOS = {0: "Parado", 2: "Descendo", 3: "Subindo"}
 
+# Canais de telemetria do firmware: nome -> letra usada em "$Scnnn" e nos quadros "$c,..."
+CANAIS = {"Geral": "G", "Posição": "P", "Velocidade": "V", "Temperatura": "T", "Fila": "F"}
+
 def listar_com_ports_only():
-    """Retorna apenas dispositivos cujo nome começa com 'COM' (Windows)."""
+    """Retorna apenas dispositivos cujo nome começa com 'COM' (Windows).
+
+    Inclui também as portas de ELEVADOR_PORTAS (separadas por os.pathsep) que
+    existirem, como as portas virtuais do distribuidor (elevdist --pty).
+    """
     ports = []
     for p in serial.tools.list_ports.comports():
         dev = (p.device or "").upper()
         if dev.startswith("COM"):
             ports.append(p.device)
+    for extra in os.environ.get("ELEVADOR_PORTAS", "").split(os.pathsep):
+        if extra and os.path.exists(extra):
+            ports.append(extra)
     return ports
 
+def interpretar_linha(line: bytes):
+    """Interpreta uma linha recebida (sem o CR), fora da thread da interface.
+
+    Retorna None para linhas vazias ou uma tupla com o tipo na primeira posição:
+    ("confirmacao", txt), ("resposta", txt), ("canal", letra, campos),
+    ("erro", msg) ou ("amostra", A, D, M, H, VV, TT, seq, ms), com seq e ms em
+    hexadecimal ("" sem carimbo).
+    """
+    txt = line.decode("ascii", errors="ignore").strip()
+    if not txt:
+        return None
+
+    # ACK/NAK dos quadros sequenciados
+    if txt.startswith("#K,") or txt.startswith("#N,"):
+        return ("confirmacao", txt)
+
+    # Respostas às consultas começam com '#'
+    if txt.startswith("#"):
+        return ("resposta", txt)
+
+    # Canais assinados: letra logo após o '$' ("$P,123")
+    if len(txt) > 2 and txt[0] == "$" and txt[1].isalpha():
+        return ("canal", txt[1], txt[3:].split(","))
+
+    # Remove o $ inicial se houver
+    if txt.startswith("$"):
+        payload = txt[1:]
+    else:
+        payload = txt
+
+    # Divide por vírgulas
+    parts = [p.strip() for p in payload.split(",")]
+
+    # DIAGNÓSTICO: Se o tamanho não for 6 (antigo) ou 8 (com carimbo), mostra o que chegou
+    if len(parts) not in (6, 8):
+        return ("erro", f"Ignorado (Tam={len(parts)}): {txt}")
+
+    try:
+        # Tenta converter os números
+        A = int(parts[0])
+        D = int(parts[1])
+        M = int(parts[2])
+        H = int(parts[3])
+        VV = float(parts[4])
+        TT = float(parts[5])
+    except Exception as e:
+        # Mostra qual dado está quebrando o gráfico
+        return ("erro", f"Erro Conversão: {e} | Dados: {parts}")
+
+    seq, ms = (parts[6], parts[7]) if len(parts) == 8 else ("", "")
+    return ("amostra", A, D, M, H, VV, TT, seq, ms)
+
+
+class EnlaceSerial:
+    """Serial com leitura e escrita em threads próprias.
+
+    A thread de leitura acorda a cada byte, separa as linhas, interpreta cada
+    uma (interpretar_linha) e a põe em `recebidos` com o instante de chegada;
+    `avisar` é chamado quando a fila deixa de estar vazia. append/popleft de um
+    deque são atômicos no CPython, então a fila não usa trava. A thread de
+    escrita envia os quadros na ordem pedida, sem esperar o loop da interface.
+    Falhas chegam pela mesma fila: ("falha", msg) e ("falha_envio", seq, msg).
+    """
+
+    def __init__(self, porta, avisar):
+        self.ser = serial.Serial(port=porta, baudrate=BAUDRATE, timeout=LEITURA_TIMEOUT_S, write_timeout=1.0)
+        self.recebidos = deque()
+        self.envios = queue.SimpleQueue()
+        self.avisar = avisar
+        self.aviso_pendente = False
+        self.ativo = True
+        self.leitor = threading.Thread(target=self._ler, name="serial-rx", daemon=True)
+        self.escritor = threading.Thread(target=self._escrever, name="serial-tx", daemon=True)
+        self.leitor.start()
+        self.escritor.start()
+
+    def _postar(self, item):
+        self.recebidos.append(item)
+        if not self.aviso_pendente:
+            self.aviso_pendente = True
+            try:
+                self.avisar()
+            except Exception:
+                pass    # Sem aviso, o timer de POLL_MS entrega a fila
+
+    def _ler(self):
+        resto = b""
+        try:
+            while self.ativo:
+                bloco = self.ser.read(self.ser.in_waiting or 1)
+                if not bloco:
+                    continue
+                chegada = time.time()
+                *linhas, resto = (resto + bloco).split(LINE_END)
+                for linha in linhas:
+                    quadro = interpretar_linha(linha)
+                    if quadro:
+                        self._postar((quadro, chegada))
+        except Exception as e:
+            if self.ativo:
+                self._postar((("falha", f"Erro na serial: {e}"), None))
+
+    def _escrever(self):
+        while True:
+            item = self.envios.get()
+            if item is None:
+                return
+            frame, seq = item
+            try:
+                self.ser.write(frame)
+            except Exception as e:
+                if self.ativo:
+                    self._postar((("falha_envio", seq, str(e)), None))
+
+    def enviar(self, frame, seq):
+        self.envios.put((frame, seq))
+
+    def retirar(self):
+        """Esvazia a fila de recebidos: (quadro, chegada) na ordem de chegada."""
+        self.aviso_pendente = False
+        while True:
+            try:
+                yield self.recebidos.popleft()
+            except IndexError:
+                return
+
+    def fechar(self):
+        self.ativo = False
+        self.envios.put(None)
+        self.escritor.join(timeout=1.0)
+        if hasattr(self.ser, "cancel_read"):
+            self.ser.cancel_read()
+        self.leitor.join(timeout=1.0)
+        self.ser.close()
+
+
 class RealTimePlots:
+    """Posição, velocidade e temperatura em uma figura com eixo x compartilhado.
+
+    As amostras entram em um buffer circular gravado em dobro (as últimas
+    MAX_POINTS ficam sempre contíguas, sem cópia). refresh() restaura o fundo
+    guardado (eixos, grades e rótulos) e desenha só as três curvas; o desenho
+    completo só acontece quando um eixo muda: o x avança AVANCO_S ao atingir a
+    borda e o y só se expande quando a curva sai dos limites (e volta a se
+    ajustar aos dados visíveis quando o x avança).
+    """
+
+    SERIES = (("Posição (mm)", "mm", (0.0, 200.0)),
+              ("Velocidade (mm/s)", "mm/s", (-5.0, 40.0)),
+              ("Temperatura (°C)", "°C", (20.0, 40.0)))
+
     def __init__(self, parent):
-        self.times = deque(maxlen=MAX_POINTS)
-        self.pos   = deque(maxlen=MAX_POINTS)
-        self.vel   = deque(maxlen=MAX_POINTS)
-        self.temp  = deque(maxlen=MAX_POINTS)
+        # Linha 0: tempo; linhas 1-3: séries
+        self.dados = np.zeros((1 + len(self.SERIES), 2 * MAX_POINTS))
+        self.inicio = 0
+        self.tam = 0
+        self.t0 = None
+        self.novos = False
 
         self.frm = ttk.Frame(parent)
         self.frm.pack(fill="both", expand=True, padx=6, pady=6)
 
-        # Ajuste da altura dos gráficos (mais espaço para rótulos)
-        height = 2.0  # antes era 1.6
-
-        # Posição
-        self.fig_pos = Figure(figsize=(4,height), dpi=90)
-        self.ax_pos = self.fig_pos.add_subplot(111)
-        self.ax_pos.set_title("Posição (mm)")
-        self.ax_pos.set_ylabel("mm")
-        self.ax_pos.grid(True)
-        self.line_pos, = self.ax_pos.plot([], [])
-        self.canvas_pos = FigureCanvasTkAgg(self.fig_pos, master=self.frm)
-        self.canvas_pos.get_tk_widget().pack(fill="x", padx=4, pady=4)
-
-        # Velocidade
-        self.fig_vel = Figure(figsize=(4,height), dpi=90)
-        self.ax_vel = self.fig_vel.add_subplot(111)
-        self.ax_vel.set_title("Velocidade (mm/s)")
-        self.ax_vel.set_ylabel("mm/s")
-        self.ax_vel.grid(True)
-        self.line_vel, = self.ax_vel.plot([], [])
-        self.canvas_vel = FigureCanvasTkAgg(self.fig_vel, master=self.frm)
-        self.canvas_vel.get_tk_widget().pack(fill="x", padx=4, pady=4)
-
-        # Temperatura
-        self.fig_temp = Figure(figsize=(4,height), dpi=90)
-        self.ax_temp = self.fig_temp.add_subplot(111)
-        self.ax_temp.set_title("Temperatura (°C)")
-        self.ax_temp.set_ylabel("°C")
-        self.ax_temp.grid(True)
-        self.line_temp, = self.ax_temp.plot([], [])
-        self.canvas_temp = FigureCanvasTkAgg(self.fig_temp, master=self.frm)
-        self.canvas_temp.get_tk_widget().pack(fill="x", padx=4, pady=4)
+        self.fig = Figure(figsize=(4, 6.0), dpi=90)
+        self.axes = self.fig.subplots(len(self.SERIES), 1, sharex=True)
+        self.linhas = []
+        for ax, (titulo, unidade, ylim) in zip(self.axes, self.SERIES):
+            ax.set_title(titulo)
+            ax.set_ylabel(unidade)
+            ax.grid(True)
+            ax.set_ylim(*ylim)
+            # animated: fica fora do desenho completo, que vira o fundo guardado
+            linha, = ax.plot([], [], animated=True)
+            self.linhas.append(linha)
+        self.axes[-1].set_xlim(0.0, JANELA_S)
+        self.axes[-1].set_xlabel("s")
+        self.fig.tight_layout()
+
+        self.canvas = FigureCanvasTkAgg(self.fig, master=self.frm)
+        self.canvas.get_tk_widget().pack(fill="both", expand=True, padx=4, pady=4)
+        self.fundo = None
+        self.canvas.mpl_connect("draw_event", self._ao_desenhar)
 
     def append(self, t, p, v, te):
-        self.times.append(t); self.pos.append(p); self.vel.append(v); self.temp.append(te)
+        if self.t0 is None:
+            self.t0 = t
+        i = (self.inicio + self.tam) % MAX_POINTS
+        coluna = (t - self.t0, p, v, te)
+        self.dados[:, i] = coluna
+        self.dados[:, i + MAX_POINTS] = coluna
+        if self.tam < MAX_POINTS:
+            self.tam += 1
+        else:
+            self.inicio = (self.inicio + 1) % MAX_POINTS
+        self.novos = True
+
+    def limpar(self, t0=None):
+        """Descarta as amostras (busca na reprodução); t0 fixa a origem do eixo x."""
+        self.inicio = 0
+        self.tam = 0
+        self.t0 = t0
+        self.novos = True
+        for linha in self.linhas:
+            linha.set_data([], [])
+        self.axes[-1].set_xlim(0.0, JANELA_S)
+        self.canvas.draw_idle()
+
+    def _visiveis(self):
+        """Fatia contígua das amostras dentro do eixo x atual."""
+        dados = self.dados[:, self.inicio:self.inicio + self.tam]
+        esquerda = self.axes[-1].get_xlim()[0]
+        return dados[:, np.searchsorted(dados[0], esquerda):]
+
+    def _ao_desenhar(self, event):
+        """Desenho completo (eixo mudou, janela redimensionada): guarda o novo fundo."""
+        self.fundo = self.canvas.copy_from_bbox(self.fig.bbox)
+        self._desenhar_linhas()
+
+    def _desenhar_linhas(self):
+        for ax, linha in zip(self.axes, self.linhas):
+            ax.draw_artist(linha)
+        self.canvas.blit(self.fig.bbox)
+
+    def _ajustar_eixos(self, dados):
+        """Avança o x e expande o y quando necessário; True se algum limite mudou."""
+        mudou = False
+        ax_x = self.axes[-1]
+        esquerda, direita = ax_x.get_xlim()
+        ultimo = dados[0, -1]
+        if ultimo > direita:
+            direita = ultimo + AVANCO_S
+            ax_x.set_xlim(direita - JANELA_S, direita)
+            dados = dados[:, np.searchsorted(dados[0], direita - JANELA_S):]
+            mudou = True
+
+        for k, ax in enumerate(self.axes, start=1):
+            serie = dados[k]
+            if not len(serie):
+                continue
+            minimo, maximo = float(serie.min()), float(serie.max())
+            baixo, alto = ax.get_ylim()
+            # Com o x avançando o desenho é completo de qualquer forma: reajusta aos dados
+            if mudou or minimo < baixo or maximo > alto:
+                if not mudou:
+                    minimo, maximo = min(minimo, baixo), max(maximo, alto)
+                folga = max(maximo - minimo, 1.0) * MARGEM_Y
+                ax.set_ylim(minimo - folga, maximo + folga)
+                mudou = True
+        return mudou
 
     def refresh(self):
-        if not self.times:
+        if not self.novos:
+            return
+        self.novos = False
+        dados = self._visiveis()
+        if not dados.shape[1]:
+            return
+        for k, linha in enumerate(self.linhas, start=1):
+            linha.set_data(dados[0], dados[k])
+
+        if self._ajustar_eixos(dados) or self.fundo is None:
+            # Desenho completo; o draw_event guarda o fundo e desenha as curvas
+            self.canvas.draw_idle()
             return
-        xs = list(range(len(self.times)))
-        self.line_pos.set_data(xs, list(self.pos))
-        self.ax_pos.relim(); self.ax_pos.autoscale_view(); self.canvas_pos.draw_idle()
+        self.canvas.restore_region(self.fundo)
+        self._desenhar_linhas()
+
 
-        self.line_vel.set_data(xs, list(self.vel))
-        self.ax_vel.relim(); self.ax_vel.autoscale_view(); self.canvas_vel.draw_idle()
+class Reproducao:
+    """Quadros de um registro (.elt ou CSV) entregues no ritmo da gravação.
 
-        self.line_temp.set_data(xs, list(self.temp))
-        self.ax_temp.relim(); self.ax_temp.autoscale_view(); self.canvas_temp.draw_idle()
+    Os instantes gravados viram a chegada de cada quadro; com velocidade 0 os
+    quadros saem o mais rápido possível. Os quadros são montados só na entrega.
+    """
+
+    def __init__(self, caminho):
+        if caminho.lower().endswith(".csv"):
+            d = self._ler_csv(caminho)
+        else:
+            _, d = ler_trilha(caminho)
+            d["t"] = d["t"] / 1e6
+        if not len(d["t"]):
+            raise ValueError("registro sem quadros")
+        self.d = d
+        self.t = d["t"]
+        self.k = 0
+        self.velocidade = 1.0
+        self.rodando = False
+        self._ancorar()
+
+    @staticmethod
+    def _ler_csv(caminho):
+        colunas = {nome: [] for nome in ("t", "A", "D", "M", "pos_mm", "vel_mms", "temp_C", "seq", "fw_ms", "flags")}
+        with open(caminho, newline="", encoding="utf-8") as f:
+            for linha in csv.DictReader(f):
+                try:
+                    t = float(linha["timestamp"])    # Trilha do simulador: segundos
+                except ValueError:
+                    t = datetime.fromisoformat(linha["timestamp"]).timestamp()
+                carimbo = bool(linha["seq"] and linha["fw_ms"])
+                colunas["t"].append(t)
+                for nome in ("A", "D", "M", "pos_mm"):
+                    colunas[nome].append(int(linha[nome]))
+                colunas["vel_mms"].append(float(linha["vel_mms"]))
+                colunas["temp_C"].append(float(linha["temp_C"]))
+                colunas["seq"].append(int(linha["seq"], 16) if carimbo else 0)
+                colunas["fw_ms"].append(int(linha["fw_ms"], 16) if carimbo else 0)
+                colunas["flags"].append(FLAG_CARIMBO if carimbo else 0)
+        return {nome: np.asarray(v) for nome, v in colunas.items()}
+
+    @property
+    def duracao(self):
+        return float(self.t[-1] - self.t[0])
+
+    @property
+    def posicao(self):
+        """Instante do próximo quadro, em s desde o início do registro."""
+        return float(self.t[min(self.k, len(self.t) - 1)] - self.t[0])
+
+    @property
+    def terminou(self):
+        return self.k >= len(self.t)
+
+    def _ancorar(self):
+        # O relógio da reprodução parte do próximo quadro agora
+        self.base_real = time.monotonic()
+        self.base_t = self.t[min(self.k, len(self.t) - 1)]
+
+    def quadro(self, k):
+        d = self.d
+        campos = f"${d['A'][k]},{d['D'][k]},{d['M'][k]},{d['pos_mm'][k]:03d},{d['vel_mms'][k]:04.1f},{d['temp_C'][k]:04.1f}"
+        if d["flags"][k] & FLAG_CARIMBO:
+            campos += f",{d['seq'][k]:02X},{d['fw_ms'][k]:04X}"
+        return campos.encode("ascii")
+
+    def tocar(self, velocidade):
+        self.velocidade = velocidade
+        self.rodando = True
+        self._ancorar()
+
+    def pausar(self):
+        self.rodando = False
+
+    def buscar(self, s):
+        self.k = int(np.searchsorted(self.t, self.t[0] + s))
+        self._ancorar()
+
+    def fim_agora(self):
+        """Índice após o último quadro que já deveria ter sido entregue."""
+        if not self.velocidade:
+            return len(self.t)
+        alvo = self.base_t + (time.monotonic() - self.base_real) * self.velocidade
+        return int(np.searchsorted(self.t, alvo, side="right"))
 
 
 class ElevadorGUI:
@@ -107,11 +440,24 @@ class ElevadorGUI:
         self.master = master
         self.master.title("Elevador de 4 andares")
         self.master.geometry("880x820")
-        self.ser = None
-        self.buffer = bytearray()
+        self.enlace = None
         self.csv_file = None
         self.csv_writer = None
+        self.trilha = None
         self.logging_enabled = tk.BooleanVar(value=False)
+        self.reproducao = None
+        self.ultima_amostra = None
+
+        # Entrega confirmada: sequência -> [conteúdo, t_primeiro_envio, t_ultimo_envio, tentativas]
+        # Um quadro sequenciado por vez: os seguintes aguardam o ACK/NAK em fila_envio,
+        # para que a retransmissão nunca chegue depois de um quadro mais novo
+        self.seq = random.randrange(256)
+        self.pendentes = {}
+        self.fila_envio = deque()
+        self.latencias = deque(maxlen=50)
+
+        # Carimbo de tempo do firmware
+        self._reiniciar_carimbo()
 
         # Top bar: seleção COM e conexão
         top = ttk.Frame(master); top.pack(fill="x", padx=6, pady=6)
@@ -131,11 +477,13 @@ class ElevadorGUI:
         indic = ttk.Frame(master); indic.pack(fill="x", padx=6, pady=4)
         self.var_andar=tk.StringVar(value="-"); self.var_dest=tk.StringVar(value="-"); self.var_motor=tk.StringVar(value="-")
         self.var_pos=tk.StringVar(value="-"); self.var_vel=tk.StringVar(value="-"); self.var_temp=tk.StringVar(value="-")
+        self.var_lat=tk.StringVar(value="-"); self.var_perdidos=tk.StringVar(value="-"); self.var_jitter=tk.StringVar(value="-")
         def mk(lbl,var):
             f=ttk.Frame(indic); f.pack(side="left", padx=6)
             ttk.Label(f,text=lbl).pack(); ttk.Label(f,textvariable=var,font=("Arial",11,"bold")).pack()
         mk("Andar (A)",self.var_andar); mk("Destino (D)",self.var_dest); mk("Motor (M)",self.var_motor)
         mk("Pos (mm)",self.var_pos); mk("Vel (mm/s)",self.var_vel); mk("Temp (°C)",self.var_temp)
+        mk("Latência (ms)",self.var_lat); mk("Perdidos",self.var_perdidos); mk("Jitter (ms)",self.var_jitter)
 
         # Envio $OD\r
         sendf = ttk.LabelFrame(master, text="Enviar $OD\\r (O=0..3 D=0..3)")
@@ -147,17 +495,54 @@ class ElevadorGUI:
         for d in range(4):
             ttk.Button(sendf, text=f"-> {d}", command=lambda dd=d: self._enviar_rapido(dd)).pack(side="left", padx=2)
 
-        # Logging CSV
+        # Consultas $?X\r (resposta exibida na barra de status)
+        consf = ttk.LabelFrame(master, text="Consultas")
+        consf.pack(fill="x", padx=6, pady=6)
+        for rot, cmd in (("Estado", "?S"), ("Fila", "?F"), ("Estatísticas", "?E")):
+            ttk.Button(consf, text=rot, command=lambda c=cmd: self._enviar_quadro(c)).pack(side="left", padx=4)
+
+        # Assinatura de canais $Scnnn\r (período em ciclos de 10 ms, 0 = desliga)
+        ttk.Label(consf, text="Canal").pack(side="left", padx=(16, 4))
+        self.cmb_canal = ttk.Combobox(consf, width=14, state="readonly", values=list(CANAIS))
+        self.cmb_canal.current(1)
+        self.cmb_canal.pack(side="left")
+        ttk.Label(consf, text="Período (x10 ms)").pack(side="left", padx=4)
+        self.var_periodo = tk.IntVar(value=10)
+        ttk.Spinbox(consf, from_=0, to=255, textvariable=self.var_periodo, width=5).pack(side="left")
+        ttk.Button(consf, text="Assinar", command=self._assinar_canal).pack(side="left", padx=4)
+
+        # Registro da telemetria: trilha binária (.elt) ou CSV, pela extensão escolhida
         logf = ttk.Frame(master); logf.pack(fill="x", padx=6, pady=4)
-        ttk.Checkbutton(logf, text="Gravar CSV", variable=self.logging_enabled, command=self._toggle_csv).pack(side="left")
+        ttk.Checkbutton(logf, text="Gravar", variable=self.logging_enabled, command=self._toggle_csv).pack(side="left")
         self.lbl_csv = ttk.Label(logf, text=""); self.lbl_csv.pack(side="left", padx=8)
 
+        # Reprodução de um registro, com a serial desconectada
+        repf = ttk.LabelFrame(master, text="Reprodução")
+        repf.pack(fill="x", padx=6, pady=4)
+        ttk.Button(repf, text="Abrir...", command=self._abrir_reproducao).pack(side="left", padx=4)
+        self.btn_tocar = ttk.Button(repf, text="Tocar", command=self._tocar_pausar, state="disabled")
+        self.btn_tocar.pack(side="left", padx=4)
+        self.cmb_velocidade = ttk.Combobox(repf, width=6, state="readonly", values=list(VELOCIDADES))
+        self.cmb_velocidade.current(0)
+        self.cmb_velocidade.bind("<<ComboboxSelected>>", lambda e: self._mudar_velocidade())
+        self.cmb_velocidade.pack(side="left", padx=4)
+        self.var_cursor = tk.DoubleVar(value=0.0)
+        self.scl_cursor = ttk.Scale(repf, from_=0.0, to=1.0, variable=self.var_cursor)
+        self.scl_cursor.pack(side="left", fill="x", expand=True, padx=4)
+        self.scl_cursor.bind("<ButtonPress-1>", lambda e: setattr(self, "arrastando", True))
+        self.scl_cursor.bind("<ButtonRelease-1>", lambda e: self._buscar())
+        self.arrastando = False
+        self.var_instante = tk.StringVar(value="-")
+        ttk.Label(repf, textvariable=self.var_instante, width=18).pack(side="left", padx=4)
+
         # Plots
         self.plots = RealTimePlots(master)
 
-        # Timers
+        # Timers; a thread de leitura acorda a interface com <<Serial>>
+        self.master.bind("<<Serial>>", lambda e: self._drenar_serial())
         self.master.after(POLL_MS, self._poll_serial)
         self.master.after(PLOT_INTERVAL_MS, self._plot_timer)
+        self.master.after(REPRODUCAO_MS, self._entregar_reproducao)
 
     # --------- COM handling ----------
     def _update_com_list(self):
@@ -170,48 +555,177 @@ class ElevadorGUI:
             self.cmb.set("")
 
     def _toggle_connection(self):
-        if self.ser is None:
+        if self.enlace is None:
             self._connect()
         else:
             self._disconnect()
 
     def _connect(self):
+        if self.reproducao:
+            self._fechar_reproducao()
         port = self.cmb.get()
         if not port:
             messagebox.showwarning("Porta COM", "Nenhuma COM selecionada. Clique em Atualizar para listar as COM disponíveis.")
             return
         try:
-            self.ser = serial.Serial(port=port, baudrate=BAUDRATE, timeout=0.0, write_timeout=1.0)
+            self.enlace = EnlaceSerial(port, lambda: self.master.event_generate("<<Serial>>", when="tail"))
             self.btn_connect.configure(text="Desconectar")
             self.var_status.set(f"Conectado em {port} @ {BAUDRATE}")
         except Exception as e:
-            self.ser = None
+            self.enlace = None
             messagebox.showerror("Erro", f"Falha ao abrir {port}: {e}")
 
     def _disconnect(self):
         try:
-            if self.ser:
-                self.ser.close()
+            if self.enlace:
+                self.enlace.fechar()
         finally:
-            self.ser = None
+            self.enlace = None
+            self.pendentes.clear()
+            self.fila_envio.clear()
+            self._reiniciar_carimbo()
             self.btn_connect.configure(text="Conectar")
             self.var_status.set("Desconectado")
 
     # --------- Envio/Recepção ----------
     def _enviar_od(self):
-        if not self.ser:
+        if not self.enlace:
             messagebox.showwarning("Serial", "Conecte primeiro.")
             return
         o = int(self.var_origem.get()); d = int(self.var_destino.get())
         if not (0<=o<=3 and 0<=d<=3):
             messagebox.showwarning("Valores", "Origem/Destino devem estar entre 0 e 3.")
             return
-        frame = f"${o}{d}\r".encode("ascii")
+        self._enviar_quadro(f"{o}{d}")
+
+    def _enviar_quadro(self, conteudo):
+        if not self.enlace:
+            messagebox.showwarning("Serial", "Conecte primeiro.")
+            return
+        self.fila_envio.append(conteudo)
+        if self.pendentes:
+            self.var_status.set(f"Na fila: ${conteudo} ({len(self.fila_envio)} aguardando)")
+            return
+        self._enviar_proximo()
+
+    def _enviar_proximo(self):
+        """Envia o próximo quadro da fila se nenhum estiver aguardando confirmação."""
+        if self.pendentes or not self.fila_envio or not self.enlace:
+            return
+        conteudo = self.fila_envio.popleft()
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        agora = time.monotonic()
+        self.pendentes[seq] = [conteudo, agora, agora, 1]
+        self._transmitir(conteudo, seq)
+
+    def _transmitir(self, conteudo, seq):
+        frame = f"${conteudo}@{seq:02X}\r".encode("ascii")
+        self.enlace.enviar(DESPERTAR + frame, seq)
+        self.var_status.set(f"Enviado: {frame!r}")
+
+    def _assinar_canal(self):
+        letra = CANAIS[self.cmb_canal.get()]
         try:
-            self.ser.write(frame)
-            self.var_status.set(f"Enviado: {frame!r}")
-        except Exception as e:
-            messagebox.showerror("Erro", f"Falha no envio: {e}")
+            periodo = int(self.var_periodo.get())
+        except (tk.TclError, ValueError):
+            periodo = -1
+        if not 0 <= periodo <= 255:
+            messagebox.showwarning("Valores", "Período deve estar entre 0 e 255.")
+            return
+        self._enviar_quadro(f"S{letra}{periodo:03d}")
+
+    def _reiniciar_carimbo(self):
+        self.fw_ms = None            # Relógio do firmware desenrolado (ms)
+        self.fw_ultimo = 0           # Último valor bruto de 16 bits
+        self.fw_seq = None           # Última sequência recebida
+        self.atraso_min = None       # Menor (chegada - relógio do firmware): enlace sem fila
+        self.quadros_perdidos = 0
+
+    def _carimbo(self, seq_hex, ms_hex, chegada=None, exibir=True):
+        """Converte o carimbo ",NN,MMMM" no instante da amostra (relógio do host).
+
+        Contabiliza os saltos de sequência como quadros perdidos e mede o jitter
+        como o atraso de chegada além do menor atraso já observado. Na
+        reprodução a chegada é o instante gravado.
+        """
+        if chegada is None:
+            chegada = datetime.now().timestamp()
+        try:
+            seq = int(seq_hex, 16); ms = int(ms_hex, 16)
+        except ValueError:
+            return chegada
+        if self.fw_ms is None:
+            self.fw_ms = ms
+        else:
+            self.fw_ms += (ms - self.fw_ultimo) & 0xFFFF
+            self.quadros_perdidos += (seq - self.fw_seq - 1) & 0xFF
+        self.fw_ultimo = ms
+        self.fw_seq = seq
+        atraso = chegada - self.fw_ms / 1000.0
+        if self.atraso_min is None or atraso < self.atraso_min:
+            self.atraso_min = atraso
+        if exibir:
+            self.var_perdidos.set(str(self.quadros_perdidos))
+            self.var_jitter.set(f"{(atraso - self.atraso_min) * 1000.0:.0f}")
+        return self.atraso_min + self.fw_ms / 1000.0
+
+    def _processar_canal(self, letra, campos):
+        """Atualiza o indicador correspondente a um quadro de canal "$c,valor,NN,MMMM"."""
+        if len(campos) >= 3:
+            self._carimbo(campos[-2], campos[-1])
+            campos = campos[:-2]
+        valor = ",".join(campos)
+        if letra == "P":
+            self.var_pos.set(valor)
+        elif letra == "V":
+            self.var_vel.set(valor)
+        elif letra == "T":
+            self.var_temp.set(valor)
+        elif letra == "F":
+            self.var_status.set(f"Fila (subida,descida): {valor}")
+
+    def _retransmitir(self, seq, motivo):
+        """Reenvia o quadro pendente ou desiste após MAX_TENTATIVAS."""
+        item = self.pendentes[seq]
+        if item[3] >= MAX_TENTATIVAS:
+            del self.pendentes[seq]
+            self.var_status.set(f"Falha na entrega de ${item[0]} ({motivo}, {item[3]} tentativas)")
+            self._enviar_proximo()
+            return
+        item[2] = time.monotonic()
+        item[3] += 1
+        self._transmitir(item[0], seq)
+
+    def _verificar_timeouts(self):
+        agora = time.monotonic()
+        for seq in [s for s, it in self.pendentes.items() if agora - it[2] >= ACK_TIMEOUT_S]:
+            self._retransmitir(seq, "sem ACK")
+
+    def _processar_confirmacao(self, txt):
+        """Trata "#K,SS" e "#N,SS,c"; confirmações repetidas são ignoradas.
+
+        O NAK é definitivo: formato, andar, estado e limite do distribuidor
+        falhariam igual em um reenvio, que só se faz por falta de resposta.
+        """
+        parts = txt[1:].split(",")
+        try:
+            seq = int(parts[1], 16)
+        except (IndexError, ValueError):
+            return
+        if seq not in self.pendentes:
+            return
+        item = self.pendentes.pop(seq)
+        if parts[0] == "K":
+            lat_ms = (time.monotonic() - item[1]) * 1000.0
+            self.latencias.append(lat_ms)
+            media = sum(self.latencias) / len(self.latencias)
+            self.var_lat.set(f"{lat_ms:.0f} (méd {media:.0f})")
+            self.var_status.set(f"Confirmado: ${item[0]} em {lat_ms:.0f} ms ({item[3]} envio(s))")
+        else:
+            codigo = parts[2] if len(parts) > 2 else "?"
+            self.var_status.set(f"Rejeitado: ${item[0]} (NAK {codigo})")
+        self._enviar_proximo()
 
     def _enviar_rapido(self, d):
         try:
@@ -222,71 +736,84 @@ class ElevadorGUI:
         self._enviar_od()
 
     def _poll_serial(self):
+        """Retransmissões por tempo; também entrega a fila se o aviso não chegar."""
         try:
-            if self.ser and self.ser.is_open:
-                while True:
-                    chunk = self.ser.read(256)
-                    if not chunk:
-                        break
-                    self.buffer.extend(chunk)
-                # processa por CR
-                while True:
-                    idx = self.buffer.find(LINE_END)
-                    if idx < 0:
-                        break
-                    line = bytes(self.buffer[:idx])
-                    del self.buffer[:idx+1]
-                    self._process_line(line)
-        except Exception as e:
-            self._disconnect()
-            self.var_status.set(f"Erro na serial: {e}")
+            self._drenar_serial()
+            if self.enlace:
+                self._verificar_timeouts()
         finally:
             self.master.after(POLL_MS, self._poll_serial)
 
-    def _process_line(self, line: bytes):
-        try:
-            # Tenta decodificar. Se falhar, mostra erro no console
-            txt = line.decode("ascii", errors="ignore").strip()
-        except Exception as e:
-            print(f"Erro de decode: {e}")
+    def _drenar_serial(self):
+        if not self.enlace:
             return
-
-        if not txt:
+        for quadro, chegada in self.enlace.retirar():
+            self._tratar(quadro, chegada)
+            if not self.enlace:     # Falha tratada: desconectado
+                return
+
+    def _process_line(self, line: bytes, chegada=None, exibir=True):
+        """Trata uma linha recebida pela reprodução (a serial usa _tratar direto)."""
+        quadro = interpretar_linha(line)
+        if quadro:
+            self._tratar(quadro, chegada, exibir)
+
+    def _tratar(self, quadro, chegada=None, exibir=True):
+        """Aplica um quadro interpretado (interpretar_linha) à interface.
+
+        Com exibir=False os indicadores não são atualizados (só a última amostra
+        de cada entrega da reprodução é exibida, ver _exibir_amostra).
+        """
+        tipo = quadro[0]
+        if tipo == "confirmacao":
+            self._processar_confirmacao(quadro[1])
             return
-
-        # Remove o $ inicial se houver
-        if txt.startswith("$"):
-            payload = txt[1:]
-        else:
-            payload = txt
-
-        # Divide por vírgulas
-        parts = [p.strip() for p in payload.split(",")]
-
-        # DIAGNÓSTICO: Se o tamanho não for 6, mostra o que chegou
-        if len(parts) != 6:
-            msg = f"Ignorado (Tam={len(parts)}): {txt}"
-            self.var_status.set(msg)
-            print(msg) # Imprime no console para você ver
+        if tipo == "resposta":
+            self.var_status.set(f"Resposta: {quadro[1]}")
             return
-
-        try:
-            # Tenta converter os números
-            A = int(parts[0])
-            D = int(parts[1])
-            M = int(parts[2])
-            H = int(parts[3])
-            VV = float(parts[4])
-            TT = float(parts[5])
-        except Exception as e:
-            # AQUI ESTAVA O PROBLEMA: O código antigo ignorava o erro.
-            # Agora vamos mostrar qual dado está quebrando o gráfico.
-            msg = f"Erro Conversão: {e} | Dados: {parts}"
-            self.var_status.set(msg)
-            print(msg) 
+        if tipo == "canal":
+            self._processar_canal(quadro[1], quadro[2])
+            return
+        if tipo == "erro":
+            self.var_status.set(quadro[1])
+            print(quadro[1]) # Imprime no console para você ver
+            return
+        if tipo == "falha":
+            self._disconnect()
+            self.var_status.set(quadro[1])
+            return
+        if tipo == "falha_envio":
+            self.pendentes.pop(quadro[1], None)
+            messagebox.showerror("Erro", f"Falha no envio: {quadro[2]}")
+            self._enviar_proximo()
             return
 
+        A, D, M, H, VV, TT, seq, ms = quadro[1:]
+
         # Se chegou aqui, atualiza a interface e os gráficos
+        self.ultima_amostra = (A, D, M, H, VV, TT)
+        if exibir:
+            self._exibir_amostra()
+
+        # Instante da amostra: relógio do firmware quando disponível, senão a chegada
+        if seq:
+            t = self._carimbo(seq, ms, chegada, exibir)
+        else:
+            t = datetime.now().timestamp() if chegada is None else chegada
+        self.plots.append(t, H, VV, TT)
+        
+        if self.logging_enabled.get() and self.trilha:
+            try:
+                carimbo = (int(seq, 16), int(ms, 16))
+            except ValueError:
+                carimbo = (None, None)
+            self.trilha.registra(round(t * 1e6), A, D, M, H, VV, TT, *carimbo)
+        elif self.logging_enabled.get() and self.csv_writer:
+            now = datetime.fromtimestamp(t).isoformat(timespec="milliseconds")
+            self.csv_writer.writerow([now, A, D, M, H, f"{VV:.1f}", f"{TT:.1f}", seq, ms])
+
+    def _exibir_amostra(self):
+        A, D, M, H, VV, TT = self.ultima_amostra
         self.var_andar.set(str(A))
         self.var_dest.set(str(D))
         self.var_motor.set(MOTOR_ESTADOS.get(M, f"Desc ({M})"))
@@ -294,32 +821,129 @@ class ElevadorGUI:
         self.var_vel.set(f"{VV:.1f}")
         self.var_temp.set(f"{TT:.1f}")
 
-        t = datetime.now().timestamp()
-        self.plots.append(t, H, VV, TT)
-        
-        if self.logging_enabled.get() and self.csv_writer:
-            now = datetime.now().isoformat(timespec="milliseconds")
-            self.csv_writer.writerow([now, A, D, M, H, f"{VV:.1f}", f"{TT:.1f}"])
+    # --------- Reprodução ----------
+    def _abrir_reproducao(self):
+        if self.enlace:
+            messagebox.showwarning("Reprodução", "Desconecte a serial antes de reproduzir um registro.")
+            return
+        p = filedialog.askopenfilename(title="Abrir registro",
+                                       filetypes=[("Registros", "*.elt *.csv"), ("Trilha", "*.elt"), ("CSV", "*.csv")])
+        if not p:
+            return
+        try:
+            reproducao = Reproducao(p)
+        except Exception as e:
+            messagebox.showerror("Reprodução", f"Erro ao ler {p}: {e}")
+            return
+        self.reproducao = reproducao
+        self.scl_cursor.configure(to=max(reproducao.duracao, 1e-3))
+        self.btn_tocar.configure(state="normal", text="Tocar")
+        self.var_status.set(f"Reprodução: {os.path.basename(p)}, {len(reproducao.t)} quadros, {reproducao.duracao:.1f} s")
+        self._reiniciar_reproducao()
+
+    def _fechar_reproducao(self):
+        self.reproducao = None
+        self.btn_tocar.configure(state="disabled", text="Tocar")
+        self.var_instante.set("-")
+
+    def _reiniciar_reproducao(self):
+        """Após abrir ou buscar: o carimbo e os gráficos recomeçam no novo ponto."""
+        r = self.reproducao
+        self._reiniciar_carimbo()
+        self.plots.limpar(t0=float(r.t[0]))
+        self._mostrar_cursor()
+
+    def _tocar_pausar(self):
+        r = self.reproducao
+        if r.rodando:
+            r.pausar()
+            self.btn_tocar.configure(text="Tocar")
+            return
+        if r.terminou:
+            r.buscar(0.0)
+            self._reiniciar_reproducao()
+        r.tocar(VELOCIDADES[self.cmb_velocidade.get()])
+        self.btn_tocar.configure(text="Pausar")
+
+    def _mudar_velocidade(self):
+        r = self.reproducao
+        if r and r.rodando:
+            r.tocar(VELOCIDADES[self.cmb_velocidade.get()])
+
+    def _buscar(self):
+        self.arrastando = False
+        r = self.reproducao
+        if not r:
+            return
+        r.buscar(self.var_cursor.get())
+        self._reiniciar_reproducao()
+
+    def _mostrar_cursor(self):
+        r = self.reproducao
+        if not self.arrastando:
+            self.var_cursor.set(r.posicao)
+        self.var_instante.set(f"{r.posicao:.1f} / {r.duracao:.1f} s")
+
+    def _entregar_reproducao(self):
+        """Entrega os quadros devidos até agora, dentro de REPRODUCAO_ORCAMENTO_S.
+
+        Os indicadores só mostram a última amostra de cada entrega; os quadros que
+        não couberem no orçamento ficam para a próxima (a reprodução atrasa em vez
+        de travar a interface).
+        """
+        try:
+            r = self.reproducao
+            if r and r.rodando:
+                fim = r.fim_agora()
+                limite = time.perf_counter() + REPRODUCAO_ORCAMENTO_S
+                inicio = r.k
+                while r.k < fim:
+                    k = r.k
+                    r.k += 1
+                    self._process_line(r.quadro(k), chegada=float(r.t[k]), exibir=False)
+                    if not (r.k & 63) and time.perf_counter() > limite:
+                        break
+                if r.k > inicio:
+                    self._exibir_amostra()
+                    self.var_perdidos.set(str(self.quadros_perdidos))
+                if r.terminou:
+                    r.pausar()
+                    self.btn_tocar.configure(text="Tocar")
+                self._mostrar_cursor()
+        except Exception as e:
+            print("Reprodução:", e)
+        finally:
+            self.master.after(REPRODUCAO_MS, self._entregar_reproducao)
 
     def _toggle_csv(self):
         if self.logging_enabled.get():
-            p = filedialog.asksaveasfilename(title="Salvar CSV", defaultextension=".csv",
-                                             filetypes=[("CSV","*.csv")],
-                                             initialfile=f"elevador_log_{datetime.now().strftime('%Y%m%d_%H%M%S')}.csv")
+            p = filedialog.asksaveasfilename(title="Salvar registro", defaultextension=".elt",
+                                             filetypes=[("Trilha","*.elt"),("CSV","*.csv")],
+                                             initialfile=f"elevador_log_{datetime.now().strftime('%Y%m%d_%H%M%S')}.elt")
             if not p:
                 self.logging_enabled.set(False); return
             try:
+                if not p.lower().endswith(".csv"):
+                    self.trilha = EscritorTrilha(p)
+                    return
                 self.csv_file = open(p,"w",newline="",encoding="utf-8")
                 self.csv_writer = csv.writer(self.csv_file)
-                self.csv_writer.writerow(["timestamp","A","D","M","pos_mm","vel_mms","temp_C"])
+                self.csv_writer.writerow(["timestamp","A","D","M","pos_mm","vel_mms","temp_C","seq","fw_ms"])
             except Exception as e:
-                messagebox.showerror("CSV", f"Erro ao abrir arquivo: {e}")
+                messagebox.showerror("Registro", f"Erro ao abrir arquivo: {e}")
                 self.logging_enabled.set(False)
         else:
             try:
                 if self.csv_file: self.csv_file.close()
+                if self.trilha: self.trilha.fechar()
             finally:
-                self.csv_file = None; self.csv_writer = None
+                self.csv_file = None; self.csv_writer = None; self.trilha = None
+
+    def _ao_fechar(self):
+        # A trilha só ganha o último bloco e o índice ao ser fechada
+        self.logging_enabled.set(False)
+        self._toggle_csv()
+        self.master.destroy()
 
     def _plot_timer(self):
         try:
@@ -344,6 +968,7 @@ def main():
     except Exception:
         pass
     app = ElevadorGUI(root)
+    root.protocol("WM_DELETE_WINDOW", app._ao_fechar)
     root.mainloop()
 
 if __name__ == "__main__":
@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Trilha binária de telemetria (.elt)
+-----------------------------------
+Formato colunar, só de acréscimo, gravado pelo app (registro da telemetria) e
+pelo simulador (elevsim --trilha). Todos os campos são little-endian e de
+largura fixa:
+
+- Cabeçalho (16 bytes): "ELTR", versão (u16 = 1), origem do tempo (u8:
+  0 = µs desde 1970, 1 = µs de tempo virtual do simulador) e 9 bytes reservados.
+- Blocos: cabeçalho de 32 bytes ("BLOC", quantidade n (u32), primeiro e último
+  instante (i64), bytes das colunas (u32), reservado (u32)) seguido das
+  colunas de COLUNAS, cada uma com n valores e completada até múltiplo de 8.
+- Índice, ao fechar: 32 bytes por bloco (posição (u64), n (u32), reservado,
+  primeiro e último instante (i64)) e o rodapé de 16 bytes (posição do índice
+  (u64), quantidade de blocos (u32), "FIMT").
+
+A leitura mapeia o arquivo na memória e cria as colunas sem copiar dados além
+da concatenação final. Sem rodapé (gravação interrompida), os blocos completos
+são encontrados percorrendo os cabeçalhos desde o início.
+
+Uso:
+    python trilha.py info sessao.elt
+    python trilha.py csv sessao.elt [sessao.csv]
+"""
+import csv
+import mmap
+import os
+import struct
+import sys
+import time
+from datetime import datetime
+
+import numpy as np
+
+MAGIA = b"ELTR"
+MAGIA_BLOCO = b"BLOC"
+MAGIA_FIM = b"FIMT"
+VERSAO = 1
+
+ORIGEM_UNIX = 0      # Instantes em µs desde 1970 (app)
+ORIGEM_VIRTUAL = 1   # Instantes em µs de tempo virtual desde o reset (simulador)
+
+# Coluna, tipo e escala (valor gravado = valor * escala)
+COLUNAS = (
+    ("t", "<i8", 1),           # Instante (µs)
+    ("pos_mm", "<u2", 1),
+    ("vel_mms", "<i2", 10),    # 0,1 mm/s
+    ("temp_C", "<i2", 10),     # 0,1 °C
+    ("fw_ms", "<u2", 1),       # Relógio do firmware (ms, 16 bits)
+    ("A", "u1", 1),
+    ("D", "u1", 1),
+    ("M", "u1", 1),
+    ("seq", "u1", 1),          # Sequência do quadro
+    ("flags", "u1", 1),        # Bit 0: quadro com carimbo (seq e fw_ms válidos)
+)
+FLAG_CARIMBO = 0x01
+
+CABECALHO = struct.Struct("<4sHB9x")
+CABECALHO_BLOCO = struct.Struct("<4sIqqII")
+ENTRADA_INDICE = struct.Struct("<QIIqq")
+RODAPE = struct.Struct("<QI4s")
+
+BLOCO_MAX = 4096     # Amostras por bloco
+BLOCO_MAX_S = 30.0   # Tempo máximo de uma amostra na memória antes de ir ao disco
+
+
+def _alinhado(n):
+    return (n + 7) & ~7
+
+
+class EscritorTrilha:
+    """Acumula as amostras e grava um bloco a cada BLOCO_MAX amostras ou BLOCO_MAX_S.
+
+    Uma queda do app perde no máximo o bloco em memória; o índice só é gravado
+    em fechar().
+    """
+
+    def __init__(self, caminho, origem=ORIGEM_UNIX):
+        self.f = open(caminho, "wb")
+        self.f.write(CABECALHO.pack(MAGIA, VERSAO, origem))
+        self.indice = []
+        self.colunas = [[] for _ in COLUNAS]
+        self.inicio_bloco = None
+
+    def registra(self, t_us, A, D, M, pos_mm, vel_mms, temp_C, seq=None, fw_ms=None):
+        carimbo = seq is not None and fw_ms is not None
+        valores = (t_us, pos_mm, round(vel_mms * 10), round(temp_C * 10),
+                   fw_ms if carimbo else 0, A, D, M, seq if carimbo else 0,
+                   FLAG_CARIMBO if carimbo else 0)
+        for coluna, v in zip(self.colunas, valores):
+            coluna.append(v)
+        agora = time.monotonic()
+        if self.inicio_bloco is None:
+            self.inicio_bloco = agora
+        if len(self.colunas[0]) >= BLOCO_MAX or agora - self.inicio_bloco >= BLOCO_MAX_S:
+            self._grava_bloco()
+
+    def _grava_bloco(self):
+        n = len(self.colunas[0])
+        self.inicio_bloco = None
+        if not n:
+            return
+        partes = []
+        for (_, tipo, _), valores in zip(COLUNAS, self.colunas):
+            dados = np.asarray(valores, dtype=tipo).tobytes()
+            partes.append(dados + bytes(_alinhado(len(dados)) - len(dados)))
+        corpo = b"".join(partes)
+        t = self.colunas[0]
+        posicao = self.f.tell()
+        self.f.write(CABECALHO_BLOCO.pack(MAGIA_BLOCO, n, t[0], t[-1], len(corpo), 0))
+        self.f.write(corpo)
+        self.f.flush()
+        self.indice.append(ENTRADA_INDICE.pack(posicao, n, 0, t[0], t[-1]))
+        self.colunas = [[] for _ in COLUNAS]
+
+    def fechar(self):
+        self._grava_bloco()
+        posicao = self.f.tell()
+        self.f.write(b"".join(self.indice))
+        self.f.write(RODAPE.pack(posicao, len(self.indice), MAGIA_FIM))
+        self.f.close()
+
+
+def _blocos(m):
+    """(posição, n) de cada bloco: pelo índice do rodapé ou percorrendo os cabeçalhos."""
+    if len(m) >= CABECALHO.size + RODAPE.size:
+        posicao, quantidade, magia = RODAPE.unpack_from(m, len(m) - RODAPE.size)
+        if magia == MAGIA_FIM and posicao + quantidade * ENTRADA_INDICE.size == len(m) - RODAPE.size:
+            return [ENTRADA_INDICE.unpack_from(m, posicao + k * ENTRADA_INDICE.size)[:2]
+                    for k in range(quantidade)]
+    blocos = []
+    posicao = CABECALHO.size
+    while posicao + CABECALHO_BLOCO.size <= len(m):
+        magia, n, _, _, tamanho, _ = CABECALHO_BLOCO.unpack_from(m, posicao)
+        if magia != MAGIA_BLOCO or posicao + CABECALHO_BLOCO.size + tamanho > len(m):
+            break
+        blocos.append((posicao, n))
+        posicao += CABECALHO_BLOCO.size + tamanho
+    return blocos
+
+
+def ler_trilha(caminho):
+    """Lê uma trilha: (origem, {coluna: array}) com vel_mms e temp_C já em unidades."""
+    with open(caminho, "rb") as f:
+        if os.fstat(f.fileno()).st_size < CABECALHO.size:
+            raise ValueError(f"{caminho}: arquivo curto demais")
+        m = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+    partes = {nome: [] for nome, _, _ in COLUNAS}
+    try:
+        magia, versao, origem = CABECALHO.unpack_from(m, 0)
+        if magia != MAGIA or versao != VERSAO:
+            raise ValueError(f"{caminho}: não é uma trilha versão {VERSAO}")
+        for posicao, n in _blocos(m):
+            p = posicao + CABECALHO_BLOCO.size
+            for nome, tipo, _ in COLUNAS:
+                partes[nome].append(np.frombuffer(m, dtype=tipo, count=n, offset=p))
+                p += _alinhado(n * np.dtype(tipo).itemsize)
+        dados = {}
+        for nome, tipo, escala in COLUNAS:
+            coluna = np.concatenate(partes[nome]) if partes[nome] else np.empty(0, tipo)
+            dados[nome] = coluna / escala if escala != 1 else coluna
+        return origem, dados
+    finally:
+        partes.clear()   # As visões do mapa precisam sumir antes de fechá-lo
+        m.close()
+
+
+def para_csv(caminho, saida):
+    """Converte para o CSV do registro antigo do app (mesmas colunas)."""
+    origem, d = ler_trilha(caminho)
+    with open(saida, "w", newline="", encoding="utf-8") as f:
+        w = csv.writer(f)
+        w.writerow(["timestamp", "A", "D", "M", "pos_mm", "vel_mms", "temp_C", "seq", "fw_ms"])
+        # Em fatias: tolist() evita o acesso elemento a elemento aos arrays
+        for ini in range(0, len(d["t"]), 65536):
+            fatia = {nome: d[nome][ini:ini + 65536].tolist() for nome in d}
+            for t, A, D, M, p, v, te, flags, seq, ms in zip(
+                    fatia["t"], fatia["A"], fatia["D"], fatia["M"], fatia["pos_mm"],
+                    fatia["vel_mms"], fatia["temp_C"], fatia["flags"], fatia["seq"], fatia["fw_ms"]):
+                if origem == ORIGEM_UNIX:
+                    instante = datetime.fromtimestamp(t / 1e6).isoformat(timespec="milliseconds")
+                else:
+                    instante = f"{t / 1e6:.6f}"
+                if flags & FLAG_CARIMBO:
+                    carimbo = (f"{seq:02X}", f"{ms:04X}")
+                else:
+                    carimbo = ("", "")
+                w.writerow([instante, A, D, M, p, f"{v:.1f}", f"{te:.1f}", *carimbo])
+
+
+def main():
+    if len(sys.argv) < 3 or sys.argv[1] not in ("info", "csv"):
+        print(__doc__.split("Uso:")[1].rstrip(), file=sys.stderr)
+        sys.exit(2)
+    caminho = sys.argv[2]
+    if sys.argv[1] == "csv":
+        saida = sys.argv[3] if len(sys.argv) > 3 else os.path.splitext(caminho)[0] + ".csv"
+        para_csv(caminho, saida)
+        return
+    inicio = time.perf_counter()
+    origem, d = ler_trilha(caminho)
+    duracao = time.perf_counter() - inicio
+    n = len(d["t"])
+    print(f"{caminho}: {n} amostras, origem {'virtual' if origem == ORIGEM_VIRTUAL else 'unix'}, "
+          f"lida em {duracao * 1000:.1f} ms")
+    if n:
+        print(f"  {(d['t'][-1] - d['t'][0]) / 1e6:.1f} s, {os.path.getsize(caminho) / n:.1f} bytes por amostra")
+
+
+if __name__ == "__main__":
+    main()
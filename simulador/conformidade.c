@@ -0,0 +1,463 @@
+/**
+ * @file conformidade.c
+ * @brief Executável "elevconf": testes de propriedade do escalonador com sequências aleatórias.
+ * @details Cada sequência roda o firmware real sobre a planta em um processo
+ * filho (fork), partindo sempre do mesmo estado de reset, com:
+ * - pedidos e lotes de pedidos aleatórios em instantes aleatórios;
+ * - posição inicial aleatória (às vezes entre andares, forçando a busca de referência);
+ * - às vezes perda de pulsos no encoder e repique nos sensores de andar.
+ *
+ * Invariantes verificados a cada passo da planta (1 ms):
+ * - Todo passageiro embarca (porta aberta no andar de origem após o pedido)
+ *   e desembarca (porta aberta no destino após o embarque).
+ * - Nenhuma espera passa de --limite segundos, nenhuma viagem passa do dobro.
+ * - O motor nunca é acionado além da janela de S1 (descendo) ou de S4
+ *   (subindo) e a cabine nunca atinge os batentes.
+ * - A porta só abre com a cabine alinhada ao andar e o motor fica desligado
+ *   por todo o tempo de porta calculado (tempo_porta).
+ *
+ * O filho devolve o resultado por um pipe; o pai mantém --jobs filhos em
+ * paralelo e resume vazão, pior espera e as sementes que falharam. Uma
+ * sequência é reproduzida com --semente S --sequencias 1 -v.
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "sim.h"
+#include "planta.h"
+#include "globals.h"
+
+
+// CONFIGURAÇÃO
+
+/**
+ * @brief Limites da geração aleatória.
+ * - PEDIDOS_MAX: Passageiros por sequência.
+ * - JANELA_S:    Intervalo em que os pedidos chegam.
+ * - QUANTUM_US:  Granularidade da injeção de pedidos.
+ * - ALINHAMENTO: Folga além da janela do sensor aceita em uma parada (mm).
+ */
+#define PEDIDOS_MAX      12
+#define JANELA_S         60.0
+#define QUANTUM_US       10000
+#define ALINHAMENTO_MM   2.0
+#define MOTIVO_MAX       120
+#define FALHAS_LISTADAS  10
+
+static struct {
+    uint64_t semente;       // Semente da primeira sequência
+    uint32_t sequencias;    // Quantidade de sequências
+    int jobs;               // Processos filhos em paralelo
+    double limite_s;        // Espera máxima aceita
+    int verboso;            // Eventos da sequência na saída de erro
+} cfg = { 1, 1000, 1, 60.0, 0 };
+
+
+// GERADOR ALEATÓRIO (xorshift64*, reprodutível entre plataformas)
+
+static uint64_t rng_estado;
+
+static uint32_t Aleatorio(void) {
+    rng_estado ^= rng_estado >> 12;
+    rng_estado ^= rng_estado << 25;
+    rng_estado ^= rng_estado >> 27;
+    return (uint32_t)((rng_estado * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static uint32_t Faixa(uint32_t n) {
+    return Aleatorio() % n;
+}
+
+static double Uniforme(double a, double b) {
+    return a + (b - a) * (Aleatorio() / 4294967296.0);
+}
+
+
+// SEQUÊNCIA (processo filho)
+
+/**
+ * @brief Passageiro de uma sequência.
+ * @note Instantes em µs de tempo virtual; 0 = ainda não aconteceu.
+ */
+typedef struct {
+    uint64_t t_pedido;
+    uint64_t t_embarque;
+    uint64_t t_chegada;
+    uint8_t origem;
+    uint8_t destino;
+    bool injetado;
+} Passageiro;
+
+/**
+ * @brief Resultado enviado ao processo pai.
+ */
+typedef struct {
+    uint64_t semente;
+    double simulado_s;
+    double pior_espera_s;
+    double pior_viagem_s;
+    uint32_t passageiros;
+    uint32_t paradas;
+    int falhou;
+    char motivo[MOTIVO_MAX];
+} Resultado;
+
+static Passageiro passageiros[PEDIDOS_MAX];
+static int n_passageiros;
+static Resultado res;
+static int fd_resultado;
+
+// Perturbações dos sensores
+static bool com_repique;
+static bool sensor_anterior[PLANTA_ANDARES];
+static uint64_t repique_ate[PLANTA_ANDARES];
+
+// Acompanhamento da máquina de estados
+static EstadoElevador estado_anterior = ESTADO_PARADO;
+static uint64_t t_porta = 0;            // Abertura da porta em andamento
+static uint64_t porta_minima_us = 0;    // Tempo de porta exigido na abertura
+static uint64_t t_fim = 0;              // Prazo final da sequência
+
+static double Segundos(uint64_t us) {
+    return (double)us * 1e-6;
+}
+
+/**
+ * @brief Envia o resultado ao pai e encerra o filho.
+ */
+static void Termina(void) {
+    res.simulado_s = Segundos(Sim_Agora_us());
+    ssize_t n = write(fd_resultado, &res, sizeof(res));
+    (void)n;
+    _exit(0);
+}
+
+/**
+ * @brief Registra a violação de um invariante e encerra a sequência.
+ */
+static void Viola(const char* formato, ...) __attribute__((format(printf, 1, 2)));
+static void Viola(const char* formato, ...) {
+    va_list ap;
+    int n = snprintf(res.motivo, sizeof(res.motivo), "t=%.3f s: ", Segundos(Sim_Agora_us()));
+    va_start(ap, formato);
+    vsnprintf(res.motivo + n, sizeof(res.motivo) - (size_t)n, formato, ap);
+    va_end(ap);
+    res.falhou = 1;
+    if (cfg.verboso) fprintf(stderr, "VIOLAÇÃO %s\n", res.motivo);
+    Termina();
+}
+
+/**
+ * @brief Porta aberta em um andar: embarques e desembarques.
+ */
+static void Porta_Abriu(uint8_t andar, uint64_t agora) {
+    res.paradas++;
+    if (cfg.verboso) fprintf(stderr, "%9.3f porta aberta no andar %u\n", Segundos(agora), andar);
+
+    for (int i = 0; i < n_passageiros; i++) {
+        Passageiro* p = &passageiros[i];
+        if (!p->injetado) continue;
+        if (p->t_embarque && !p->t_chegada && p->destino == andar) {
+            p->t_chegada = agora;
+            double viagem = Segundos(agora - p->t_pedido);
+            if (viagem > res.pior_viagem_s) res.pior_viagem_s = viagem;
+        }
+        else if (!p->t_embarque && p->origem == andar && agora > p->t_pedido) {
+            p->t_embarque = agora;
+            double espera = Segundos(agora - p->t_pedido);
+            if (espera > res.pior_espera_s) res.pior_espera_s = espera;
+        }
+    }
+}
+
+/**
+ * @brief Verificador chamado após cada passo da planta.
+ */
+static void Verifica_Planta(void) {
+    const PlantaEstado* e = Planta_Estado();
+    const PlantaParametros* par = Planta_Parametros();
+    uint64_t agora = Sim_Agora_us();
+    uint16_t duty = Sim_DutyPWM();
+    bool subir = LATAbits.LATA7 != 0;
+
+    // 1. Repique: por alguns ms após cada borda real o pino oscila
+    if (com_repique) {
+        for (int i = 0; i < PLANTA_ANDARES; i++) {
+            if (e->sensor[i] != sensor_anterior[i]) {
+                sensor_anterior[i] = e->sensor[i];
+                repique_ate[i] = agora + 1000u * (1 + Faixa(5));
+            }
+            if (agora < repique_ate[i] && Faixa(2)) {
+                bool ativo = !e->sensor[i];
+                if (i == 0) PORTBbits.RB0 = ativo ? 0 : 1;
+                if (i == 1) PORTBbits.RB3 = ativo ? 0 : 1;
+                if (i == 2) CM1CON0bits.C1OUT = ativo ? 1 : 0;
+                if (i == 3) CM2CON0bits.C2OUT = ativo ? 1 : 0;
+            }
+        }
+    }
+
+    // 2. Fins de curso: motor acionado além das janelas de S1/S4 ou batente atingido
+    double fundo = par->altura_andar_mm[0] - par->janela_sensor_mm;
+    double topo = par->altura_andar_mm[PLANTA_ANDARES - 1] + par->janela_sensor_mm;
+    if (duty && !subir && e->posicao_mm < fundo) Viola("motor descendo abaixo de S1 (%.1f mm)", e->posicao_mm);
+    if (duty && subir && e->posicao_mm > topo) Viola("motor subindo acima de S4 (%.1f mm)", e->posicao_mm);
+    if (e->posicao_mm <= par->curso_min_mm || e->posicao_mm >= par->curso_max_mm) {
+        Viola("cabine no batente (%.1f mm)", e->posicao_mm);
+    }
+
+    // 3. Abertura da porta: cabine alinhada e tempo de porta registrado
+    EstadoElevador estado = estado_atual;
+    if (cfg.verboso && estado != estado_anterior) {
+        fprintf(stderr, "%9.3f estado %d -> %d, andar %u, %.1f mm\n", Segundos(agora),
+                estado_anterior, estado, andar_atual, e->posicao_mm);
+    }
+    if (estado == ESTADO_ESPERA_PORTA && estado_anterior != ESTADO_ESPERA_PORTA) {
+        uint8_t andar = andar_atual;
+        double desvio = e->posicao_mm - par->altura_andar_mm[andar];
+        if (desvio < 0) desvio = -desvio;
+        if (desvio > par->janela_sensor_mm + ALINHAMENTO_MM) {
+            Viola("porta aberta no andar %u desalinhada (%.1f mm)", andar, desvio);
+        }
+        t_porta = agora;
+        porta_minima_us = (uint64_t)tempo_porta * 10000u;
+        Porta_Abriu(andar, agora);
+    }
+    estado_anterior = estado;
+
+    // 4. Tempo de porta: motor desligado até o fim do tempo calculado
+    if (t_porta && duty) {
+        if (agora - t_porta < porta_minima_us) {
+            Viola("motor ligado %.3f s após abrir a porta (mínimo %.3f s)",
+                  Segundos(agora - t_porta), Segundos(porta_minima_us));
+        }
+        t_porta = 0;
+    }
+}
+
+/**
+ * @brief Gancho de quantum: injeta os pedidos devidos e verifica os prazos.
+ */
+static void Quantum(void) {
+    uint64_t agora = Sim_Agora_us();
+    uint64_t limite = (uint64_t)(cfg.limite_s * 1e6);
+    int pendentes = 0;
+
+    // 1. Pedidos do instante, agrupados em um lote de até 5 pares
+    char quadro[16] = "$";
+    int pares = 0;
+    for (int i = 0; i < n_passageiros; i++) {
+        Passageiro* p = &passageiros[i];
+        if (!p->injetado && p->t_pedido <= agora && pares < 5) {
+            quadro[1 + 2 * pares] = (char)('0' + p->origem);
+            quadro[2 + 2 * pares] = (char)('0' + p->destino);
+            pares++;
+            p->injetado = true;
+            p->t_pedido = agora;
+            if (cfg.verboso) fprintf(stderr, "%9.3f pedido %u -> %u\n", Segundos(agora), p->origem, p->destino);
+        }
+    }
+    if (pares) {
+        quadro[1 + 2 * pares] = '\r';
+        Sim_InjetaRx((const uint8_t*)quadro, (size_t)(2 + 2 * pares));
+    }
+
+    // 2. Prazos de espera e de viagem
+    for (int i = 0; i < n_passageiros; i++) {
+        Passageiro* p = &passageiros[i];
+        if (!p->injetado || p->t_chegada) {
+            if (!p->injetado) pendentes++;
+            continue;
+        }
+        pendentes++;
+        if (!p->t_embarque && agora - p->t_pedido > limite) {
+            Viola("passageiro %u -> %u sem embarque após %.1f s", p->origem, p->destino, cfg.limite_s);
+        }
+        if (agora - p->t_pedido > 2 * limite) {
+            Viola("passageiro %u -> %u sem desembarque após %.1f s", p->origem, p->destino, 2 * cfg.limite_s);
+        }
+    }
+
+    // 3. Fim: todos atendidos (com folga para verificar a última porta) ou prazo esgotado
+    if (!pendentes && !t_fim) t_fim = agora + 3000000u;
+    if (t_fim && agora >= t_fim) Termina();
+}
+
+/**
+ * @brief Sorteia a sequência e executa o firmware até o fim (não retorna).
+ */
+static void Executa_Sequencia(uint64_t semente) {
+    rng_estado = semente * 0x9E3779B97F4A7C15ULL + 1;
+    memset(&res, 0, sizeof(res));
+    res.semente = semente;
+
+    // 1. Posição inicial: um andar ou, às vezes, entre andares
+    double posicao = PLANTA_PADRAO.altura_andar_mm[Faixa(PLANTA_ANDARES)];
+    if (Faixa(8) == 0) posicao = Uniforme(10.0, 170.0);
+
+    // 2. Perturbações
+    if (Faixa(4) == 0) Sim_PerdaEncoder(Uniforme(0.0, 0.03));
+    com_repique = (Faixa(4) == 0);
+
+    // 3. Passageiros
+    n_passageiros = 1 + (int)Faixa(PEDIDOS_MAX);
+    res.passageiros = (uint32_t)n_passageiros;
+    for (int i = 0; i < n_passageiros; i++) {
+        Passageiro* p = &passageiros[i];
+        p->origem = (uint8_t)Faixa(4);
+        p->destino = (uint8_t)((p->origem + 1 + Faixa(3)) % 4);
+        // Às vezes vários pedidos no mesmo instante (lote)
+        p->t_pedido = (i && Faixa(4) == 0) ? passageiros[i - 1].t_pedido
+                                           : (uint64_t)(Uniforme(0.0, JANELA_S) * 1e6);
+    }
+
+    if (cfg.verboso) {
+        fprintf(stderr, "semente %llu: início %.1f mm, repique %s\n",
+                (unsigned long long)semente, posicao, com_repique ? "sim" : "não");
+    }
+
+    Sim_GanchoPlanta = Verifica_Planta;
+    Sim_GanchoQuantum = Quantum;
+    Sim_Inicializa(posicao, QUANTUM_US);
+    for (int i = 0; i < PLANTA_ANDARES; i++) sensor_anterior[i] = Planta_Estado()->sensor[i];
+
+    firmware_main();
+    Termina();
+}
+
+
+// EXECUÇÃO DO LOTE (processo pai)
+
+typedef struct {
+    pid_t pid;
+    int fd;
+    uint64_t semente;
+} Filho;
+
+static double Relogio_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static void Uso(const char* prog) {
+    fprintf(stderr,
+        "uso: %s [opções]\n"
+        "  --sequencias N     quantidade de sequências (padrão 1000)\n"
+        "  --semente S        semente da primeira sequência (padrão 1)\n"
+        "  --jobs N           sequências em paralelo (padrão 1)\n"
+        "  --limite S         espera máxima aceita em segundos (padrão 60)\n"
+        "  -v                 eventos de cada sequência na saída de erro\n", prog);
+}
+
+static pid_t Lanca(uint64_t semente, int* fd) {
+    int p[2];
+    if (pipe(p) < 0) {
+        perror("pipe");
+        exit(2);
+    }
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        exit(2);
+    }
+    if (pid == 0) {
+        close(p[0]);
+        fd_resultado = p[1];
+        Executa_Sequencia(semente);
+    }
+    close(p[1]);
+    *fd = p[0];
+    return pid;
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!strcmp(a, "--sequencias") && v) { cfg.sequencias = (uint32_t)strtoul(v, NULL, 10); i++; }
+        else if (!strcmp(a, "--semente") && v) { cfg.semente = strtoull(v, NULL, 10); i++; }
+        else if (!strcmp(a, "--jobs") && v) { cfg.jobs = atoi(v); i++; }
+        else if (!strcmp(a, "--limite") && v) { cfg.limite_s = atof(v); i++; }
+        else if (!strcmp(a, "-v")) cfg.verboso = 1;
+        else { Uso(argv[0]); return 2; }
+    }
+    if (cfg.sequencias == 0 || cfg.jobs < 1 || cfg.limite_s <= 0) {
+        Uso(argv[0]);
+        return 2;
+    }
+
+    Filho* filhos = calloc((size_t)cfg.jobs, sizeof(Filho));
+    uint32_t lancadas = 0, concluidas = 0, falhas = 0, passageiros = 0, paradas = 0;
+    double simulado = 0, pior_espera = 0, pior_viagem = 0;
+    uint64_t semente_espera = 0, semente_viagem = 0;
+    double inicio = Relogio_s();
+
+    while (concluidas < cfg.sequencias) {
+
+        // 1. Mantém --jobs filhos rodando
+        for (int j = 0; j < cfg.jobs && lancadas < cfg.sequencias; j++) {
+            if (filhos[j].pid) continue;
+            filhos[j].semente = cfg.semente + lancadas++;
+            filhos[j].pid = Lanca(filhos[j].semente, &filhos[j].fd);
+        }
+
+        // 2. Recolhe o próximo filho que terminar
+        int st;
+        pid_t pid = wait(&st);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            perror("wait");
+            return 2;
+        }
+        int j = 0;
+        while (j < cfg.jobs && filhos[j].pid != pid) j++;
+        if (j == cfg.jobs) continue;
+
+        Resultado r;
+        ssize_t n = read(filhos[j].fd, &r, sizeof(r));
+        close(filhos[j].fd);
+        filhos[j].pid = 0;
+        concluidas++;
+
+        if (n != (ssize_t)sizeof(r)) {
+            memset(&r, 0, sizeof(r));
+            r.semente = filhos[j].semente;
+            r.falhou = 1;
+            if (WIFSIGNALED(st)) snprintf(r.motivo, sizeof(r.motivo), "processo terminou com o sinal %d", WTERMSIG(st));
+            else snprintf(r.motivo, sizeof(r.motivo), "processo terminou sem resultado");
+        }
+
+        // 3. Acumula
+        simulado += r.simulado_s;
+        passageiros += r.passageiros;
+        paradas += r.paradas;
+        if (r.pior_espera_s > pior_espera) { pior_espera = r.pior_espera_s; semente_espera = r.semente; }
+        if (r.pior_viagem_s > pior_viagem) { pior_viagem = r.pior_viagem_s; semente_viagem = r.semente; }
+        if (r.falhou) {
+            if (falhas < FALHAS_LISTADAS) {
+                printf("FALHA semente %llu: %s\n", (unsigned long long)r.semente, r.motivo);
+            }
+            falhas++;
+        }
+    }
+
+    double real = Relogio_s() - inicio;
+    printf("sequências:   %u (%u com violação)\n", cfg.sequencias, falhas);
+    printf("passageiros:  %u, %u paradas\n", passageiros, paradas);
+    printf("vazão:        %.0f sequências/s, %.0f s simulados por s real (%.1f s reais, %d jobs)\n",
+           cfg.sequencias / real, simulado / real, real, cfg.jobs);
+    printf("pior espera:  %.2f s (semente %llu)\n", pior_espera, (unsigned long long)semente_espera);
+    printf("pior viagem:  %.2f s (semente %llu)\n", pior_viagem, (unsigned long long)semente_viagem);
+
+    free(filhos);
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Controle de grupo simulado (N cabines)
+--------------------------------------
+- Executa N instâncias de "elevsim --passo" (firmware real + modelo físico).
+- Despachante central: distribui as chamadas de andar entre as cabines
+  enviando lotes "$O1D1O2D2...\\r" pela UART de cada uma e acompanha a
+  telemetria "$A,D,M,PPP,VV.V,TT.T,NN,MMMM\\r" para saber onde cada cabine está.
+- Mede tempo de espera, tempo de viagem e capacidade de transporte.
+
+Uso:
+    python grupo.py --carros 2-8 --taxa 6 --duracao 1800
+"""
+import argparse
+import os
+import random
+import subprocess
+import sys
+
+AQUI = os.path.dirname(os.path.abspath(__file__))
+ELEVSIM = os.path.join(AQUI, "build", "elevsim")
+
+ANDARES = 4
+ALTURA_ANDAR_MM = [0, 60, 120, 180]
+VELOCIDADE_MMS = 21.0        # Velocidade nominal com MOTOR_ON (modelo da planta)
+TEMPO_PARADA_S = 2.0         # Custo estimado de cada parada (porta + aceleração)
+PEDIDOS_POR_LOTE = 5         # Pares por quadro "$O1D1O2D2...\r" (QUADRO_MAX do firmware)
+
+
+class Passageiro:
+    def __init__(self, pid, origem, destino, t):
+        self.id = pid
+        self.origem = origem
+        self.destino = destino
+        self.t_chamada = t
+        self.t_embarque = None
+        self.t_chegada = None
+        self.carro = None
+
+
+class Carro:
+    """Uma cabine simulada: processo elevsim + último estado da telemetria."""
+
+    def __init__(self, idx, quantum_ms, andar):
+        self.idx = idx
+        self.proc = subprocess.Popen(
+            [ELEVSIM, "--passo", "--quantum", str(quantum_ms), "--andar", str(andar)],
+            stdin=subprocess.PIPE, stdout=subprocess.PIPE, bufsize=0)
+        self.fd_out = self.proc.stdout.fileno()
+        self.rx = bytearray()        # Bytes da UART TX da cabine ainda não processados
+        self.fila_tx = []            # Pedidos (origem, destino) aguardando envio
+        self.andar = andar
+        self.motor = 0
+        self.pos = ALTURA_ANDAR_MM[andar]
+        self.passageiros = []        # Passageiros designados e ainda não entregues
+        self.quadros = 0
+
+    def envia_quantum(self):
+        """Entrega o próximo quantum com um lote de até PEDIDOS_POR_LOTE pedidos."""
+        lote = self.fila_tx[:PEDIDOS_POR_LOTE]
+        del self.fila_tx[:PEDIDOS_POR_LOTE]
+        quadro = ("$" + "".join(f"{o}{d}" for o, d in lote) + "\r") if lote else ""
+        self.proc.stdin.write(quadro.encode("ascii") + b"\n")
+
+    def recebe_quantum(self):
+        """Lê a saída até o marcador de fim de quantum e devolve os quadros."""
+        while True:
+            idx = self.rx.find(b"\n")
+            if idx >= 0:
+                dados = bytes(self.rx[:idx])
+                del self.rx[:idx + 1]
+                break
+            chunk = os.read(self.fd_out, 4096)
+            if not chunk:
+                raise RuntimeError(f"cabine {self.idx}: simulador encerrou")
+            self.rx.extend(chunk)
+        self._pendente = getattr(self, "_pendente", b"") + dados
+        partes = self._pendente.split(b"\r")
+        self._pendente = partes.pop()
+        return partes
+
+    def atualiza(self, quadro):
+        """Interpreta um quadro de telemetria; devolve True se válido."""
+        txt = quadro.decode("ascii", errors="ignore").strip()
+        if not txt.startswith("$"):
+            return False
+        partes = txt[1:].split(",")
+        if len(partes) < 6:
+            return False
+        try:
+            self.andar = int(partes[0])
+            self.motor = int(partes[2])
+            self.pos = int(partes[3])
+        except ValueError:
+            return False
+        self.quadros += 1
+        return True
+
+    def parado_em(self, andar):
+        # O firmware só desliga o motor sobre um sensor de andar; a posição em
+        # mm é estimada por odometria e pode divergir, por isso não é usada aqui.
+        return self.motor == 0 and self.andar == andar
+
+    def encerra(self):
+        try:
+            self.proc.stdin.close()
+        except OSError:
+            pass
+        self.proc.wait()
+
+
+# ESTRATÉGIAS DE DESPACHO
+
+def custo_estimado(carro, p):
+    """Tempo estimado (s) para o carro buscar o passageiro na origem."""
+    alvo = ALTURA_ANDAR_MM[p.origem]
+    distancia = abs(carro.pos - alvo)
+    # Cabine se afastando da origem: precisa ir até o extremo e voltar
+    if carro.motor == 1 and alvo < carro.pos:
+        distancia = (ALTURA_ANDAR_MM[-1] - carro.pos) * 2 + distancia
+    elif carro.motor == 2 and alvo > carro.pos:
+        distancia = carro.pos * 2 + distancia
+    paradas = 2 * len(carro.passageiros)
+    return distancia / VELOCIDADE_MMS + paradas * TEMPO_PARADA_S
+
+
+def escolhe_carro(estrategia, carros, p, rng, contador):
+    if estrategia == "aleatorio":
+        return rng.choice(carros)
+    if estrategia == "rodizio":
+        return carros[contador % len(carros)]
+    return min(carros, key=lambda c: (custo_estimado(c, p), c.idx))
+
+
+def sorteia_viagem(perfil, rng):
+    """Origem e destino conforme o perfil de tráfego."""
+    if perfil == "subida" and rng.random() < 0.8:
+        return 0, rng.randint(1, ANDARES - 1)
+    if perfil == "descida" and rng.random() < 0.8:
+        return rng.randint(1, ANDARES - 1), 0
+    origem = rng.randrange(ANDARES)
+    destino = rng.randrange(ANDARES - 1)
+    if destino >= origem:
+        destino += 1
+    return origem, destino
+
+
+# SIMULAÇÃO
+
+def percentil(valores, q):
+    if not valores:
+        return float("nan")
+    v = sorted(valores)
+    k = min(len(v) - 1, int(round(q * (len(v) - 1))))
+    return v[k]
+
+
+def simula(n_carros, args):
+    rng = random.Random(args.semente)
+    quantum_s = args.quantum / 1000.0
+    carros = [Carro(i, args.quantum, 0) for i in range(n_carros)]
+    passageiros = []
+    esperando = []
+    t = 0.0
+    contador = 0
+    prox_chegada = rng.expovariate(args.taxa / 60.0)
+
+    try:
+        while t < args.duracao:
+            # 1. Novas chamadas de andar (chegadas de Poisson)
+            while prox_chegada <= t:
+                o, d = sorteia_viagem(args.perfil, rng)
+                p = Passageiro(len(passageiros), o, d, prox_chegada)
+                c = escolhe_carro(args.estrategia, carros, p, rng, contador)
+                contador += 1
+                p.carro = c
+                c.passageiros.append(p)
+                c.fila_tx.append((o, d))
+                passageiros.append(p)
+                esperando.append(p)
+                prox_chegada += rng.expovariate(args.taxa / 60.0)
+
+            # 2. Avança um quantum em todas as cabines (em paralelo)
+            for c in carros:
+                c.envia_quantum()
+            t += quantum_s
+            for c in carros:
+                for quadro in c.recebe_quantum():
+                    if not c.atualiza(quadro):
+                        continue
+                    # 3. Embarque e desembarque pela telemetria
+                    for p in list(c.passageiros):
+                        if p.t_embarque is None and c.parado_em(p.origem):
+                            p.t_embarque = t
+                        elif p.t_embarque is not None and c.parado_em(p.destino):
+                            p.t_chegada = t
+                            c.passageiros.remove(p)
+    finally:
+        for c in carros:
+            c.encerra()
+
+    esperas = [p.t_embarque - p.t_chamada for p in passageiros if p.t_embarque is not None]
+    viagens = [p.t_chegada - p.t_chamada for p in passageiros if p.t_chegada is not None]
+    entregues = len(viagens)
+    return {
+        "carros": n_carros,
+        "chamadas": len(passageiros),
+        "entregues": entregues,
+        "pendentes": len(passageiros) - entregues,
+        "espera_media": sum(esperas) / len(esperas) if esperas else float("nan"),
+        "espera_p90": percentil(esperas, 0.9),
+        "espera_max": max(esperas) if esperas else float("nan"),
+        "viagem_media": sum(viagens) / len(viagens) if viagens else float("nan"),
+        "capacidade_h": entregues * 3600.0 / args.duracao,
+    }
+
+
+def faixa(txt):
+    if "-" in txt:
+        a, b = txt.split("-", 1)
+        return list(range(int(a), int(b) + 1))
+    return [int(x) for x in txt.split(",")]
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Simulação de controle de grupo de elevadores")
+    ap.add_argument("--carros", default="2-8", help="quantidade de cabines (ex.: 4, 2-8, 2,4,8)")
+    ap.add_argument("--taxa", type=float, default=6.0, help="passageiros por minuto")
+    ap.add_argument("--duracao", type=float, default=1800.0, help="tempo simulado (s)")
+    ap.add_argument("--perfil", choices=["misto", "subida", "descida"], default="misto")
+    ap.add_argument("--estrategia", choices=["custo", "rodizio", "aleatorio"], default="custo")
+    ap.add_argument("--quantum", type=int, default=100, help="quantum de sincronismo (ms)")
+    ap.add_argument("--semente", type=int, default=1)
+    args = ap.parse_args()
+
+    if not os.path.exists(ELEVSIM):
+        sys.exit(f"{ELEVSIM} não encontrado: execute 'make' em {AQUI}")
+
+    print(f"perfil={args.perfil} estrategia={args.estrategia} taxa={args.taxa}/min "
+          f"duracao={args.duracao:.0f}s")
+    print(f"{'carros':>6} {'chamadas':>8} {'entregues':>9} {'pend':>5} "
+          f"{'espera_med':>10} {'espera_p90':>10} {'espera_max':>10} "
+          f"{'viagem_med':>10} {'pass/h':>7}")
+    for n in faixa(args.carros):
+        r = simula(n, args)
+        print(f"{r['carros']:>6} {r['chamadas']:>8} {r['entregues']:>9} {r['pendentes']:>5} "
+              f"{r['espera_media']:>10.1f} {r['espera_p90']:>10.1f} {r['espera_max']:>10.1f} "
+              f"{r['viagem_media']:>10.1f} {r['capacidade_h']:>7.0f}")
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
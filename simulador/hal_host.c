@@ -0,0 +1,644 @@
+/**
+ * @file hal_host.c
+ * @brief Implementação no PC das APIs do MCC usadas pelo firmware.
+ * @details Substitui os arquivos de mcc_generated_files/ na compilação do
+ * simulador. Os buffers da EUSART seguem exatamente a lógica do driver gerado
+ * (anéis de 8 bytes na TX e 32 na RX, sem proteção contra estouro), para que falhas de
+ * recepção apareçam no simulador como apareceriam na placa.
+ *
+ * Limitação: as interrupções são atendidas apenas nos pontos em que o
+ * firmware cede o tempo (__delay_ms, SLEEP e espera na UART), nunca no meio
+ * de uma instrução do loop principal.
+ */
+
+#include <xc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mcc_generated_files/mcc.h"
+#include "sim.h"
+#include "planta.h"
+
+
+// REGISTRADORES EMULADOS
+
+#define XC_DEFINE_REGISTRO(nome, b0, b1, b2, b3, b4, b5, b6, b7) \
+    volatile nome##bits_t nome##bits;
+XC_REGISTROS(XC_DEFINE_REGISTRO)
+
+
+// EUSART (espelho de mcc_generated_files/eusart.c)
+
+/**
+ * @brief Tamanhos dos buffers, iguais aos de eusart.c.
+ */
+#define HOST_TX_BUFFER_SIZE 8
+#define HOST_RX_BUFFER_SIZE 32
+
+volatile uint8_t eusartTxBufferRemaining = HOST_TX_BUFFER_SIZE;
+volatile uint8_t eusartRxCount = 0;
+static uint8_t rx_buffer[HOST_RX_BUFFER_SIZE];
+static uint8_t rx_head = 0;
+static uint8_t rx_tail = 0;
+
+void (*EUSART_TxDefaultInterruptHandler)(void);
+void (*EUSART_RxDefaultInterruptHandler)(void);
+
+/**
+ * @brief Instantes em que cada byte aceito termina de sair pelo pino TX.
+ * @note Capacidade = buffer de software + registrador de deslocamento.
+ */
+static uint64_t tx_fim[HOST_TX_BUFFER_SIZE + 1];
+static uint8_t tx_ocupados = 0;
+static uint64_t tx_linha_livre = 0;
+
+/**
+ * @brief Linha RX: bytes enviados pelo host ainda "no fio".
+ */
+#define LINHA_RX_MAX 4096
+static uint8_t linha_rx[LINHA_RX_MAX];
+static size_t linha_ini = 0, linha_n = 0;
+static uint64_t linha_prox_us = 0;   // Chegada do próximo byte da linha
+
+
+// ESTADO DO SIMULADOR
+
+static uint64_t agora_us = 0;
+static uint64_t prox_tmr4_us = SIM_TMR4_US;
+static uint64_t prox_tmr2_us = SIM_TMR2_US;
+static uint64_t prox_planta_us = SIM_PLANTA_US;
+static uint64_t prox_quantum_us = 0;
+static uint32_t quantum_us = 0;
+static bool em_isr = false;
+static bool dormindo = false;          // Dentro de SLEEP: TMR2/TMR4 e receptor parados
+static uint64_t despertar_rx_us = 0;   // Último despertar pela RX
+static bool resposta_pendente = false; // Despertar pela RX ainda sem resposta completa na TX
+static bool em_resposta = false;       // Quadro "#..." da resposta em transmissão
+static uint16_t duty_pwm = 0;
+static SimEstatisticas estat;
+
+static uint8_t eeprom[256] = { [0 ... 255] = 0xFF };   // EEPROM apagada
+static FILE* eeprom_arquivo = NULL;
+static double perda_encoder = 0.0;                      // Fração dos pulsos perdida pelo encoder
+
+static void (*tmr4_handler)(void) = NULL;
+static void (*tmr2_handler)(void) = NULL;
+
+void (*Sim_GanchoTx)(uint8_t byte) = NULL;
+void (*Sim_GanchoRx)(uint8_t byte) = NULL;
+void (*Sim_GanchoPWM)(uint16_t duty) = NULL;
+void (*Sim_GanchoQuantum)(void) = NULL;
+void (*Sim_GanchoPlanta)(void) = NULL;
+
+
+// GRAVAÇÃO E REPRODUÇÃO
+
+/**
+ * @brief Registro de uma gravação carregada.
+ */
+typedef struct {
+    uint64_t t_us;
+    char tipo;
+    uint16_t valor;
+} Registro;
+
+/**
+ * @brief Lista de registros de um tipo de uso (entradas ou saídas esperadas).
+ */
+typedef struct {
+    Registro* r;
+    size_t n, cap, prox;
+} ListaRegistros;
+
+static FILE* gravacao = NULL;
+static int grava_sensores = -1;         // Últimos valores gravados (-1 = nenhum)
+static int grava_timer0 = -1;
+static int grava_adc = -1;
+static int grava_pwm = -1;
+
+static bool reproduzindo = false;
+static ListaRegistros entradas, saidas_tx, saidas_pwm;
+static uint8_t rep_sensores = 0;        // Valores correntes das entradas reproduzidas
+static uint8_t rep_timer0 = 0;
+static uint16_t rep_adc = 0;
+static int rep_pwm = -1;
+static SimReproducao reproducao;
+
+static void Grava(char tipo, uint64_t t, uint16_t valor) {
+    fprintf(gravacao, "&%c,%llu,%03X\n", tipo, (unsigned long long)t, valor);
+}
+
+/**
+ * @brief Grava uma entrada só quando o valor muda.
+ */
+static void Grava_Mudanca(char tipo, int* anterior, uint16_t valor) {
+    if (!gravacao || *anterior == (int)valor) return;
+    *anterior = valor;
+    Grava(tipo, agora_us, valor);
+}
+
+static void Lista_Adiciona(ListaRegistros* l, uint64_t t, char tipo, uint16_t valor) {
+    if (l->n == l->cap) {
+        l->cap = l->cap ? 2 * l->cap : 1024;
+        l->r = realloc(l->r, l->cap * sizeof(Registro));
+        if (!l->r) {
+            fprintf(stderr, "sim: memória insuficiente para a gravação\n");
+            exit(2);
+        }
+    }
+    l->r[l->n++] = (Registro){ t, tipo, valor };
+    if (t > reproducao.fim_us) reproducao.fim_us = t;
+}
+
+/**
+ * @brief Confere uma saída do firmware com a próxima saída gravada do mesmo tipo.
+ */
+static void Confere_Saida(ListaRegistros* l, char tipo, uint16_t valor) {
+    if (l->prox >= l->n) {
+        // Saída além do fim da gravação: não há o que conferir
+        return;
+    }
+    const Registro* e = &l->r[l->prox++];
+    if (e->t_us == agora_us && e->valor == valor) {
+        reproducao.conferidas++;
+        return;
+    }
+    if (reproducao.divergencias++ == 0) {
+        snprintf(reproducao.primeira, sizeof(reproducao.primeira),
+                 "'%c' gravado %03X em t=%llu us, reproduzido %03X em t=%llu us",
+                 tipo, e->valor, (unsigned long long)e->t_us, valor, (unsigned long long)agora_us);
+    }
+}
+
+/**
+ * @brief Instante da próxima entrada reproduzida (UINT64_MAX se acabaram).
+ */
+static uint64_t Proxima_Entrada_us(void) {
+    return (entradas.prox < entradas.n) ? entradas.r[entradas.prox].t_us : UINT64_MAX;
+}
+
+static void Atualiza_Pinos(void);
+static void Recebe_Byte(uint8_t byte);
+
+/**
+ * @brief Aplica as entradas gravadas até o instante atual, na ordem do arquivo.
+ */
+static void Aplica_Entradas(void) {
+    while (entradas.prox < entradas.n && entradas.r[entradas.prox].t_us <= agora_us) {
+        const Registro* e = &entradas.r[entradas.prox++];
+        switch (e->tipo) {
+            case 'R': Recebe_Byte((uint8_t)e->valor); break;
+            case 'S': rep_sensores = (uint8_t)e->valor; Atualiza_Pinos(); break;
+            case 'C': rep_timer0 = (uint8_t)e->valor; break;
+            case 'A': rep_adc = e->valor; break;
+            case 'X': reproducao.perdidos += e->valor; break;
+        }
+    }
+}
+
+
+/**
+ * @brief Copia o estado dos sensores da planta para os registradores.
+ * @note S1/S2 são Hall com pull-up (ativo em 0); S3/S4 passam pelos comparadores (ativo em 1).
+ */
+static void Atualiza_Pinos(void) {
+    uint8_t ativos = rep_sensores;
+    if (!reproduzindo) {
+        const PlantaEstado* e = Planta_Estado();
+        ativos = 0;
+        for (int i = 0; i < PLANTA_ANDARES; i++) {
+            if (e->sensor[i]) ativos |= (uint8_t)(1u << i);
+        }
+        Grava_Mudanca('S', &grava_sensores, ativos);
+    }
+    PORTBbits.RB0 = (ativos & 0x01) ? 0 : 1;
+    PORTBbits.RB3 = (ativos & 0x02) ? 0 : 1;
+    CM1CON0bits.C1OUT = (ativos & 0x04) ? 1 : 0;
+    CM2CON0bits.C2OUT = (ativos & 0x08) ? 1 : 0;
+}
+
+/**
+ * @brief Entrega ao anel RX o byte que acabou de chegar (EUSART_RxDataHandler).
+ */
+static void Recebe_Byte(uint8_t byte) {
+    if (eusartRxCount >= HOST_RX_BUFFER_SIZE) estat.rx_estouros++;
+    rx_buffer[rx_head++] = byte;
+    if (rx_head >= HOST_RX_BUFFER_SIZE) rx_head = 0;
+    eusartRxCount++;
+    estat.rx_bytes++;
+    if (gravacao) Grava('R', agora_us, byte);
+    if (Sim_GanchoRx) Sim_GanchoRx(byte);
+}
+
+/**
+ * @brief Avança o tempo virtual processando os eventos em ordem.
+ */
+static void Avanca_Ate(uint64_t alvo) {
+    while (agora_us < alvo) {
+        uint64_t prox = alvo;
+        if (prox_planta_us < prox) prox = prox_planta_us;
+        if (prox_tmr4_us < prox) prox = prox_tmr4_us;
+        if (prox_tmr2_us < prox) prox = prox_tmr2_us;
+        if (linha_n && linha_prox_us < prox) prox = linha_prox_us;
+        if (quantum_us && prox_quantum_us < prox) prox = prox_quantum_us;
+        if (reproduzindo && Proxima_Entrada_us() < prox) prox = Proxima_Entrada_us();
+        agora_us = prox;
+
+        // Reprodução: entradas gravadas no lugar da linha RX e da planta
+        if (reproduzindo) Aplica_Entradas();
+
+        // Byte completo na linha RX -> interrupção de recepção
+        // (no SLEEP sem WUE o receptor está parado e o byte se perde)
+        while (linha_n && linha_prox_us <= agora_us) {
+            if (dormindo) estat.rx_perdidos_sono++;
+            else Recebe_Byte(linha_rx[linha_ini]);
+            linha_ini = (linha_ini + 1) % LINHA_RX_MAX;
+            linha_n--;
+            linha_prox_us += SIM_BYTE_US;
+        }
+
+        // Passo da planta
+        if (agora_us >= prox_planta_us) {
+            prox_planta_us += SIM_PLANTA_US;
+            if (!reproduzindo) {
+                Planta_Passo(SIM_PLANTA_US * 1e-6, duty_pwm, LATAbits.LATA7 != 0);
+                Atualiza_Pinos();
+                if (Sim_GanchoPlanta) Sim_GanchoPlanta();
+            }
+        }
+
+        // Interrupção do TMR4 (tarefa de sensores); o timer para no SLEEP
+        if (agora_us >= prox_tmr4_us) {
+            prox_tmr4_us += SIM_TMR4_US;
+            if (tmr4_handler && !dormindo) {
+                em_isr = true;
+                tmr4_handler();
+                em_isr = false;
+            }
+        }
+
+        // Interrupção do TMR2 (relógio de ms); o timer para no SLEEP
+        if (agora_us >= prox_tmr2_us) {
+            prox_tmr2_us += SIM_TMR2_US;
+            if (tmr2_handler && !dormindo) {
+                em_isr = true;
+                tmr2_handler();
+                em_isr = false;
+            }
+        }
+
+        // Sincronismo externo
+        if (quantum_us && agora_us >= prox_quantum_us) {
+            prox_quantum_us += quantum_us;
+            if (Sim_GanchoQuantum) Sim_GanchoQuantum();
+        }
+    }
+}
+
+void HOST_Atraso_us(uint32_t us) {
+    // Dentro de uma "interrupção" o tempo não avança
+    if (em_isr) return;
+    Avanca_Ate(agora_us + us);
+}
+
+/**
+ * @brief Período do WDT configurado em WDTCON: 1 ms (1:32) vezes 2^WDTPS.
+ * @note Valor nominal do LFINTOSC (31 kHz); o real varia com a tensão e a temperatura.
+ */
+static uint64_t Periodo_WDT_us(void) {
+    return 1000ull << ((WDTCON >> 1) & 0x1F);
+}
+
+void HOST_LimpaWdt(void) {
+    STATUSbits.nTO = 1;
+    STATUSbits.nPD = 1;
+}
+
+void HOST_Dorme(void) {
+    if (em_isr) return;
+    uint64_t inicio = agora_us;
+
+    // O quadro do último despertar não teve resposta (ex.: pedido sem sequência)
+    resposta_pendente = false;
+    uint64_t wdt = WDTCONbits.SWDTEN ? agora_us + Periodo_WDT_us() : UINT64_MAX;
+
+    STATUSbits.nTO = 1;
+    STATUSbits.nPD = 0;
+    dormindo = true;
+    estat.sonos++;
+
+    for (;;) {
+        // Com WUE, a borda de descida do start bit do próximo byte acorda o PIC
+        // (um byte já a caminho acorda na primeira borda, ou seja, agora)
+        uint64_t borda = UINT64_MAX;
+        if (BAUDCONbits.WUE && linha_n) {
+            borda = linha_prox_us - SIM_BYTE_US;
+            if (borda < agora_us) borda = agora_us;
+        }
+        uint64_t alvo = (borda < wdt) ? borda : wdt;
+        // O quantum pode trazer bytes novos para a linha
+        if (quantum_us && prox_quantum_us < alvo) alvo = prox_quantum_us;
+        if (reproduzindo && Proxima_Entrada_us() < alvo) alvo = Proxima_Entrada_us();
+        if (alvo == UINT64_MAX) {
+            fprintf(stderr, "sim: SLEEP sem fonte de despertar\n");
+            exit(0);
+        }
+        Avanca_Ate(alvo);
+
+        if (agora_us >= wdt) {
+            STATUSbits.nTO = 0;
+            break;
+        }
+        if (borda <= agora_us) {
+            // O byte do despertar não é recebido: a interrupção lê 0x00 do RCREG
+            // e o WUE é limpo na subida do fim do byte
+            linha_ini = (linha_ini + 1) % LINHA_RX_MAX;
+            linha_n--;
+            linha_prox_us += SIM_BYTE_US;
+            BAUDCONbits.WUE = 0;
+            Recebe_Byte(0x00);
+            estat.despertares_rx++;
+            despertar_rx_us = agora_us;
+            resposta_pendente = true;
+            em_resposta = false;
+            break;
+        }
+        // Reprodução: os bytes gravados entram direto no buffer RX
+        if (eusartRxCount) break;
+    }
+
+    dormindo = false;
+    estat.dormindo_us += agora_us - inicio;
+}
+
+
+// API DO SIMULADOR
+
+void Sim_PerdaEncoder(double fracao) {
+    perda_encoder = fracao;
+}
+
+void Sim_Inicializa(double posicao_inicial_mm, uint32_t quantum) {
+    PlantaParametros p = PLANTA_PADRAO;
+    p.perda_pulsos = perda_encoder;
+    Planta_Inicializa(&p, posicao_inicial_mm);
+    if (reproduzindo) Aplica_Entradas();
+    Atualiza_Pinos();
+    quantum_us = quantum;
+    prox_quantum_us = quantum;
+}
+
+bool Sim_EEPROM(const char* caminho) {
+    eeprom_arquivo = fopen(caminho, "r+b");
+    if (eeprom_arquivo) {
+        size_t n = fread(eeprom, 1, sizeof(eeprom), eeprom_arquivo);
+        (void)n;
+    } else {
+        eeprom_arquivo = fopen(caminho, "w+b");
+        if (!eeprom_arquivo) return false;
+    }
+    // Completa arquivos curtos com 0xFF para as escritas por posição
+    fseek(eeprom_arquivo, 0, SEEK_SET);
+    fwrite(eeprom, 1, sizeof(eeprom), eeprom_arquivo);
+    fflush(eeprom_arquivo);
+    return true;
+}
+
+bool Sim_Grava(const char* caminho) {
+    gravacao = fopen(caminho, "w");
+    if (!gravacao) return false;
+    Grava('G', 0, 1);
+    for (int i = 0; i < 256; i++) {
+        if (eeprom[i] != 0xFF) Grava('E', (uint64_t)i, eeprom[i]);
+    }
+    return true;
+}
+
+bool Sim_Reproduz(const char* caminho) {
+    FILE* f = fopen(caminho, "r");
+    if (!f) return false;
+
+    char linha[128];
+    size_t n = 0;
+    int c;
+    uint64_t unidade = 1, volta = 0, anterior = 0;
+    memset(eeprom, 0xFF, sizeof(eeprom));
+
+    // Linhas terminadas por LF (simulador) ou CR (captura da serial do alvo)
+    while ((c = fgetc(f)) != EOF) {
+        if (c != '\r' && c != '\n') {
+            if (n < sizeof(linha) - 1) linha[n++] = (char)c;
+            continue;
+        }
+        linha[n] = '\0';
+        n = 0;
+
+        char tipo;
+        unsigned long long t;
+        unsigned valor;
+        // Linhas de telemetria de uma captura da serial são ignoradas
+        if (sscanf(linha, "&%c,%llu,%x", &tipo, &t, &valor) != 3) continue;
+
+        if (tipo == 'G') {
+            unidade = valor ? valor : 1;
+            continue;
+        }
+        if (tipo == 'E') {
+            if (t < sizeof(eeprom)) eeprom[t] = (uint8_t)valor;
+            continue;
+        }
+        // O relógio de ms do alvo volta a 0 a cada 65,5 s
+        if (unidade != 1 && t < anterior) volta += 65536;
+        anterior = t;
+        uint64_t t_us = (t + volta) * unidade;
+
+        if (tipo == 'T') Lista_Adiciona(&saidas_tx, t_us, tipo, (uint16_t)valor);
+        else if (tipo == 'M') Lista_Adiciona(&saidas_pwm, t_us, tipo, (uint16_t)valor);
+        else Lista_Adiciona(&entradas, t_us, tipo, (uint16_t)valor);
+    }
+    fclose(f);
+
+    reproducao.entradas = (uint32_t)entradas.n;
+    reproducao.esperadas = (uint32_t)(saidas_tx.n + saidas_pwm.n);
+    reproduzindo = true;
+    return entradas.n > 0;
+}
+
+const SimReproducao* Sim_Reproducao(void) {
+    return &reproducao;
+}
+
+uint64_t Sim_Agora_us(void) {
+    return agora_us;
+}
+
+void Sim_InjetaRx(const uint8_t* dados, size_t n) {
+    // Na reprodução a RX vem apenas da gravação
+    if (reproduzindo) return;
+    if (linha_n == 0 && linha_prox_us < agora_us + SIM_BYTE_US) {
+        linha_prox_us = agora_us + SIM_BYTE_US;
+    }
+    for (size_t i = 0; i < n && linha_n < LINHA_RX_MAX; i++) {
+        linha_rx[(linha_ini + linha_n) % LINHA_RX_MAX] = dados[i];
+        linha_n++;
+    }
+}
+
+size_t Sim_RxPendentes(void) {
+    return linha_n;
+}
+
+const SimEstatisticas* Sim_Estatisticas(void) {
+    return &estat;
+}
+
+uint16_t Sim_DutyPWM(void) {
+    return duty_pwm;
+}
+
+
+// SISTEMA
+
+void SYSTEM_Initialize(void) {
+    // Estado de reset relevante: sensores lidos da planta
+    Atualiza_Pinos();
+}
+
+
+// EUSART
+
+bool EUSART_is_tx_ready(void) {
+    return eusartTxBufferRemaining ? true : false;
+}
+
+bool EUSART_is_rx_ready(void) {
+    return eusartRxCount ? true : false;
+}
+
+bool EUSART_is_tx_done(void) {
+    return tx_linha_livre <= agora_us;
+}
+
+uint8_t EUSART_Read(void) {
+    uint64_t inicio = agora_us;
+    // Espera ativa do driver: o tempo corre até chegar um byte
+    while (0 == eusartRxCount) {
+        if (linha_n) Avanca_Ate(linha_prox_us);
+        else if (quantum_us) Avanca_Ate(prox_quantum_us);
+        else {
+            fprintf(stderr, "sim: EUSART_Read sem dados e sem fonte de entrada\n");
+            exit(0);
+        }
+    }
+    estat.rx_bloqueio_us += agora_us - inicio;
+
+    uint8_t valor = rx_buffer[rx_tail++];
+    if (rx_tail >= HOST_RX_BUFFER_SIZE) rx_tail = 0;
+    eusartRxCount--;
+    return valor;
+}
+
+/**
+ * @brief Descarta dos registros de TX os bytes que já saíram pelo pino.
+ */
+static void Tx_Libera(void) {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < tx_ocupados; i++) {
+        if (tx_fim[i] > agora_us) tx_fim[n++] = tx_fim[i];
+    }
+    tx_ocupados = n;
+    uint8_t livres = (uint8_t)(HOST_TX_BUFFER_SIZE + 1 - tx_ocupados);
+    eusartTxBufferRemaining = (livres > HOST_TX_BUFFER_SIZE) ? HOST_TX_BUFFER_SIZE : livres;
+}
+
+void EUSART_Write(uint8_t txData) {
+    uint64_t inicio = agora_us;
+    Tx_Libera();
+    // Buffer cheio: o driver espera o próximo byte sair
+    while (tx_ocupados >= HOST_TX_BUFFER_SIZE + 1) {
+        Avanca_Ate(tx_fim[0]);
+        Tx_Libera();
+    }
+    estat.tx_bloqueio_us += agora_us - inicio;
+
+    uint64_t ini = (tx_linha_livre > agora_us) ? tx_linha_livre : agora_us;
+    tx_linha_livre = ini + SIM_BYTE_US;
+    // Despertar pela RX: mede até o fim do primeiro quadro "#..." (ACK, NAK ou
+    // resposta de consulta); a telemetria transmitida antes não conta
+    if (resposta_pendente) {
+        if (txData == '#') em_resposta = true;
+        else if (txData == '\r' && em_resposta) {
+            uint64_t resposta = tx_linha_livre - despertar_rx_us;
+            resposta_pendente = false;
+            em_resposta = false;
+            estat.resposta_n++;
+            estat.resposta_soma_us += resposta;
+            if (resposta > estat.resposta_max_us) estat.resposta_max_us = (uint32_t)resposta;
+        }
+    }
+    tx_fim[tx_ocupados++] = tx_linha_livre;
+    Tx_Libera();
+    estat.tx_bytes++;
+    if (gravacao) Grava('T', agora_us, txData);
+    if (reproduzindo) Confere_Saida(&saidas_tx, 'T', txData);
+
+    if (Sim_GanchoTx) Sim_GanchoTx(txData);
+}
+
+
+// TIMERS, PWM E ADC
+
+uint8_t TMR0_ReadTimer(void) {
+    if (reproduzindo) return rep_timer0;
+    uint8_t valor = Planta_Estado()->tmr0;
+    Grava_Mudanca('C', &grava_timer0, valor);
+    return valor;
+}
+
+void TMR4_SetInterruptHandler(void (*InterruptHandler)(void)) {
+    tmr4_handler = InterruptHandler;
+}
+
+void TMR2_SetInterruptHandler(void (*InterruptHandler)(void)) {
+    tmr2_handler = InterruptHandler;
+}
+
+void PWM3_LoadDutyValue(uint16_t dutyValue) {
+    duty_pwm = dutyValue & 0x03FF;
+
+    // Saída conferida na reprodução: duty com o DIR no bit 10
+    uint16_t saida = (uint16_t)(duty_pwm | (LATAbits.LATA7 ? 0x400 : 0));
+    Grava_Mudanca('M', &grava_pwm, saida);
+    if (reproduzindo && rep_pwm != (int)saida) {
+        rep_pwm = saida;
+        Confere_Saida(&saidas_pwm, 'M', saida);
+    }
+    if (Sim_GanchoPWM) Sim_GanchoPWM(duty_pwm);
+}
+
+adc_result_t ADC_GetConversion(adc_channel_t channel) {
+    (void)channel;
+    if (reproduzindo) return rep_adc;
+    uint16_t valor = Planta_ADC();
+    Grava_Mudanca('A', &grava_adc, valor);
+    return valor;
+}
+
+
+// EEPROM DE DADOS
+
+uint8_t DATAEE_ReadByte(uint8_t bAdd) {
+    return eeprom[bAdd];
+}
+
+void DATAEE_WriteByte(uint8_t bAdd, uint8_t bData) {
+    eeprom[bAdd] = bData;
+    if (eeprom_arquivo) {
+        fseek(eeprom_arquivo, bAdd, SEEK_SET);
+        fputc(bData, eeprom_arquivo);
+        fflush(eeprom_arquivo);
+    }
+    // O driver espera o fim da escrita com as interrupções habilitadas
+    HOST_Atraso_us(SIM_EEPROM_US);
+}
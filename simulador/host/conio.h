@@ -0,0 +1,4 @@
+/**
+ * @file conio.h
+ * @brief Substituto vazio do <conio.h> do XC8 (incluído por mcc.h).
+ */
@@ -0,0 +1,112 @@
+/**
+ * @file xc.h
+ * @brief Substituto do <xc.h> do XC8 para a compilação do firmware no PC.
+ * @details Emula apenas os registradores do PIC16F1827 acessados diretamente
+ * pelo firmware (main.c, motor.c, comm.c, globals.c e sono.c). Cada
+ * registrador é uma variável global com o mesmo layout de bits do datasheet,
+ * de forma que o código da aplicação compila sem alterações. Os drivers do
+ * MCC não são compilados: suas funções são reimplementadas em hal_host.c.
+ */
+
+#ifndef XC_HOST_H
+#define XC_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Lista de registradores de 8 bits: nome e os bits 0 a 7.
+ * @note Bits reservados recebem nomes únicos para não conflitar.
+ */
+#define XC_REGISTROS(X) \
+    X(PORTA,    RA0, RA1, RA2, RA3, RA4, RA5, RA6, RA7) \
+    X(PORTB,    RB0, RB1, RB2, RB3, RB4, RB5, RB6, RB7) \
+    X(LATA,     LATA0, LATA1, LATA2, LATA3, LATA4, LATA5, LATA6, LATA7) \
+    X(LATB,     LATB0, LATB1, LATB2, LATB3, LATB4, LATB5, LATB6, LATB7) \
+    X(TRISA,    TRISA0, TRISA1, TRISA2, TRISA3, TRISA4, TRISA5, TRISA6, TRISA7) \
+    X(TRISB,    TRISB0, TRISB1, TRISB2, TRISB3, TRISB4, TRISB5, TRISB6, TRISB7) \
+    X(ANSELA,   ANSA0, ANSA1, ANSA2, ANSA3, ANSA4, ANSA_r5, ANSA_r6, ANSA_r7) \
+    X(ANSELB,   ANSB_r0, ANSB1, ANSB2, ANSB3, ANSB4, ANSB5, ANSB6, ANSB7) \
+    X(INTCON,   IOCIF, INTF, TMR0IF, IOCIE, INTE, TMR0IE, PEIE, GIE) \
+    X(PIE1,     TMR1IE, TMR2IE, CCP1IE, SSP1IE, TXIE, RCIE, ADIE, TMR1GIE) \
+    X(PIR1,     TMR1IF, TMR2IF, CCP1IF, SSP1IF, TXIF, RCIF, ADIF, TMR1GIF) \
+    X(PIE2,     CCP2IE, PIE2_r1, PIE2_r2, BCL1IE, EEIE, C1IE, C2IE, OSFIE) \
+    X(PIR2,     CCP2IF, PIR2_r1, PIR2_r2, BCL1IF, EEIF, C1IF, C2IF, OSFIF) \
+    X(PIE3,     PIE3_r0, TMR4IE, PIE3_r2, TMR6IE, CCP3IE, CCP4IE, PIE3_r6, PIE3_r7) \
+    X(PIR3,     PIR3_r0, TMR4IF, PIR3_r2, TMR6IF, CCP3IF, CCP4IF, PIR3_r6, PIR3_r7) \
+    X(CM1CON0,  C1SYNC, C1HYS, C1SP, CM1_r3, C1POL, C1OE, C1OUT, C1ON) \
+    X(CM2CON0,  C2SYNC, C2HYS, C2SP, CM2_r3, C2POL, C2OE, C2OUT, C2ON) \
+    X(SSP1CON1, SSPM0, SSPM1, SSPM2, SSPM3, CKP, SSPEN, SSPOV, WCOL) \
+    X(SSP1BUF,  SSPB0, SSPB1, SSPB2, SSPB3, SSPB4, SSPB5, SSPB6, SSPB7) \
+    X(BAUDCON,  ABDEN, WUE, BAUD_r2, BRG16, SCKP, BAUD_r5, RCIDL, ABDOVF) \
+    X(RCSTA,    RX9D, OERR, FERR, ADDEN, CREN, SREN, RX9, SPEN) \
+    X(PCON,     nBOR, nPOR, nRI, nRMCLR, PCON_r4, PCON_r5, STKUNF, STKOVF) \
+    X(STATUS,   C, DC, Z, nPD, nTO, STATUS_r5, STATUS_r6, STATUS_r7) \
+    X(WDTCON,   SWDTEN, WDTPS0, WDTPS1, WDTPS2, WDTPS3, WDTPS4, WDT_r6, WDT_r7)
+
+/**
+ * @brief Declara a união de bits e a variável de cada registrador.
+ */
+#define XC_DECLARA_REGISTRO(nome, b0, b1, b2, b3, b4, b5, b6, b7) \
+    typedef union { \
+        struct { unsigned b0:1, b1:1, b2:1, b3:1, b4:1, b5:1, b6:1, b7:1; }; \
+        uint8_t valor; \
+    } nome##bits_t; \
+    extern volatile nome##bits_t nome##bits;
+
+XC_REGISTROS(XC_DECLARA_REGISTRO)
+
+// Acesso ao registrador inteiro pelo nome, como no XC8
+#define PORTA    PORTAbits.valor
+#define PORTB    PORTBbits.valor
+#define LATA     LATAbits.valor
+#define LATB     LATBbits.valor
+#define TRISA    TRISAbits.valor
+#define TRISB    TRISBbits.valor
+#define ANSELA   ANSELAbits.valor
+#define ANSELB   ANSELBbits.valor
+#define INTCON   INTCONbits.valor
+#define PIE1     PIE1bits.valor
+#define PIR1     PIR1bits.valor
+#define PIE2     PIE2bits.valor
+#define PIR2     PIR2bits.valor
+#define PIE3     PIE3bits.valor
+#define PIR3     PIR3bits.valor
+#define CM1CON0  CM1CON0bits.valor
+#define CM2CON0  CM2CON0bits.valor
+#define SSP1CON1 SSP1CON1bits.valor
+#define SSP1BUF  SSP1BUFbits.valor
+#define BAUDCON  BAUDCONbits.valor
+#define RCSTA    RCSTAbits.valor
+#define PCON     PCONbits.valor
+#define STATUS   STATUSbits.valor
+#define WDTCON   WDTCONbits.valor
+
+
+// TEMPORIZAÇÃO E INTRÍNSECOS
+
+/**
+ * @brief Avança o tempo virtual do simulador (ver hal_host.c).
+ */
+void HOST_Atraso_us(uint32_t us);
+
+/**
+ * @brief SLEEP: avança o tempo virtual até o WDT ou a RX (BAUDCON.WUE) acordarem o PIC.
+ */
+void HOST_Dorme(void);
+
+/**
+ * @brief CLRWDT: leva STATUS.nTO e STATUS.nPD a 1.
+ */
+void HOST_LimpaWdt(void);
+
+#define __delay_ms(x)   HOST_Atraso_us((uint32_t)(x) * 1000UL)
+#define __delay_us(x)   HOST_Atraso_us((uint32_t)(x))
+#define __interrupt(...)
+#define __bit           bool
+#define NOP()           ((void)0)
+#define CLRWDT()        HOST_LimpaWdt()
+#define SLEEP()         HOST_Dorme()
+
+#endif /* XC_HOST_H */
@@ -0,0 +1,345 @@
+/**
+ * @file latencia.c
+ * @brief Executável "elevlat": distribuição da latência do pedido até o movimento.
+ * @details Mede, no firmware real sobre a planta, o tempo entre o fim do stop
+ * do CR de "$OD\r" na linha RX e a primeira borda do PWM com o DIR do sentido
+ * pedido (início do período do TMR2 seguinte à carga do duty). Cada amostra
+ * roda em um processo filho a partir do reset, com a cabine parada no térreo:
+ * - o pedido chega em um instante aleatório entre 0,3 e 1,3 s, em qualquer
+ *   fase do loop (__delay_ms(10), envio da telemetria, leitura da UART);
+ * - a origem é sorteada entre os andares 1 a 3, então o motor sempre sobe.
+ *
+ * Os cenários combinam duas cargas de fundo:
+ * - telemetria: só o quadro completo (padrão) ou também os canais P, V, T e F
+ *   assinados com período de 1 ciclo, saturando a banda da TX;
+ * - consultas "$?S", "$?F" e "$?E" chegando como um processo de Poisson, que
+ *   ocupam a RX e geram respostas na TX.
+ *
+ * Para cada cenário o relatório mostra mínimo, mediana, p99 e máximo, e quanto
+ * da latência média o firmware passou bloqueado em EUSART_Write e EUSART_Read.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "sim.h"
+#include "planta.h"
+#include "globals.h"
+
+
+// CONFIGURAÇÃO
+
+/**
+ * @brief Parâmetros das amostras.
+ * - QUANTUM_US:    Granularidade da injeção de pedidos e consultas.
+ * - PEDIDO_MIN_US: Primeiro instante possível do pedido (após a inicialização).
+ * - PEDIDO_FAIXA:  Faixa sorteada a partir de PEDIDO_MIN_US.
+ * - PRAZO_US:      Sem partida neste prazo após o CR, a amostra falha.
+ */
+#define QUANTUM_US       100
+#define PEDIDO_MIN_US    300000
+#define PEDIDO_FAIXA_US  1000000
+#define PRAZO_US         1000000
+#define ASSINATURA_US    50000
+
+/**
+ * @brief Cargas de fundo de um cenário.
+ */
+typedef struct {
+    bool canais;            // Canais P, V, T e F assinados com período de 1 ciclo
+    double consultas_s;     // Consultas por segundo (0 = nenhuma)
+} Cenario;
+
+static const Cenario cenarios[] = {
+    { false, 0 }, { false, 10 }, { false, 40 },
+    { true,  0 }, { true,  10 }, { true,  40 },
+};
+#define NUM_CENARIOS  (sizeof(cenarios) / sizeof(cenarios[0]))
+
+static struct {
+    uint64_t semente;       // Semente da primeira amostra
+    uint32_t amostras;      // Amostras por cenário
+    int jobs;               // Processos filhos em paralelo
+    int verboso;            // Cada amostra na saída de erro
+} cfg = { 1, 500, 1, 0 };
+
+
+// GERADOR ALEATÓRIO (xorshift64*, o mesmo do elevconf)
+
+static uint64_t rng_estado;
+
+static uint32_t Aleatorio(void) {
+    rng_estado ^= rng_estado >> 12;
+    rng_estado ^= rng_estado << 25;
+    rng_estado ^= rng_estado >> 27;
+    return (uint32_t)((rng_estado * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static double Uniforme(double a, double b) {
+    return a + (b - a) * (Aleatorio() / 4294967296.0);
+}
+
+
+// AMOSTRA (processo filho)
+
+/**
+ * @brief Resultado enviado ao processo pai.
+ * @note latencia_us = 0 indica amostra sem partida no prazo.
+ */
+typedef struct {
+    uint64_t semente;
+    uint32_t latencia_us;
+    uint32_t bloqueio_tx_us;
+    uint32_t bloqueio_rx_us;
+} Resultado;
+
+static Resultado res;
+static int fd_resultado;
+static const Cenario* cenario;
+
+static uint64_t t_pedido;           // Instante da injeção de "$OD\r"
+static uint64_t t_consulta;         // Próxima consulta de fundo
+static uint64_t t_cr = 0;           // Fim do stop do CR do pedido
+static uint32_t injetados = 0;      // Bytes colocados na linha RX
+static uint32_t entregues = 0;      // Bytes entregues ao PIC
+static uint32_t alvo = 0;           // Posição do CR do pedido na linha (0 = não injetado)
+static bool assinado = false;
+static SimEstatisticas estat_cr;
+
+static void Termina(void) {
+    ssize_t n = write(fd_resultado, &res, sizeof(res));
+    (void)n;
+    _exit(0);
+}
+
+static void Injeta(const char* quadro) {
+    size_t n = strlen(quadro);
+    Sim_InjetaRx((const uint8_t*)quadro, n);
+    injetados += (uint32_t)n;
+}
+
+static void Rx(uint8_t byte) {
+    (void)byte;
+    if (++entregues == alvo) {
+        t_cr = Sim_Agora_us();
+        estat_cr = *Sim_Estatisticas();
+    }
+}
+
+static void Pwm(uint16_t duty) {
+    if (!t_cr || !duty || LATAbits.LATA7 != DIRECAO_SUBIR) return;
+
+    // O duty novo entra no pino no início do próximo período do TMR2
+    uint64_t borda = (Sim_Agora_us() / SIM_TMR2_US + 1) * SIM_TMR2_US;
+    const SimEstatisticas* e = Sim_Estatisticas();
+    res.latencia_us = (uint32_t)(borda - t_cr);
+    res.bloqueio_tx_us = (uint32_t)(e->tx_bloqueio_us - estat_cr.tx_bloqueio_us);
+    res.bloqueio_rx_us = (uint32_t)(e->rx_bloqueio_us - estat_cr.rx_bloqueio_us);
+    Termina();
+}
+
+/**
+ * @brief Gancho de quantum: cargas de fundo, pedido medido e prazo.
+ */
+static void Quantum(void) {
+    static const char* const consultas[] = { "$?S\r", "$?F\r", "$?E\r" };
+    uint64_t agora = Sim_Agora_us();
+
+    // 1. Telemetria de fundo
+    if (cenario->canais && !assinado && agora >= ASSINATURA_US) {
+        Injeta("$SP001\r$SV001\r$ST001\r$SF001\r");
+        assinado = true;
+    }
+
+    // 2. Consultas de fundo (intervalos exponenciais)
+    if (cenario->consultas_s > 0 && agora >= t_consulta) {
+        Injeta(consultas[Aleatorio() % 3]);
+        t_consulta = agora + (uint64_t)(-log(1.0 - Uniforme(0, 1)) / cenario->consultas_s * 1e6);
+    }
+
+    // 3. Pedido medido, atrás do que já estiver na linha
+    if (!alvo && agora >= t_pedido) {
+        char quadro[8];
+        uint8_t origem = (uint8_t)(1 + Aleatorio() % 3);
+        uint8_t destino = (uint8_t)((origem + 1 + Aleatorio() % 3) % 4);
+        snprintf(quadro, sizeof(quadro), "$%u%u\r", origem, destino);
+        Injeta(quadro);
+        alvo = injetados;
+        if (cfg.verboso) fprintf(stderr, "semente %llu: pedido %s em %.6f s\n",
+                                 (unsigned long long)res.semente, quadro + 1, agora * 1e-6);
+    }
+
+    if (t_cr && agora - t_cr > PRAZO_US) Termina();
+}
+
+static void Executa_Amostra(uint64_t semente) {
+    rng_estado = semente * 0x9E3779B97F4A7C15ULL + 1;
+    memset(&res, 0, sizeof(res));
+    res.semente = semente;
+
+    t_pedido = PEDIDO_MIN_US + (uint64_t)Uniforme(0, PEDIDO_FAIXA_US);
+    t_consulta = cenario->consultas_s > 0
+               ? (uint64_t)(-log(1.0 - Uniforme(0, 1)) / cenario->consultas_s * 1e6) : UINT64_MAX;
+
+    Sim_GanchoRx = Rx;
+    Sim_GanchoPWM = Pwm;
+    Sim_GanchoQuantum = Quantum;
+    Sim_Inicializa(PLANTA_PADRAO.altura_andar_mm[0], QUANTUM_US);
+    firmware_main();
+    Termina();
+}
+
+
+// EXECUÇÃO DOS CENÁRIOS (processo pai)
+
+typedef struct {
+    pid_t pid;
+    int fd;
+    uint64_t semente;
+} Filho;
+
+static double Relogio_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static void Uso(const char* prog) {
+    fprintf(stderr,
+        "uso: %s [opções]\n"
+        "  --amostras N       amostras por cenário (padrão 500)\n"
+        "  --semente S        semente da primeira amostra (padrão 1)\n"
+        "  --jobs N           amostras em paralelo (padrão 1)\n"
+        "  -v                 cada amostra na saída de erro\n", prog);
+}
+
+static pid_t Lanca(uint64_t semente, int* fd) {
+    int p[2];
+    if (pipe(p) < 0) {
+        perror("pipe");
+        exit(2);
+    }
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        exit(2);
+    }
+    if (pid == 0) {
+        close(p[0]);
+        fd_resultado = p[1];
+        Executa_Amostra(semente);
+    }
+    close(p[1]);
+    *fd = p[0];
+    return pid;
+}
+
+static int Compara(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Roda as amostras de um cenário.
+ * @return Amostras sem partida no prazo.
+ */
+static uint32_t Executa_Cenario(const Cenario* c, uint64_t semente) {
+    Filho* filhos = calloc((size_t)cfg.jobs, sizeof(Filho));
+    uint32_t* latencias = malloc(cfg.amostras * sizeof(uint32_t));
+    uint32_t lancadas = 0, concluidas = 0, medidas = 0, falhas = 0;
+    double bloqueio_tx = 0, bloqueio_rx = 0, soma = 0;
+
+    cenario = c;
+    while (concluidas < cfg.amostras) {
+
+        // 1. Mantém --jobs filhos rodando
+        for (int j = 0; j < cfg.jobs && lancadas < cfg.amostras; j++) {
+            if (filhos[j].pid) continue;
+            filhos[j].semente = semente + lancadas++;
+            filhos[j].pid = Lanca(filhos[j].semente, &filhos[j].fd);
+        }
+
+        // 2. Recolhe o próximo filho que terminar
+        int st;
+        pid_t pid = wait(&st);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            perror("wait");
+            exit(2);
+        }
+        int j = 0;
+        while (j < cfg.jobs && filhos[j].pid != pid) j++;
+        if (j == cfg.jobs) continue;
+
+        Resultado r;
+        ssize_t n = read(filhos[j].fd, &r, sizeof(r));
+        close(filhos[j].fd);
+        filhos[j].pid = 0;
+        concluidas++;
+
+        // 3. Acumula
+        if (n != (ssize_t)sizeof(r) || r.latencia_us == 0) {
+            if (cfg.verboso) fprintf(stderr, "semente %llu: sem partida\n", (unsigned long long)filhos[j].semente);
+            falhas++;
+            continue;
+        }
+        if (cfg.verboso) fprintf(stderr, "semente %llu: %u µs (TX %u µs, RX %u µs)\n",
+                                 (unsigned long long)r.semente, r.latencia_us, r.bloqueio_tx_us, r.bloqueio_rx_us);
+        latencias[medidas++] = r.latencia_us;
+        soma += r.latencia_us;
+        bloqueio_tx += r.bloqueio_tx_us;
+        bloqueio_rx += r.bloqueio_rx_us;
+    }
+
+    printf("%-10s %11.0f %8u", c->canais ? "G+PVTF" : "G", c->consultas_s, medidas);
+    if (medidas) {
+        qsort(latencias, medidas, sizeof(uint32_t), Compara);
+        printf(" %7.2f %7.2f %7.2f %7.2f %7.2f %9.2f %9.2f",
+               latencias[0] * 1e-3, latencias[medidas / 2] * 1e-3,
+               latencias[(medidas * 99) / 100] * 1e-3, latencias[medidas - 1] * 1e-3,
+               soma / medidas * 1e-3, bloqueio_tx / medidas * 1e-3, bloqueio_rx / medidas * 1e-3);
+    }
+    if (falhas) printf("   %u sem partida", falhas);
+    printf("\n");
+    fflush(stdout);
+
+    free(latencias);
+    free(filhos);
+    return falhas;
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!strcmp(a, "--amostras") && v) { cfg.amostras = (uint32_t)strtoul(v, NULL, 10); i++; }
+        else if (!strcmp(a, "--semente") && v) { cfg.semente = strtoull(v, NULL, 10); i++; }
+        else if (!strcmp(a, "--jobs") && v) { cfg.jobs = atoi(v); i++; }
+        else if (!strcmp(a, "-v")) cfg.verboso = 1;
+        else { Uso(argv[0]); return 2; }
+    }
+    if (cfg.amostras == 0 || cfg.jobs < 1) {
+        Uso(argv[0]);
+        return 2;
+    }
+
+    double inicio = Relogio_s();
+    uint32_t falhas = 0;
+
+    printf("latência do CR de \"$OD\" na RX à primeira borda do PWM subindo (ms)\n");
+    printf("telemetria consultas/s amostras     mín     p50     p99     máx   média  bloq. TX  bloq. RX\n");
+    for (size_t k = 0; k < NUM_CENARIOS; k++) {
+        // Mesmas sementes em todos os cenários: a diferença vem só da carga
+        falhas += Executa_Cenario(&cenarios[k], cfg.semente);
+    }
+    printf("%zu cenários x %u amostras em %.1f s reais\n", NUM_CENARIOS, cfg.amostras, Relogio_s() - inicio);
+
+    return falhas ? 1 : 0;
+}
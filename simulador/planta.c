@@ -0,0 +1,91 @@
+/**
+ * @file planta.c
+ * @brief Modelo físico do elevador (cabine, motor, encoder, sensores e LM35).
+ */
+
+#include "planta.h"
+
+#include <math.h>
+#include <string.h>
+
+/**
+ * @brief Parâmetros padrão.
+ * @note Andares a cada 60 mm (POSICAO_MAX_MM = 180), 0.837 mm por pulso
+ * (MICRONS_POR_PULSO) e ~21 mm/s com o duty de 60% (MOTOR_ON).
+ */
+const PlantaParametros PLANTA_PADRAO = {
+    .altura_andar_mm        = {0.0, 60.0, 120.0, 180.0},
+    .janela_sensor_mm       = 4.0,
+    .curso_min_mm           = -3.0,
+    .curso_max_mm           = 183.0,
+    .velocidade_max_mms     = 35.0,
+    .constante_tempo_s      = 0.15,
+    .mm_por_pulso           = 0.837,
+    .perda_pulsos           = 0.0,
+    .temperatura_ambiente_c = 25.0,
+    .aquecimento_max_c      = 20.0,
+    .constante_termica_s    = 60.0,
+};
+
+static PlantaParametros par;
+static PlantaEstado est;
+
+
+/**
+ * @brief Atualiza os sensores Hall conforme a posição atual.
+ */
+static void Atualiza_Sensores(void) {
+    for (int i = 0; i < PLANTA_ANDARES; i++) {
+        est.sensor[i] = fabs(est.posicao_mm - par.altura_andar_mm[i]) <= par.janela_sensor_mm;
+    }
+}
+
+void Planta_Inicializa(const PlantaParametros* p, double posicao_mm) {
+    par = *p;
+    memset(&est, 0, sizeof(est));
+    est.posicao_mm = posicao_mm;
+    est.temperatura_c = par.temperatura_ambiente_c;
+    Atualiza_Sensores();
+}
+
+void Planta_Passo(double dt_s, uint16_t duty, bool subir) {
+
+    // 1. Motor: resposta de primeira ordem até a velocidade alvo do duty
+    double alvo = par.velocidade_max_mms * (double)duty / 1024.0;
+    if (!subir) alvo = -alvo;
+    est.velocidade_mms += (alvo - est.velocidade_mms) * (dt_s / (par.constante_tempo_s + dt_s));
+    if (duty == 0 && fabs(est.velocidade_mms) < 0.05) est.velocidade_mms = 0.0;
+
+    // 2. Cabine: integra a posição e respeita os batentes mecânicos
+    double desloc = est.velocidade_mms * dt_s;
+    double nova = est.posicao_mm + desloc;
+    if (nova < par.curso_min_mm) { nova = par.curso_min_mm; est.velocidade_mms = 0.0; }
+    if (nova > par.curso_max_mm) { nova = par.curso_max_mm; est.velocidade_mms = 0.0; }
+    desloc = nova - est.posicao_mm;
+    est.posicao_mm = nova;
+
+    // 3. Encoder: o TMR0 conta pulsos nos dois sentidos, menos os perdidos por escorregamento
+    est.resto_pulsos += fabs(desloc) * (1.0 - par.perda_pulsos) / par.mm_por_pulso;
+    while (est.resto_pulsos >= 1.0) {
+        est.tmr0++;
+        est.resto_pulsos -= 1.0;
+    }
+
+    // 4. Ponte H: aquecimento proporcional ao duty
+    double t_alvo = par.temperatura_ambiente_c + par.aquecimento_max_c * (double)duty / 1024.0;
+    est.temperatura_c += (t_alvo - est.temperatura_c) * (dt_s / par.constante_termica_s);
+
+    Atualiza_Sensores();
+}
+
+uint16_t Planta_ADC(void) {
+    return (uint16_t)(est.temperatura_c * 10.0 + 0.5);
+}
+
+const PlantaEstado* Planta_Estado(void) {
+    return &est;
+}
+
+const PlantaParametros* Planta_Parametros(void) {
+    return &par;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file planta.h
+ * @brief Modelo físico do elevador usado pelo simulador no PC.
+ * @details Representa a cabine (posição e velocidade), o motor CC acionado
+ * por PWM e DIR, o encoder óptico contado pelo TMR0, os sensores Hall S1 a S4
+ * e o LM35 na ponte H lido pelo ADC.
+ */
+
+#ifndef PLANTA_H
+#define PLANTA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Número de andares atendidos pela maquete.
+ */
+#define PLANTA_ANDARES      4
+
+/**
+ * @brief Parâmetros físicos do modelo.
+ */
+typedef struct {
+    double altura_andar_mm[PLANTA_ANDARES]; // Altura do ímã de cada andar
+    double janela_sensor_mm;                // Meia largura da região de detecção do ímã
+    double curso_min_mm;                    // Batente mecânico inferior
+    double curso_max_mm;                    // Batente mecânico superior
+    double velocidade_max_mms;              // Velocidade com duty de 100%
+    double constante_tempo_s;               // Constante de tempo mecânica do motor
+    double mm_por_pulso;                    // Passo do encoder
+    double perda_pulsos;                    // Fração dos pulsos não contada (escorregamento)
+    double temperatura_ambiente_c;          // Temperatura da ponte H em repouso
+    double aquecimento_max_c;               // Elevação com duty de 100%
+    double constante_termica_s;             // Constante de tempo térmica
+} PlantaParametros;
+
+/**
+ * @brief Estado instantâneo do modelo.
+ */
+typedef struct {
+    double posicao_mm;
+    double velocidade_mms;      // Positiva subindo
+    double resto_pulsos;        // Fração de pulso ainda não contada
+    uint8_t tmr0;               // Contador de pulsos do encoder (TMR0)
+    double temperatura_c;
+    bool sensor[PLANTA_ANDARES];// true = ímã detectado
+} PlantaEstado;
+
+/**
+ * @brief Parâmetros padrão, ajustados às constantes do firmware.
+ */
+extern const PlantaParametros PLANTA_PADRAO;
+
+/**
+ * @brief Inicializa o modelo com a cabine parada na posição indicada.
+ * @param p Parâmetros físicos (copiados).
+ * @param posicao_mm Posição inicial da cabine.
+ */
+void Planta_Inicializa(const PlantaParametros* p, double posicao_mm);
+
+/**
+ * @brief Integra o modelo por um intervalo de tempo.
+ * @param dt_s Passo de integração em segundos.
+ * @param duty Duty cycle de 10 bits carregado no PWM3 (0 a 1023).
+ * @param subir Nível do pino DIR (true = subir).
+ */
+void Planta_Passo(double dt_s, uint16_t duty, bool subir);
+
+/**
+ * @brief Leitura crua do ADC (canal AN2) correspondente ao LM35.
+ * @note Escala usada pelo firmware: décimos de grau Celsius.
+ */
+uint16_t Planta_ADC(void);
+
+/**
+ * @brief Acesso somente leitura ao estado do modelo.
+ */
+const PlantaEstado* Planta_Estado(void);
+
+/**
+ * @brief Acesso aos parâmetros em uso.
+ */
+const PlantaParametros* Planta_Parametros(void);
+
+#endif /* PLANTA_H */
@@ -0,0 +1,184 @@
+/**
+ * @file sim.h
+ * @brief Núcleo do simulador: tempo virtual, periféricos emulados e ganchos.
+ * @details O firmware roda sem alterações sobre hal_host.c. Toda vez que ele
+ * chama __delay_ms() ou bloqueia na UART, o tempo virtual avança e os eventos
+ * de hardware (bytes na RX, interrupções do TMR2 e TMR4, passo da planta) são
+ * processados em ordem cronológica.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Tempo de um byte na UART a 19200 bps, 8N1 (10 bits).
+ */
+#define SIM_BYTE_US         521
+
+/**
+ * @brief Período do TMR4: (PR4+1) * pré 64 * pós 13 / (Fosc/4 = 2 MHz).
+ */
+#define SIM_TMR4_US         99840
+
+/**
+ * @brief Período da interrupção do TMR2: (PR2+1) * pré 1 * pós 4 / 2 MHz.
+ */
+#define SIM_TMR2_US         512
+
+/**
+ * @brief Passo de integração da planta.
+ */
+#define SIM_PLANTA_US       1000
+
+/**
+ * @brief Tempo de escrita de um byte na EEPROM de dados (típico do datasheet).
+ */
+#define SIM_EEPROM_US       4000
+
+/**
+ * @brief Ponto de entrada do firmware (main.c compilado com -Dmain=firmware_main).
+ */
+void firmware_main(void);
+
+/**
+ * @brief Configura o simulador e a planta antes de chamar firmware_main().
+ * @param posicao_inicial_mm Posição inicial da cabine.
+ * @param quantum_us Período do gancho de quantum (0 = desativado).
+ */
+void Sim_Inicializa(double posicao_inicial_mm, uint32_t quantum_us);
+
+/**
+ * @brief Faz o encoder perder uma fração dos pulsos (deriva da posição estimada).
+ * @param fracao 0 a 1; chamar antes de Sim_Inicializa().
+ */
+void Sim_PerdaEncoder(double fracao);
+
+/**
+ * @brief Usa um arquivo de 256 bytes como EEPROM de dados, preservada entre execuções.
+ * @details O arquivo é lido agora e cada escrita do firmware é gravada nele na hora,
+ * como uma EEPROM real diante de uma queda de energia. Arquivo inexistente ou
+ * curto equivale a EEPROM apagada (0xFF). Sem esta chamada a EEPROM começa
+ * apagada e não é salva.
+ * @return false se o arquivo não puder ser aberto para escrita.
+ */
+bool Sim_EEPROM(const char* caminho);
+
+/**
+ * @brief Grava em um arquivo as entradas do firmware, para reprodução exata.
+ * @details Uma linha "&K,T,VVV" por entrada, com T em µs de tempo virtual e
+ * VVV em hexadecimal: bytes entregues à RX ('R'), mudanças dos sensores de
+ * andar ('S', bit n = andar n ativo), leituras do TMR0 ('C') e do ADC ('A')
+ * que mudaram desde a anterior, e a EEPROM no início ('E', T = endereço).
+ * As saídas também são gravadas para conferência: bytes da TX ('T') e
+ * mudanças de PWM/DIR ('M', duty | DIR << 10).
+ * @note Chamar após Sim_EEPROM() e antes de Sim_Inicializa().
+ * @return false se o arquivo não puder ser criado.
+ */
+bool Sim_Grava(const char* caminho);
+
+/**
+ * @brief Reproduz uma gravação no lugar da planta e da linha RX.
+ * @details As entradas são aplicadas nos instantes gravados; TMR0 e ADC
+ * devolvem o último valor gravado até o instante da leitura. Como o tempo
+ * virtual só depende do caminho do firmware, a reprodução de uma gravação do
+ * simulador é idêntica bit a bit: cada byte da TX e cada mudança do PWM são
+ * conferidos com o instante e o valor gravados. Gravações do alvo
+ * (GRAVACAO_HABILITADA, instantes em ms) são aceitas, sem conferência de saída.
+ * @note Chamar antes de Sim_Inicializa(); substitui Sim_EEPROM().
+ * @return false se o arquivo não puder ser lido ou não tiver registros.
+ */
+bool Sim_Reproduz(const char* caminho);
+
+/**
+ * @brief Resultado da reprodução.
+ */
+typedef struct {
+    uint32_t entradas;          // Registros de entrada aplicáveis
+    uint32_t esperadas;         // Saídas gravadas para conferência
+    uint32_t conferidas;        // Saídas iguais às gravadas até agora
+    uint32_t divergencias;      // Saídas diferentes das gravadas (instante ou valor)
+    uint32_t perdidos;          // Registros perdidos na gravação do alvo ('X')
+    uint64_t fim_us;            // Instante do último registro
+    char primeira[128];         // Descrição da primeira divergência
+} SimReproducao;
+
+/**
+ * @brief Estado da reprodução.
+ * @note Saídas gravadas que não ocorreram = esperadas - conferidas - divergencias.
+ */
+const SimReproducao* Sim_Reproducao(void);
+
+/**
+ * @brief Tempo virtual decorrido desde o reset, em microssegundos.
+ */
+uint64_t Sim_Agora_us(void);
+
+/**
+ * @brief Coloca bytes na linha RX; chegam ao PIC espaçados de #SIM_BYTE_US.
+ */
+void Sim_InjetaRx(const uint8_t* dados, size_t n);
+
+/**
+ * @brief Quantidade de bytes ainda na linha, não entregues ao PIC.
+ */
+size_t Sim_RxPendentes(void);
+
+/**
+ * @brief Gancho chamado a cada byte transmitido pelo firmware.
+ */
+extern void (*Sim_GanchoTx)(uint8_t byte);
+
+/**
+ * @brief Gancho chamado a cada byte entregue ao PIC pela linha RX (fim do stop).
+ */
+extern void (*Sim_GanchoRx)(uint8_t byte);
+
+/**
+ * @brief Gancho chamado a cada carga do duty do PWM3 (DIR já em LATA7).
+ * @note No PIC o novo duty só aparece no pino no início do próximo período do TMR2.
+ */
+extern void (*Sim_GanchoPWM)(uint16_t duty);
+
+/**
+ * @brief Gancho chamado a cada fronteira de quantum (sincronismo externo).
+ */
+extern void (*Sim_GanchoQuantum)(void);
+
+/**
+ * @brief Gancho chamado após cada passo da planta (1 ms), para verificadores.
+ */
+extern void (*Sim_GanchoPlanta)(void);
+
+/**
+ * @brief Estatísticas dos periféricos emulados.
+ */
+typedef struct {
+    uint32_t rx_bytes;          // Bytes entregues ao buffer RX
+    uint32_t rx_estouros;       // Bytes recebidos com o buffer RX cheio
+    uint32_t tx_bytes;          // Bytes transmitidos
+    uint64_t tx_bloqueio_us;    // Tempo total bloqueado em EUSART_Write
+    uint64_t rx_bloqueio_us;    // Tempo total bloqueado em EUSART_Read
+    uint32_t sonos;             // Entradas em SLEEP
+    uint64_t dormindo_us;       // Tempo total em SLEEP
+    uint32_t despertares_rx;    // Despertares pela RX (BAUDCON.WUE)
+    uint32_t rx_perdidos_sono;  // Bytes que chegaram com o PIC dormindo sem WUE
+    uint32_t resposta_n;        // Despertares pela RX respondidos com um quadro "#..."
+    uint64_t resposta_soma_us;  // Soma dos tempos do despertar ao fim (CR) dessa resposta
+    uint32_t resposta_max_us;   // Maior desses tempos
+} SimEstatisticas;
+
+/**
+ * @brief Estatísticas acumuladas desde Sim_Inicializa().
+ */
+const SimEstatisticas* Sim_Estatisticas(void);
+
+/**
+ * @brief Duty cycle de 10 bits carregado no PWM3.
+ */
+uint16_t Sim_DutyPWM(void);
+
+#endif /* SIM_H */
@@ -0,0 +1,302 @@
+/**
+ * @file sim_main.c
+ * @brief Executável "elevsim": uma cabine simulada falando o protocolo UART.
+ * @details A entrada padrão é a linha RX do PIC e a saída padrão é a linha TX.
+ *
+ * Modos de operação:
+ * - Livre (padrão): lê a entrada sem bloquear e roda até o fim de --duracao,
+ *   opcionalmente sincronizado ao relógio com --tempo-real.
+ * - Passo (--passo): sincronismo determinístico com um processo externo.
+ *   A cada quantum de tempo virtual o simulador escreve '\n' na saída e
+ *   espera uma linha na entrada; os bytes dessa linha (sem o '\n') entram na
+ *   RX no início do quantum seguinte. O '\n' (LF) não é usado pelo protocolo
+ *   do elevador, que termina os quadros com CR.
+ * - Reprodução (--reproduz): as entradas vêm de uma gravação (--grava ou
+ *   firmware com GRAVACAO_HABILITADA) e a entrada padrão é ignorada; ao fim,
+ *   as saídas são conferidas com as gravadas e o código de saída é 1 se
+ *   alguma divergir.
+ *
+ * Com --trilha, cada quadro completo da telemetria é gravado também na trilha
+ * binária (trilha.h) com o instante em tempo virtual do CR.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "planta.h"
+#include "trilha.h"
+
+
+// CONFIGURAÇÃO
+
+static struct {
+    int passo;              // Modo de sincronismo por quantum
+    uint32_t quantum_ms;    // Tamanho do quantum
+    double duracao_s;       // Fim da simulação (0 = sem limite)
+    double tempo_real;      // Fator de tempo real no modo livre (0 = máximo)
+    int andar_inicial;      // Andar onde a cabine começa
+    double posicao_mm;      // Posição inicial livre (< 0 = usa andar_inicial)
+    const char* eeprom;     // Arquivo da EEPROM de dados (NULL = apagada, volátil)
+    double perda;           // Fração dos pulsos do encoder perdida
+    const char* grava;      // Arquivo de gravação das entradas (NULL = sem gravação)
+    const char* reproduz;   // Gravação a reproduzir (NULL = planta e entrada padrão)
+    const char* trilha;     // Trilha binária da telemetria (NULL = sem trilha)
+} cfg = { 0, 100, 0.0, 0.0, 0, -1.0, NULL, 0.0, NULL, NULL, NULL };
+
+static struct timespec relogio_inicio;
+
+// Interrupção pedida (SIGINT/SIGTERM): encerra no próximo quantum, fechando a trilha
+static volatile sig_atomic_t interrompido = 0;
+
+
+// GANCHOS
+
+static void Saida_Tx(uint8_t byte) {
+    putchar(byte);
+}
+
+/**
+ * @brief Saída com trilha: monta as linhas da TX e grava os quadros completos.
+ */
+static void Saida_TxTrilha(uint8_t byte) {
+    static char linha[64];
+    static size_t n = 0;
+    TrilhaAmostra a;
+
+    putchar(byte);
+    if (byte == '$') n = 0;
+    if (byte != '\r') {
+        if (n < sizeof(linha) - 1) linha[n++] = (char)byte;
+        return;
+    }
+    linha[n] = '\0';
+    n = 0;
+    if (Trilha_LeQuadro(linha, (int64_t)Sim_Agora_us(), &a)) Trilha_Registra(&a);
+}
+
+static void Interrompe(int sinal) {
+    interrompido = 1;
+}
+
+/**
+ * @brief Resume a conferência da reprodução na saída de erro.
+ * @return Código de saída: 1 se alguma saída divergiu ou faltou.
+ */
+static int Relata_Reproducao(void) {
+    const SimReproducao* r = Sim_Reproducao();
+    uint32_t faltando = r->esperadas - r->conferidas - r->divergencias;
+
+    fprintf(stderr, "sim: reprodução de %u entradas até t=%.3f s\n",
+            r->entradas, (double)r->fim_us * 1e-6);
+    if (r->perdidos) {
+        fprintf(stderr, "sim: %u registros perdidos na gravação, reprodução aproximada\n", r->perdidos);
+    }
+    if (r->esperadas == 0) {
+        fprintf(stderr, "sim: gravação sem saídas para conferir\n");
+        return 0;
+    }
+    if (r->divergencias || faltando) {
+        fprintf(stderr, "sim: DIVERGENTE: %u de %u saídas conferidas, %u diferentes, %u faltando\n",
+                r->conferidas, r->esperadas, r->divergencias, faltando);
+        if (r->divergencias) fprintf(stderr, "sim: primeira divergência: %s\n", r->primeira);
+        return 1;
+    }
+    fprintf(stderr, "sim: idêntica: %u saídas conferidas (TX e PWM)\n", r->conferidas);
+    return 0;
+}
+
+/**
+ * @brief Resume o sono do firmware (SONO_HABILITADO) na saída de erro, ao encerrar.
+ */
+static void Relata_Sono(void) {
+    const SimEstatisticas* e = Sim_Estatisticas();
+    uint64_t total = Sim_Agora_us();
+
+    if (!e->sonos || !total) return;
+    fprintf(stderr, "sim: sono: %u entradas, %.1f%% do tempo dormindo, %u despertares pela RX",
+            e->sonos, 100.0 * (double)e->dormindo_us / (double)total, e->despertares_rx);
+    if (e->resposta_n) {
+        fprintf(stderr, ", despertar -> resposta média %.2f ms, máx %.2f ms",
+                (double)e->resposta_soma_us / e->resposta_n * 1e-3, e->resposta_max_us * 1e-3);
+    }
+    fprintf(stderr, "\n");
+    if (e->rx_perdidos_sono) {
+        fprintf(stderr, "sim: sono: %u bytes chegaram com a RX parada\n", e->rx_perdidos_sono);
+    }
+}
+
+/**
+ * @brief Encerra a simulação ao atingir a duração configurada ou o fim da reprodução.
+ */
+static void Verifica_Fim(void) {
+    if (interrompido) {
+        fflush(stdout);
+        exit(0);
+    }
+    if (cfg.reproduz && Sim_Agora_us() > Sim_Reproducao()->fim_us) {
+        fflush(stdout);
+        exit(Relata_Reproducao());
+    }
+    if (cfg.duracao_s > 0 && Sim_Agora_us() >= (uint64_t)(cfg.duracao_s * 1e6)) {
+        fflush(stdout);
+        exit(0);
+    }
+}
+
+/**
+ * @brief Reprodução: sem entrada externa, apenas a verificação do fim.
+ */
+static void Quantum_Reproducao(void) {
+    Verifica_Fim();
+    fflush(stdout);
+}
+
+/**
+ * @brief Modo passo: entrega o quantum e espera a próxima linha de entrada.
+ */
+static void Quantum_Passo(void) {
+    static uint8_t linha[4096];
+    size_t n = 0;
+    int c;
+
+    Verifica_Fim();
+    putchar('\n');
+    fflush(stdout);
+
+    while ((c = getchar()) != EOF && c != '\n') {
+        if (n < sizeof(linha)) linha[n++] = (uint8_t)c;
+    }
+    if (c == EOF) exit(0);
+    if (n) Sim_InjetaRx(linha, n);
+}
+
+/**
+ * @brief Modo livre: coleta a entrada disponível e acompanha o relógio.
+ */
+static void Quantum_Livre(void) {
+    uint8_t buf[256];
+    ssize_t n;
+
+    Verifica_Fim();
+    fflush(stdout);
+
+    while ((n = read(STDIN_FILENO, buf, sizeof(buf))) > 0) {
+        Sim_InjetaRx(buf, (size_t)n);
+    }
+
+    if (cfg.tempo_real > 0) {
+        struct timespec agora;
+        clock_gettime(CLOCK_MONOTONIC, &agora);
+        double real_s = (double)(agora.tv_sec - relogio_inicio.tv_sec)
+                      + (double)(agora.tv_nsec - relogio_inicio.tv_nsec) * 1e-9;
+        double alvo_s = (double)Sim_Agora_us() * 1e-6 / cfg.tempo_real;
+        if (alvo_s > real_s) usleep((useconds_t)((alvo_s - real_s) * 1e6));
+    }
+}
+
+
+// ENTRADA
+
+static void Uso(const char* prog) {
+    fprintf(stderr,
+        "uso: %s [opções]\n"
+        "  --passo            sincronismo por quantum na entrada/saída padrão\n"
+        "  --quantum MS       tamanho do quantum em ms (padrão 100)\n"
+        "  --duracao S        encerra após S segundos simulados\n"
+        "  --tempo-real F     modo livre: F segundos simulados por segundo real\n"
+        "  --andar N          andar inicial da cabine (0 a 3)\n"
+        "  --posicao MM       posição inicial em mm, ex.: entre andares (ignora --andar)\n"
+        "  --eeprom ARQ       EEPROM de dados persistida em ARQ entre execuções\n"
+        "  --perda F          fração dos pulsos do encoder perdida (ex.: 0.03)\n"
+        "  --grava ARQ        grava as entradas do firmware em ARQ\n"
+        "  --reproduz ARQ     reproduz a gravação ARQ e confere as saídas\n"
+        "  --trilha ARQ       grava a telemetria na trilha binária ARQ (.elt)\n", prog);
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!strcmp(a, "--passo")) cfg.passo = 1;
+        else if (!strcmp(a, "--quantum") && v) { cfg.quantum_ms = (uint32_t)atoi(v); i++; }
+        else if (!strcmp(a, "--duracao") && v) { cfg.duracao_s = atof(v); i++; }
+        else if (!strcmp(a, "--tempo-real") && v) { cfg.tempo_real = atof(v); i++; }
+        else if (!strcmp(a, "--andar") && v) { cfg.andar_inicial = atoi(v); i++; }
+        else if (!strcmp(a, "--posicao") && v) { cfg.posicao_mm = atof(v); i++; }
+        else if (!strcmp(a, "--eeprom") && v) { cfg.eeprom = v; i++; }
+        else if (!strcmp(a, "--perda") && v) { cfg.perda = atof(v); i++; }
+        else if (!strcmp(a, "--grava") && v) { cfg.grava = v; i++; }
+        else if (!strcmp(a, "--reproduz") && v) { cfg.reproduz = v; i++; }
+        else if (!strcmp(a, "--trilha") && v) { cfg.trilha = v; i++; }
+        else { Uso(argv[0]); return 2; }
+    }
+    if (cfg.quantum_ms == 0 || cfg.andar_inicial < 0 || cfg.andar_inicial >= PLANTA_ANDARES
+            || cfg.perda < 0.0 || cfg.perda >= 1.0
+            || (cfg.posicao_mm >= 0.0 && (cfg.posicao_mm < PLANTA_PADRAO.curso_min_mm
+                                          || cfg.posicao_mm > PLANTA_PADRAO.curso_max_mm))
+            || (cfg.reproduz && (cfg.passo || cfg.eeprom || cfg.grava))) {
+        Uso(argv[0]);
+        return 2;
+    }
+
+    if (cfg.eeprom && !Sim_EEPROM(cfg.eeprom)) {
+        fprintf(stderr, "sim: não foi possível abrir %s\n", cfg.eeprom);
+        return 2;
+    }
+
+    if (cfg.grava && !Sim_Grava(cfg.grava)) {
+        fprintf(stderr, "sim: não foi possível criar %s\n", cfg.grava);
+        return 2;
+    }
+    if (cfg.reproduz && !Sim_Reproduz(cfg.reproduz)) {
+        fprintf(stderr, "sim: %s não pôde ser lido ou não tem registros de entrada\n", cfg.reproduz);
+        return 2;
+    }
+
+    if (cfg.trilha) {
+        // Sem SA_RESTART: a leitura bloqueada do modo passo também é interrompida
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = Interrompe;
+        if (!Trilha_Abre(cfg.trilha, TRILHA_ORIGEM_VIRTUAL)) {
+            fprintf(stderr, "sim: não foi possível criar %s\n", cfg.trilha);
+            return 2;
+        }
+        atexit(Trilha_Fecha);
+        sigaction(SIGINT, &sa, NULL);
+        sigaction(SIGTERM, &sa, NULL);
+    }
+
+    if (!cfg.passo) {
+        int fl = fcntl(STDIN_FILENO, F_GETFL);
+        fcntl(STDIN_FILENO, F_SETFL, fl | O_NONBLOCK);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &relogio_inicio);
+    atexit(Relata_Sono);
+
+    Sim_GanchoTx = cfg.trilha ? Saida_TxTrilha : Saida_Tx;
+    Sim_GanchoQuantum = cfg.reproduz ? Quantum_Reproducao : cfg.passo ? Quantum_Passo : Quantum_Livre;
+    Sim_PerdaEncoder(cfg.perda);
+    Sim_Inicializa(cfg.posicao_mm >= 0.0 ? cfg.posicao_mm : PLANTA_PADRAO.altura_andar_mm[cfg.andar_inicial],
+                   cfg.quantum_ms * 1000u);
+
+    // No modo passo o primeiro quantum só começa após a primeira linha
+    if (cfg.passo) {
+        int c;
+        while ((c = getchar()) != EOF && c != '\n') {
+            uint8_t b = (uint8_t)c;
+            Sim_InjetaRx(&b, 1);
+        }
+        if (c == EOF) return 0;
+    }
+
+    firmware_main();
+    return 0;
+}
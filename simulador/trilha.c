@@ -0,0 +1,177 @@
+/**
+ * @file trilha.c
+ * @brief Gravação da trilha binária de telemetria (ver trilha.h).
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trilha.h"
+
+
+// ESTADO
+
+static FILE* arquivo = NULL;
+
+// Bloco em montagem, uma coluna por campo
+static struct {
+    int64_t t_us[TRILHA_BLOCO];
+    uint16_t pos_mm[TRILHA_BLOCO];
+    int16_t vel_dmms[TRILHA_BLOCO];
+    int16_t temp_dc[TRILHA_BLOCO];
+    uint16_t fw_ms[TRILHA_BLOCO];
+    uint8_t andar[TRILHA_BLOCO];
+    uint8_t destino[TRILHA_BLOCO];
+    uint8_t motor[TRILHA_BLOCO];
+    uint8_t seq[TRILHA_BLOCO];
+    uint8_t flags[TRILHA_BLOCO];
+} bloco;
+static uint32_t n_bloco = 0;
+
+// Índice: 32 bytes por bloco gravado
+static uint8_t* indice = NULL;
+static size_t n_indice = 0;
+static size_t cap_indice = 0;
+
+
+// CODIFICAÇÃO LITTLE-ENDIAN
+
+static uint8_t* Poe(uint8_t* p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) *p++ = (uint8_t)(v >> (8 * i));
+    return p;
+}
+
+/**
+ * @brief Grava uma coluna de n valores de 'largura' bytes, completada até múltiplo de 8.
+ */
+static void Grava_Coluna(const void* valores, uint32_t n, int largura) {
+    static uint8_t buf[TRILHA_BLOCO * 8 + 8];
+    const uint8_t* v = valores;
+    uint8_t* p = buf;
+    for (uint32_t i = 0; i < n; i++, v += largura) {
+        uint64_t x;
+        uint16_t x16;
+        if (largura == 8) memcpy(&x, v, 8);
+        else if (largura == 2) { memcpy(&x16, v, 2); x = x16; }
+        else x = *v;
+        p = Poe(p, x, largura);
+    }
+    while ((p - buf) % 8) *p++ = 0;
+    fwrite(buf, 1, (size_t)(p - buf), arquivo);
+}
+
+static uint32_t Alinhado(uint32_t n) {
+    return (n + 7u) & ~7u;
+}
+
+static void Grava_Bloco(void) {
+    uint8_t cab[32], *p = cab;
+    uint32_t n = n_bloco;
+    if (!n) return;
+
+    uint32_t tamanho = Alinhado(n * 8) + 4 * Alinhado(n * 2) + 5 * Alinhado(n);
+    long posicao = ftell(arquivo);
+    memcpy(p, "BLOC", 4); p += 4;
+    p = Poe(p, n, 4);
+    p = Poe(p, (uint64_t)bloco.t_us[0], 8);
+    p = Poe(p, (uint64_t)bloco.t_us[n - 1], 8);
+    p = Poe(p, tamanho, 4);
+    Poe(p, 0, 4);
+    fwrite(cab, 1, sizeof(cab), arquivo);
+
+    Grava_Coluna(bloco.t_us, n, 8);
+    Grava_Coluna(bloco.pos_mm, n, 2);
+    Grava_Coluna(bloco.vel_dmms, n, 2);
+    Grava_Coluna(bloco.temp_dc, n, 2);
+    Grava_Coluna(bloco.fw_ms, n, 2);
+    Grava_Coluna(bloco.andar, n, 1);
+    Grava_Coluna(bloco.destino, n, 1);
+    Grava_Coluna(bloco.motor, n, 1);
+    Grava_Coluna(bloco.seq, n, 1);
+    Grava_Coluna(bloco.flags, n, 1);
+    fflush(arquivo);
+
+    if (n_indice == cap_indice) {
+        cap_indice = cap_indice ? 2 * cap_indice : 64;
+        indice = realloc(indice, cap_indice * 32);
+    }
+    p = indice + 32 * n_indice++;
+    p = Poe(p, (uint64_t)posicao, 8);
+    p = Poe(p, n, 4);
+    p = Poe(p, 0, 4);
+    p = Poe(p, (uint64_t)bloco.t_us[0], 8);
+    Poe(p, (uint64_t)bloco.t_us[n - 1], 8);
+    n_bloco = 0;
+}
+
+
+// API
+
+bool Trilha_Abre(const char* caminho, uint8_t origem) {
+    uint8_t cab[16] = { 'E', 'L', 'T', 'R', 1, 0, 0 };
+    arquivo = fopen(caminho, "wb");
+    if (!arquivo) return false;
+    cab[6] = origem;
+    fwrite(cab, 1, sizeof(cab), arquivo);
+    return true;
+}
+
+void Trilha_Registra(const TrilhaAmostra* a) {
+    if (!arquivo) return;
+    bloco.t_us[n_bloco] = a->t_us;
+    bloco.pos_mm[n_bloco] = a->pos_mm;
+    bloco.vel_dmms[n_bloco] = a->vel_dmms;
+    bloco.temp_dc[n_bloco] = a->temp_dc;
+    bloco.fw_ms[n_bloco] = a->fw_ms;
+    bloco.andar[n_bloco] = a->andar;
+    bloco.destino[n_bloco] = a->destino;
+    bloco.motor[n_bloco] = a->motor;
+    bloco.seq[n_bloco] = a->seq;
+    bloco.flags[n_bloco] = a->flags;
+    if (++n_bloco == TRILHA_BLOCO) Grava_Bloco();
+}
+
+void Trilha_Fecha(void) {
+    uint8_t rodape[16], *p = rodape;
+    if (!arquivo) return;
+    Grava_Bloco();
+    long posicao = ftell(arquivo);
+    if (n_indice) fwrite(indice, 32, n_indice, arquivo);
+    p = Poe(p, (uint64_t)posicao, 8);
+    p = Poe(p, n_indice, 4);
+    memcpy(p, "FIMT", 4);
+    fwrite(rodape, 1, sizeof(rodape), arquivo);
+    fclose(arquivo);
+    arquivo = NULL;
+    free(indice);
+    indice = NULL;
+    n_indice = cap_indice = 0;
+}
+
+bool Trilha_LeQuadro(const char* quadro, int64_t t_us, TrilhaAmostra* a) {
+    unsigned andar, destino, motor, pos, seq, ms;
+    double vel, temp;
+    int fim = 0;
+
+    // Quadro com carimbo ",NN,MMMM" ou no formato antigo, de 6 campos
+    memset(a, 0, sizeof(*a));
+    if (sscanf(quadro, "$%u,%u,%u,%u,%lf,%lf,%2x,%4x%n",
+               &andar, &destino, &motor, &pos, &vel, &temp, &seq, &ms, &fim) == 8 && !quadro[fim]) {
+        a->seq = (uint8_t)seq;
+        a->fw_ms = (uint16_t)ms;
+        a->flags = TRILHA_CARIMBO;
+    } else if (sscanf(quadro, "$%u,%u,%u,%u,%lf,%lf%n",
+                      &andar, &destino, &motor, &pos, &vel, &temp, &fim) != 6 || quadro[fim]) {
+        return false;
+    }
+    a->t_us = t_us;
+    a->andar = (uint8_t)andar;
+    a->destino = (uint8_t)destino;
+    a->motor = (uint8_t)motor;
+    a->pos_mm = (uint16_t)pos;
+    a->vel_dmms = (int16_t)lround(vel * 10.0);
+    a->temp_dc = (int16_t)lround(temp * 10.0);
+    return true;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file trilha.h
+ * @brief Trilha binária de telemetria (.elt), o mesmo formato gravado pelo app.
+ * @details Formato colunar, só de acréscimo, little-endian e de largura fixa
+ * (descrição completa em elevator1x4/app/trilha.py, que também lê e converte
+ * para CSV):
+ * - Cabeçalho de 16 bytes: "ELTR", versão 1 e origem do tempo.
+ * - Blocos de até #TRILHA_BLOCO amostras: cabeçalho de 32 bytes com a
+ *   quantidade e o primeiro e o último instante, seguido de uma coluna por
+ *   campo de #TrilhaAmostra (na ordem da estrutura, cada uma completada até
+ *   múltiplo de 8 bytes).
+ * - Índice dos blocos e rodapé, gravados ao fechar.
+ */
+
+#ifndef TRILHA_H
+#define TRILHA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Amostras por bloco.
+ */
+#define TRILHA_BLOCO            4096
+
+/**
+ * @brief Origem dos instantes: µs desde 1970 (app) ou de tempo virtual (simulador).
+ */
+#define TRILHA_ORIGEM_UNIX      0
+#define TRILHA_ORIGEM_VIRTUAL   1
+
+/**
+ * @brief Bit de flags: quadro com carimbo (seq e fw_ms válidos).
+ */
+#define TRILHA_CARIMBO          0x01
+
+/**
+ * @brief Uma amostra do quadro completo "$A,D,M,PPP,VV.V,TT.T,NN,MMMM".
+ */
+typedef struct {
+    int64_t t_us;           // Instante (µs)
+    uint16_t pos_mm;
+    int16_t vel_dmms;       // Velocidade em 0,1 mm/s
+    int16_t temp_dc;        // Temperatura em 0,1 °C
+    uint16_t fw_ms;         // Relógio do firmware (ms, 16 bits)
+    uint8_t andar;          // A
+    uint8_t destino;        // D
+    uint8_t motor;          // M
+    uint8_t seq;            // Sequência do quadro
+    uint8_t flags;          // TRILHA_CARIMBO
+} TrilhaAmostra;
+
+/**
+ * @brief Cria a trilha e grava o cabeçalho.
+ * @return false se o arquivo não puder ser criado.
+ */
+bool Trilha_Abre(const char* caminho, uint8_t origem);
+
+/**
+ * @brief Acrescenta uma amostra; grava o bloco ao completar #TRILHA_BLOCO.
+ */
+void Trilha_Registra(const TrilhaAmostra* a);
+
+/**
+ * @brief Grava o bloco incompleto, o índice e o rodapé e fecha o arquivo.
+ * @note Sem esta chamada a trilha continua legível até o último bloco completo.
+ */
+void Trilha_Fecha(void);
+
+/**
+ * @brief Converte um quadro completo de telemetria (sem o CR) em amostra.
+ * @return false se o texto não for um quadro completo.
+ */
+bool Trilha_LeQuadro(const char* quadro, int64_t t_us, TrilhaAmostra* a);
+
+#endif /* TRILHA_H */